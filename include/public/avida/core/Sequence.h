@@ -124,6 +124,7 @@ namespace Avida {
   protected:
     virtual void adjustCapacity(int new_size);
     virtual void prepareInsert(int pos, int num_sites);
+    void rotateSites(int n);
   };
 
 
@@ -98,7 +98,7 @@ public:
       cAnalyzeGenotype* genotype = NULL;
       tListIterator<cAnalyzeGenotype> batch_it(m_world->GetAnalyze().GetCurrentBatch().List());
       while ((genotype = batch_it.Next())) {
-        LoadGenome(batches, genotype->GetGenome());
+        LoadGenome(ctx, batches, genotype->GetGenome());
         depths.Push(genotype->GetDepth());
       }
     } else {
@@ -139,7 +139,7 @@ public:
   }
   
 private:
-  void LoadGenome(tArray<tList<cLandscape> >& batches, const Genome& genome)
+  void LoadGenome(cAvidaContext& ctx, tArray<tList<cLandscape> >& batches, const Genome& genome)
   {
     cAnalyzeJobQueue& jobqueue = m_world->GetAnalyze().GetJobQueue();
 
@@ -149,7 +149,7 @@ private:
       land->SetTrials(m_trials);
       batches[dist - 1].PushRear(land);
       if (dist == 1) {
-        jobqueue.AddJob(new tAnalyzeJob<cLandscape>(land, &cLandscape::Process));        
+        land->ProcessParallel(ctx, jobqueue);
       } else {
         land->SetMinFound(m_min_found);
         land->SetMaxTrials(m_max_trials);
@@ -260,7 +260,7 @@ public:
         land = new cLandscape(m_world, genotype->GetGenome());
         land->SetDistance(m_dist);
         m_batch.PushRear(land);
-        jobqueue.AddJob(new tAnalyzeJob<cLandscape>(land, &cLandscape::Process));
+        land->ProcessParallel(ctx, jobqueue);
       }
       jobqueue.Execute();
     } else {
@@ -2063,7 +2063,10 @@ public:
       case P_MUT: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentMutProb(m_prob); break;
       case P_INS: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentInsProb(m_prob); break;
       case P_DEL: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentDelProb(m_prob); break;
-      case DEATH: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetDeathProb(m_prob); break;
+      case DEATH:
+        for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetDeathProb(m_prob);
+        m_world->GetPopulation().DeathProbsChanged();
+        break;
       case PNT_MUT: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointMutProb(m_prob); break;
       case PNT_INS: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointInsProb(m_prob); break;
       case PNT_DEL: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointDelProb(m_prob); break;
@@ -2250,7 +2253,10 @@ public:
       case P_MUT: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentMutProb(prob); break;
       case P_INS: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentInsProb(prob); break;
       case P_DEL: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetParentDelProb(prob); break;
-      case DEATH: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetDeathProb(prob); break;
+      case DEATH:
+        for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetDeathProb(prob);
+        m_world->GetPopulation().DeathProbsChanged();
+        break;
       case PNT_MUT: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointMutProb(prob); break;
       case PNT_INS: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointInsProb(prob); break;
       case PNT_DEL: for (int i = m_start; i < m_end; i++) m_world->GetPopulation().GetCell(i).MutationRates().SetPointDelProb(prob); break;
@@ -2274,6 +2280,7 @@ public:
     for (int i = 0; i < m_world->GetPopulation().GetSize(); i++) {
       m_world->GetPopulation().GetCell(i).MutationRates().Clear();
     }
+    m_world->GetPopulation().DeathProbsChanged();
 		bool Set(const cString& entry, const cString& val);
 		const cString cpy = "GERMLINE_COPY_MUT";
 		const cString ins = "GERMLINE_INS_MUT";
@@ -47,6 +47,7 @@
 #include "cPopulation.h"
 #include "cPopulationCell.h"
 #include "cStats.h"
+#include "cTestCPUCache.h"
 #include "cWorld.h"
 #include "tAutoRelease.h"
 #include "tIterator.h"
@@ -4518,6 +4519,43 @@ public:
   }
 };
 
+class cActionPrintTestCPUCacheData : public cAction
+{
+private:
+  cString m_filename;
+  
+public:
+  cActionPrintTestCPUCacheData(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  {
+    cString largs(args);
+    largs.Trim();
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    else m_filename = "test_cpu_cache.dat";
+  }
+  
+  static const cString GetDescription() { return "Arguments: [string fname=\"test_cpu_cache.dat\"]"; }
+  
+  void Process(cAvidaContext& ctx)
+  {
+    cTestCPUCache& cache = m_world->GetHardwareManager().GetTestCPUCache();
+    
+    cDataFile& df = m_world->GetDataFile(m_filename);
+    df.WriteComment("Avida test CPU result cache statistics (cumulative)");
+    df.WriteTimeStamp();
+    df.Write(m_world->GetStats().GetUpdate(), "Update");
+    df.Write(cache.GetNumHits(), "Hits");
+    df.Write(cache.GetNumMisses(), "Misses");
+    df.Write(cache.GetNumBypassed(), "Uncacheable Tests");
+    df.Write(cache.GetNumEvictions(), "Evictions");
+    df.Write(cache.GetSize(), "Cached Results");
+    df.Write(cache.GetCapacity(), "Capacity");
+    df.Write(m_world->GetStats().GetDivideTestsRun(), "Birth Tests Run");
+    df.Write(m_world->GetStats().GetDivideTestsAvoided(), "Birth Tests Served From Cache");
+    df.Endl();
+  }
+};
+
+
 class cActionPrintDebug : public cAction
 {
 public:
@@ -4765,6 +4803,7 @@ public:
 
 void RegisterPrintActions(cActionLibrary* action_lib)
 {
+  action_lib->Register<cActionPrintTestCPUCacheData>("PrintTestCPUCacheData");
   action_lib->Register<cActionPrintDebug>("PrintDebug");
   
   
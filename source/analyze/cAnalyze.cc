@@ -22,6 +22,7 @@
 
 #include "cAnalyze.h"
 
+#include "apto/platform.h"
 #include "avida/Avida.h"
 
 #include "avida/core/WorldDriver.h"
@@ -35,12 +36,15 @@
 #include "cAnalyzeFlowCommandDef.h"
 #include "cAnalyzeFunction.h"
 #include "cAnalyzeGenotype.h"
+#include "cAnalyzeLockedJobQueue.h"
+#include "cAnalyzeStatColumn.h"
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 #include "cAnalyzeTreeStats_Gamma.h"
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cDataFile.h"
 #include "cEnvironment.h"
+#include "cGenotypeLoader.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHardwareStatusPrinter.h"
@@ -49,8 +53,10 @@
 #include "cInstSet.h"
 #include "cLandscape.h"
 #include "cModularityAnalysis.h"
+#include "cMutantTestBatch.h"
 #include "cPhenotype.h"
 #include "cPhenPlastGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cPlasticPhenotype.h"
 #include "cProbSchedule.h"
 #include "cReaction.h"
@@ -58,8 +64,10 @@
 #include "cResource.h"
 #include "cResourceHistory.h"
 #include "cSchedule.h"
+#include "cSequenceAligner.h"
 #include "cStringIterator.h"
 #include "cTestCPU.h"
+#include "cTestCPUCache.h"
 #include "cUserFeedback.h"
 #include "cWorld.h"
 #include "tAnalyzeJob.h"
@@ -78,8 +86,12 @@
 #include <stack>
 
 #include <cerrno>
+#include <ctime>
 extern "C" {
 #include <sys/stat.h>
+#if !APTO_PLATFORM(WINDOWS)
+#include <sys/time.h>
+#endif
 }
 
 using namespace std;
@@ -238,6 +250,9 @@ void cAnalyze::LoadSequence(cString cur_string)
 // from a file specified by the user, or resource.dat by default.
 void cAnalyze::LoadResources(cString cur_string)
 {
+  // Cached test results are keyed on the resource history they were run against
+  m_world->GetHardwareManager().GetTestCPUCache().Clear();
+  
   delete m_resources;
   m_resources = new cResourceHistory;
   
@@ -715,27 +730,54 @@ double cAnalyze::IncreasedInfo(cAnalyzeGenotype * genotype1,
 
 void cAnalyze::LoadFile(cString cur_string)
 {
-  // LOAD
+  // LOAD filename [column ...]
   
   cString filename = cur_string.PopWord();
   
+  // Optionally restrict the load to the named data entries
+  cStringList columns;
+  while (cur_string.GetSize()) columns.PushRear(cur_string.PopWord());
+  
   cout << "Loading: " << filename << endl;
   
-  cInitFile input_file(filename, m_world->GetWorkingDir());
-  if (!input_file.WasOpened()) {
-    const cUserFeedback& feedback = input_file.GetFeedback();
-    for (int i = 0; i < feedback.GetNumMessages(); i++) {
-      switch (feedback.GetMessageType(i)) {
-        case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
-        case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
-        default: break;
-      };
-      cerr << feedback.GetMessage(i) << endl;
+  cGenotypeLoader loader(m_world, m_jobqueue);
+  tList<cAnalyzeGenotype> loaded;
+  
+  // Stream the file when possible, reading it whole through cInitFile when it needs include processing
+  bool streamed = false;
+  if (loader.ReadHeader(filename, m_world->GetWorkingDir())) {
+    if (LoadFile_Columns(loader, loader.GetFiletype(), loader.GetFormat(), columns) == false) return;
+    streamed = loader.LoadStream(loaded);
+  }
+  
+  if (!streamed) {
+    cInitFile input_file(filename, m_world->GetWorkingDir());
+    if (!input_file.WasOpened()) {
+      const cUserFeedback& feedback = input_file.GetFeedback();
+      for (int i = 0; i < feedback.GetNumMessages(); i++) {
+        switch (feedback.GetMessageType(i)) {
+          case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+          case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+          default: break;
+        };
+        cerr << feedback.GetMessage(i) << endl;
+      }
+      if (exit_on_error) exit(1);
     }
-    if (exit_on_error) exit(1);
+    
+    if (LoadFile_Columns(loader, input_file.GetFiletype(), input_file.GetFormat(), columns) == false) return;
+    loader.LoadLines(input_file, loaded);
   }
   
-  const cString filetype = input_file.GetFiletype();
+  // Add the genotypes to the proper batch and adjust the flags on this batch
+  batch[cur_batch].List().Transfer(loaded);
+  batch[cur_batch].SetLineage(false);
+  batch[cur_batch].SetAligned(false);
+}
+
+bool cAnalyze::LoadFile_Columns(cGenotypeLoader& loader, const cString& filetype, const cStringList& format,
+                              const cStringList& columns)
+{
   if (filetype != "population_data" &&  // Deprecated
       filetype != "genotype_data") {
     cerr << "error: cannot load files of type \"" << filetype << "\"." << endl;
@@ -746,12 +788,9 @@ void cAnalyze::LoadFile(cString cur_string)
     cout << "Loading file of type: " << filetype << endl;
   }
   
-  
-  // Construct a linked list of data types that can be loaded...
-  tList< tDataEntryCommand<cAnalyzeGenotype> > output_list;
-  tListIterator< tDataEntryCommand<cAnalyzeGenotype> > output_it(output_list);
+  // Construct the data commands for the columns to be loaded...
   cUserFeedback feedback;
-  cAnalyzeGenotype::GetDataCommandManager().LoadCommandList(input_file.GetFormat(), output_list, &feedback);
+  bool success = loader.SetupColumns(format, columns, feedback);
   
   for (int i = 0; i < feedback.GetNumMessages(); i++) {
     switch (feedback.GetMessageType(i)) {
@@ -762,43 +801,7 @@ void cAnalyze::LoadFile(cString cur_string)
     cerr << feedback.GetMessage(i) << endl;
   }  
   
-  if (feedback.GetNumErrors()) return;
-  
-  bool id_inc = input_file.GetFormat().HasString("id");
-  
-  // Setup the genome...
-  const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
-  Genome default_genome(is.GetHardwareType(), is.GetInstSetName(), Sequence(1));
-  int load_count = 0;
-  
-  for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
-    cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, default_genome);
-    
-    output_it.Reset();
-    tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
-    while ((data_command = output_it.Next()) != NULL) {
-      data_command->SetValue(genotype, cur_line.PopWord());
-    }
-    
-    // Give this genotype a name.  Base it on the ID if possible.
-    if (id_inc == false) {
-      cString name = cStringUtil::Stringf("org-%d", load_count++);
-      genotype->SetName(name);
-    }
-    else {
-      cString name = cStringUtil::Stringf("org-%d", genotype->GetID());
-      genotype->SetName(name);
-    }
-    
-    // Add this genotype to the proper batch.
-    batch[cur_batch].List().PushRear(genotype);
-  }
-  
-  // Adjust the flags on this batch
-  batch[cur_batch].SetLineage(false);
-  batch[cur_batch].SetAligned(false);
+  return success;
 }
 
 
@@ -860,16 +863,35 @@ void cAnalyze::CommandFilter(cString cur_string)
   }
   
   
-  // Loop through the genotypes and remove the entries that don't match.
-  tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-  cAnalyzeGenotype * cur_genotype = NULL;
-  while ((cur_genotype = batch_it.Next()) != NULL) {
-    const cFlexVar value = stat_command->GetValue(cur_genotype);
-    int compare = 1 + CompareFlexStat(value, test_value);
+  // Compute the stat across the batch up front if it needs test CPU runs
+  tList< tDataEntryCommand<cAnalyzeGenotype> > stat_list;
+  tListIterator< tDataEntryCommand<cAnalyzeGenotype> > stat_it(stat_list);
+  stat_list.Push(stat_command);
+  CommandDetail_Prefetch(stat_it, batch[cur_batch].List());
+  
+  // Numeric stats are compared as packed doubles, parsing the test value once rather than for every genotype
+  cAnalyzeStatColumn column(batch[cur_batch].List(), *stat_command);
+  if (column.IsNumeric()) {
+    tArray<bool> keep;
+    column.Filter(test_value.AsDouble(), rel_ok, keep);
     
-    // Check if we should eliminate this genotype...
-    if (rel_ok[compare] == false) {
-      delete batch_it.Remove();
+    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+    for (int row = 0; batch_it.Next() != NULL; row++) {
+      if (keep[row] == false) delete batch_it.Remove();
+    }
+  } else {
+    // Loop through the genotypes and remove the entries that don't match.
+    const cFlexVar test_flex(test_value);
+    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+    cAnalyzeGenotype * cur_genotype = NULL;
+    while ((cur_genotype = batch_it.Next()) != NULL) {
+      const cFlexVar value = stat_command->GetValue(cur_genotype);
+      int compare = 1 + CompareFlexStat(value, test_flex);
+      
+      // Check if we should eliminate this genotype...
+      if (rel_ok[compare] == false) {
+        delete batch_it.Remove();
+      }
     }
   }
   delete stat_command;
@@ -1019,29 +1041,27 @@ void cAnalyze::FindLineage(cString cur_string)
   
   tListPlus<cAnalyzeGenotype> found_list;
   found_list.Push(found_gen);
-  int next_id = found_gen->GetParentID();
-  bool found = true;
-  while (found == true) {
-    found = false;
-    
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      if (found_gen->GetID() == next_id) {
-        batch_it.Remove();
-        found_list.Push(found_gen);
-        next_id = found_gen->GetParentID();
-        found = true;
-        break;
-      }
-    }
+  
+  // Index the batch by ID so that each step back is a lookup rather than a scan.
+  cPhylogenyIndex phylogeny(batch[cur_batch].List());
+  tArray<bool> in_lineage(phylogeny.GetSize());
+  in_lineage.SetAll(false);
+  
+  int next_pos = phylogeny.FindID(found_gen->GetParentID());
+  while (next_pos >= 0 && !in_lineage[next_pos]) {
+    in_lineage[next_pos] = true;
+    found_gen = phylogeny.GetGenotype(next_pos);
+    found_list.Push(found_gen);
+    next_pos = phylogeny.FindID(found_gen->GetParentID());
   }
   
   // We now have all of the genotypes in this lineage, delete everything
   // else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  const int total_removed = phylogeny.GetSize() - (found_list.GetSize() - 1);
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    batch[cur_batch].List().Pop();
+    if (!in_lineage[pos]) delete phylogeny.GetGenotype(pos);
   }
   
   // And fill it back in with the good stuff.
@@ -1238,7 +1258,11 @@ void cAnalyze::FindClade(cString cur_string)
     return;
   }
   
-  // Do this the brute force way... scan for one step at a time.
+  // Index the batch by parent ID so that the children of each genotype can be
+  // found without rescanning the batch.
+  cPhylogenyIndex phylogeny(batch[cur_batch].List());
+  tArray<bool> in_clade(phylogeny.GetSize());
+  in_clade.SetAll(false);
   
   // Construct a list of genotypes found...
   
@@ -1253,22 +1277,20 @@ void cAnalyze::FindClade(cString cur_string)
     int parent_id = found_gen->GetID();
     found_list.Push(found_gen);
     
-    // Seach for all of the children of this genotype...
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      // If we found a child, place it into the scan list.
-      if (found_gen->GetParentID() == parent_id) {
-        batch_it.Remove();
-        scan_list.Push(found_gen);
-      }
+    // Place all of the children of this genotype into the scan list.
+    for (int pos = phylogeny.FindFirstChild(parent_id); pos >= 0; pos = phylogeny.GetNextSibling(pos)) {
+      if (in_clade[pos]) continue;
+      in_clade[pos] = true;
+      scan_list.Push(phylogeny.GetGenotype(pos));
     }
   }
   
   // We now have all of the genotypes in this clade, delete everything else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  const int total_removed = phylogeny.GetSize() - (found_list.GetSize() - 1);
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    batch[cur_batch].List().Pop();
+    if (!in_clade[pos]) delete phylogeny.GetGenotype(pos);
   }
   
   // And fill it back in with the good stuff.
@@ -1302,17 +1324,11 @@ void cAnalyze::FindLastCommonAncestor(cString cur_string)
   }
   
   // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> child_it(batch[cur_batch].List());
-  cAnalyzeGenotype * on_child = NULL;
-  while ((on_child = child_it.Next()) != NULL) {
-    tListIterator<cAnalyzeGenotype> parent_it(batch[cur_batch].List());
-    cAnalyzeGenotype * on_parent = NULL;
-    while ((on_parent = parent_it.Next()) != NULL) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
+  cPhylogenyIndex phylogeny(batch[cur_batch].List());
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    cAnalyzeGenotype * on_child = phylogeny.GetGenotype(pos);
+    const int parent_pos = phylogeny.FindID(on_child->GetParentID());
+    if (parent_pos >= 0) on_child->LinkParent(phylogeny.GetGenotype(parent_pos));
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -1343,10 +1359,11 @@ void cAnalyze::FindLastCommonAncestor(cString cur_string)
   // Follow the children from this parent until we find a genotype with 
   // more than one child. This is the last common ancestor.
   while (lca->GetChildList().GetSize() == 1) {
-    lca = lca->GetChildList().Pop();
+    lca = lca->GetChildList().GetFirst();
   }
-  
-  // Delete everything else.
+
+  // Delete everything else, detaching the last common ancestor first so that it is not left linked to deleted genotypes.
+  lca->UnlinkParent();
   tListIterator<cAnalyzeGenotype> delete_batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * delete_genotype = NULL;
   while ((delete_genotype = delete_batch_it.Next()) != NULL) {
@@ -1492,9 +1509,41 @@ void cAnalyze::SampleGenotypes(cString cur_string)
   batch[cur_batch].SetAligned(false);
 }
 
+// Arguments: [int num_kept] [string stat]
 void cAnalyze::KeepTopGenotypes(cString cur_string)
 {
   const int num_kept = cur_string.PopWord().AsInt();
+  
+  // With a stat, order the batch by it (highest first, ties in batch order) before trimming
+  if (cur_string.GetSize()) {
+    const cString stat_name = cur_string.PopWord();
+    tDataEntryCommand<cAnalyzeGenotype>* stat_command = cAnalyzeGenotype::GetDataCommandManager().GetDataCommand(stat_name);
+    if (stat_command == NULL) {
+      cerr << "Error: Unknown stat '" << stat_name << "'" << endl;
+      if (exit_on_error) exit(1);
+      return;
+    }
+    
+    tList< tDataEntryCommand<cAnalyzeGenotype> > stat_list;
+    tListIterator< tDataEntryCommand<cAnalyzeGenotype> > stat_it(stat_list);
+    stat_list.Push(stat_command);
+    CommandDetail_Prefetch(stat_it, batch[cur_batch].List());
+    
+    cAnalyzeStatColumn column(batch[cur_batch].List(), *stat_command);
+    delete stat_command;
+    if (!column.IsNumeric() && column.GetSize() > 0) {
+      cerr << "Error: KEEP_TOP can only sort by a numeric stat, not '" << stat_name << "'" << endl;
+      if (exit_on_error) exit(1);
+      return;
+    }
+    
+    tArray<int> order;
+    column.GetSortOrder(order, true);
+    batch[cur_batch].List().Clear();
+    for (int i = 0; i < order.GetSize(); i++) batch[cur_batch].List().PushRear(column.GetGenotype(order[i]));
+    batch[cur_batch].SetLineage(false);
+  }
+  
   const int num_genotypes = batch[cur_batch].List().GetSize();
   const int num_removed = num_genotypes - num_kept;
   
@@ -1791,6 +1840,46 @@ void cAnalyze::CommandPrintTasksQuality(cString cur_string)
   }
 }
 
+class cDetailPrefetchJob
+{
+private:
+  const cAnalyzeGenotype* m_genotype;
+  int m_flags;
+  
+public:
+  cDetailPrefetchJob(const cAnalyzeGenotype* genotype, int flags) : m_genotype(genotype), m_flags(flags) { ; }
+  
+  void Run(cAvidaContext& ctx) { m_genotype->Prefetch(ctx, m_flags); }
+};
+
+// Evaluate the expensive columns of a detail over all of the genotypes up front, across the analyze job queue, so that
+// the rows can then be printed in order without stalling on each genotype in turn.
+void cAnalyze::CommandDetail_Prefetch(tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it,
+                                      tList<cAnalyzeGenotype>& genotypes)
+{
+  int flags = 0;
+  output_it.Reset();
+  tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
+  while ((data_command = output_it.Next()) != NULL) {
+    flags |= cAnalyzeGenotype::GetPrefetchFlags(data_command->GetName());
+  }
+  if (flags == 0) return;
+  
+  tList<cDetailPrefetchJob> job_list;
+  tAnalyzeJobBatch<cDetailPrefetchJob> jobbatch(m_jobqueue);
+  tListIterator<cAnalyzeGenotype> genotype_it(genotypes);
+  cAnalyzeGenotype* genotype = NULL;
+  while ((genotype = genotype_it.Next()) != NULL) {
+    cDetailPrefetchJob* job = new cDetailPrefetchJob(genotype, flags);
+    job_list.Push(job);
+    jobbatch.AddJob(job, &cDetailPrefetchJob::Run);
+  }
+  jobbatch.RunBatch();
+  
+  while (job_list.GetSize()) delete job_list.Pop();
+}
+
+
 void cAnalyze::CommandDetail(cString cur_string)
 {
   if (m_world->GetVerbosity() >= VERBOSE_ON) cout << "Detailing batch " << cur_batch << endl;
@@ -1930,6 +2019,28 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
                                   tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it,
                                   int time_step, int max_time)
 {
+  // Prefetch expensive columns for the genotypes that will be printed
+  if (time_step > 0) {
+    tList<cAnalyzeGenotype> timeline;
+    tListIterator<cAnalyzeGenotype> timeline_it(batch[cur_batch].List());
+    cAnalyzeGenotype* genotype = timeline_it.Next();
+    cAnalyzeGenotype* next = timeline_it.Next();
+    cAnalyzeGenotype* last = NULL;
+    int t = 0;
+    while (genotype != NULL && t <= max_time) {
+      if (genotype != last) timeline.PushRear(genotype);
+      last = genotype;
+      t += time_step;
+      while (next && next->GetUpdateBorn() < t) {
+        genotype = next;
+        next = timeline_it.Next();
+      }
+    }
+    CommandDetail_Prefetch(output_it, timeline);
+  } else {
+    CommandDetail_Prefetch(output_it, batch[cur_batch].List());
+  }
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * cur_genotype = batch_it.Next();
@@ -1998,6 +2109,8 @@ void cAnalyze::CommandDetail_Body(ostream& fp, int format_type,
 void cAnalyze::CommandDetailAverage_Body(ostream& fp, int nucoutputs,
                                          tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it)
 {
+  CommandDetail_Prefetch(output_it, batch[cur_batch].List());
+  
   // Loop through all of the genotypes in this batch...
   tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
   cAnalyzeGenotype * cur_genotype = batch_it.Next();
@@ -2346,6 +2459,8 @@ void cAnalyze::CommandHistogram_Header(ostream& fp, int format_type,
 void cAnalyze::CommandHistogram_Body(ostream& fp, int format_type,
                                      tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it)
 {
+  CommandDetail_Prefetch(output_it, batch[cur_batch].List());
+  
   output_it.Reset();
   tDataEntryCommand<cAnalyzeGenotype> * data_command = NULL;
   cAnalyzeGenotype* first_genotype = batch[cur_batch].List().GetFirst();
@@ -2361,15 +2476,34 @@ void cAnalyze::CommandHistogram_Body(ostream& fp, int format_type,
     
     tDictionary<int> count_dict;
     
-    // Loop through all genotypes in this batch to collect the info we need.
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    cAnalyzeGenotype * cur_genotype;
-    while ((cur_genotype = batch_it.Next()) != NULL) {
-      const cString cur_name(data_command->GetValue(cur_genotype).AsString());
-      int count = 0;
-      count_dict.Find(cur_name, count);
-      count += cur_genotype->GetNumCPUs();
-      count_dict.Set(cur_name, count);
+    // Numeric stats are grouped as packed doubles, so each distinct value is formatted once.  Values are added to the
+    // dictionary in the order they first appear in the batch, as the per-genotype loop below would add them.
+    cAnalyzeStatColumn column(batch[cur_batch].List(), *data_command);
+    if (column.IsNumeric()) {
+      tArray<int> num_cpus(column.GetSize());
+      for (int row = 0; row < column.GetSize(); row++) num_cpus[row] = column.GetGenotype(row)->GetNumCPUs();
+      
+      tArray<int> first_rows;
+      tArray<int> totals;
+      column.CountDistinct(num_cpus, first_rows, totals);
+      for (int i = 0; i < first_rows.GetSize(); i++) {
+        const cString cur_name(column.GetValueString(first_rows[i]));
+        int count = 0;
+        count_dict.Find(cur_name, count);
+        count += totals[i];
+        count_dict.Set(cur_name, count);
+      }
+    } else {
+      // Loop through all genotypes in this batch to collect the info we need.
+      tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
+      cAnalyzeGenotype * cur_genotype;
+      while ((cur_genotype = batch_it.Next()) != NULL) {
+        const cString cur_name(data_command->GetValue(cur_genotype).AsString());
+        int count = 0;
+        count_dict.Find(cur_name, count);
+        count += cur_genotype->GetNumCPUs();
+        count_dict.Set(cur_name, count);
+      }
     }
     
     tList<cString> name_list;
@@ -4346,12 +4480,14 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     
     const int max_line = genotype->GetLength();
     const Genome& base_genome = genotype->GetGenome();
-    const Sequence& base_seq = base_genome.GetSequence();
-    Genome mod_genome(base_genome);
-    Sequence& seq = mod_genome.GetSequence();
     cInstruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.GetInstSet()).ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code, replacing it with "NULL"
+    cMutantTestBatch ko_tests(m_world, m_jobqueue, base_genome);
+    for (int line_num = 0; line_num < max_line; line_num++) ko_tests.AddMutant(line_num, null_inst.GetOp());
+    ko_tests.Run();
+    
+    // Loop through all the lines of code, classifying the removal of each.
     // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
     int dead_count = 0;
     int neg_count = 0;
@@ -4359,13 +4495,7 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     int pos_count = 0;
     tArray<int> ko_effect(max_line);
     for (int line_num = 0; line_num < max_line; line_num++) {
-      // Save a copy of the current instruction and replace it with "NULL"
-      int cur_inst = base_seq[line_num].GetOp();
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-      ko_genotype.Recalculate(m_ctx);
-      
-      double ko_fitness = ko_genotype.GetFitness();
+      double ko_fitness = ko_tests.GetFitness(line_num);
       if (ko_fitness == 0.0) {
         dead_count++;
         ko_effect[line_num] = -2;
@@ -4381,23 +4511,24 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
       } else {
         cerr << "ERROR: illegal state in AnalyzeKnockouts()" << endl;
       }
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     }
     
     tArray<int> ko_pair_effect(ko_effect);
     if (max_knockouts > 1) {
+      ko_tests.Clear();
+      for (int line1 = 0; line1 < max_line; line1++) {
+        for (int line2 = line1+1; line2 < max_line; line2++) {
+          ko_tests.AddMutant(line1, null_inst.GetOp(), line2, null_inst.GetOp());
+        }
+      }
+      ko_tests.Run();
+      
+      // Each line can only be reclassified one way, determined by its own knockout effect, so the pairs may be
+      // folded in any order.
+      int pair_id = 0;
       for (int line1 = 0; line1 < max_line; line1++) {
       	for (int line2 = line1+1; line2 < max_line; line2++) {
-          int cur_inst1 = base_seq[line1].GetOp();
-          int cur_inst2 = base_seq[line2].GetOp();
-          seq[line1] = null_inst;
-          seq[line2] = null_inst;
-          cAnalyzeGenotype ko_genotype(m_world, mod_genome);
-          ko_genotype.Recalculate(m_ctx);
-          
-          double ko_fitness = ko_genotype.GetFitness();
+          double ko_fitness = ko_tests.GetFitness(pair_id++);
           
           // If both individual knockouts are both harmful, but in combination
           // they are neutral or even beneficial, they should not count as 
@@ -4416,10 +4547,6 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
             ko_pair_effect[line1] = -1;
             ko_pair_effect[line2] = -1;
           }	
-          
-          // Reset the mod_genome back to the original sequence.
-          seq[line1].SetOp(cur_inst1);
-          seq[line2].SetOp(cur_inst2);
         }
       }
     }    
@@ -4654,8 +4781,6 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     const int max_line = genotype->GetLength();
     const Genome& base_genome = genotype->GetGenome();
     const Sequence& base_seq = base_genome.GetSequence();
-    Genome mod_genome(base_genome);
-    Sequence& seq = mod_genome.GetSequence();
     
     // Keep track of the number of failues/successes for attributes...
     int * col_pass_count = new int[num_cols];
@@ -4668,14 +4793,19 @@ void cAnalyze::CommandMapTasks(cString cur_string)
     cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.GetInstSet());
     const cInstruction null_inst = is.ActivateNullInst();
     
-    // Loop through all the lines of code, testing the removal of each.
+    // Test the removal of each line of code
+    cMutantTestBatch ko_tests(m_world, m_jobqueue, base_genome);
+    ko_tests.SetTestSettings(test_info);
+    ko_tests.KeepGenotypes();
+    for (int line_num = 0; line_num < max_line; line_num++) ko_tests.AddMutant(line_num, null_inst.GetOp());
+    ko_tests.Run();
+    
+    // Loop through all the lines of code, printing the effects of the removal of each.
     for (int line_num = 0; line_num < max_line; line_num++) {
       int cur_inst = base_seq[line_num].GetOp();
       char cur_symbol = base_seq[line_num].GetSymbol();
       
-      seq[line_num] = null_inst;
-      cAnalyzeGenotype test_genotype(m_world, mod_genome);
-      test_genotype.Recalculate(m_ctx, &test_info);
+      cAnalyzeGenotype& test_genotype = ko_tests.GetGenotype(line_num);
       
       if (file_type == FILE_TYPE_HTML) fp << "<tr><td align=right>";
       fp << (line_num + 1) << " ";
@@ -4711,9 +4841,6 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       }
       if (file_type == FILE_TYPE_HTML) fp << "</tr>";
       fp << endl;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     }
     
     
@@ -5356,12 +5483,19 @@ void cAnalyze::CommandAnalyzeRedundancyByInstFailure(cString cur_string)
         }
         
         // Recalculate the requested number of times
+        // - the replicates run against modify_inst_set by name, so the failure probabilities above must be fully set
+        //   before Run() and must not change until it returns
+        // - genotype itself is not recalculated at each failure rate, so after this command it keeps the phenotype
+        //   and fitness of the baseline (no failure) test above
+        cMutantTestBatch replicate_tests(m_world, m_jobqueue, genotype->GetGenome());
+        for (int i = 0; i < replicates; i++) replicate_tests.AddReplicate();
+        replicate_tests.Run();
+        
         double chance = 0;
         double avg_fitness = 0;
         for (int i = 0; i < replicates; i++) {
-          genotype->Recalculate(m_ctx);
-          if (genotype->GetFitness() < baseline_fitness) chance++;
-          avg_fitness += genotype->GetFitness();
+          if (replicate_tests.GetFitness(i) < baseline_fitness) chance++;
+          avg_fitness += replicate_tests.GetFitness(i);
         }      
         
         if (mode == 0) {
@@ -6153,71 +6287,34 @@ void cAnalyze::CommandMutagenize(cString cur_string)
 
 void cAnalyze::CommandAlign(cString cur_string)
 {
-  // Align does not need any args yet.
-  (void) cur_string;
+  cString method = (cur_string.GetSize()) ? cur_string.PopWord() : cString("lineage");
+  if (method != "lineage" && method != "progressive") {
+    cerr << "Error: Unknown alignment method '" << method << "'" << endl;
+    return;
+  }
   
   cout << "Aligning sequences..." << endl;
   
-  if (batch[cur_batch].IsLineage() == false && m_world->GetVerbosity() >= VERBOSE_ON) {
-    cerr << "  Warning: sequences may not be a consecutive lineage."
+  if (method == "lineage" && batch[cur_batch].IsLineage() == false && m_world->GetVerbosity() >= VERBOSE_ON) {
+    cerr << "  Warning: sequences may not be a consecutive lineage; use ALIGN progressive for arbitrary batches."
     << endl;
   }
   
-  // Create an array of all the sequences we need to align.
   tListPlus<cAnalyzeGenotype> & glist = batch[cur_batch].List();
   tListIterator<cAnalyzeGenotype> batch_it(glist);
-  const int num_sequences = glist.GetSize();
-  cString * sequences = new cString[num_sequences];
   
-  // Move through each sequence and update it.
-  batch_it.Reset();
-  cString diff_info;
-  for (int i = 0; i < num_sequences; i++) {
-    sequences[i] = batch_it.Next()->GetGenome().GetSequence().AsString();
-    if (i == 0) continue;
-    // Track of the number of insertions and deletions to shift properly.
-    int num_ins = 0;
-    int num_del = 0;
-    
-    // Compare each string to the previous.
-    cStringUtil::EditDistance(sequences[i], sequences[i-1], diff_info, '_');
-    
-    while (diff_info.GetSize() != 0) {
-      cString cur_mut = diff_info.Pop(',');
-      const char mut_type = cur_mut[0];
-      cur_mut.ClipFront(1); cur_mut.ClipEnd(1);
-      int position = cur_mut.AsInt();
-      
-      // Nothing to do with Mutations
-      if (mut_type == 'M') continue;
-      
-      // Handle insertions...
-      if (mut_type == 'I') {
-        // Loop back and insert an '_' into all previous sequences.
-        for (int j = 0; j < i; j++) {
-          sequences[j].Insert('_', position + num_del);
-        }
-        num_ins++;
-      }
-      
-      // Handle Deletions...
-      else if (mut_type == 'D') {
-        // Insert '_' into the current sequence at the point of deletions.
-        sequences[i].Insert("_", position + num_ins);
-        num_del++;
-      }
-      
-    }
-  }
+  cSequenceAligner aligner(m_jobqueue);
+  cAnalyzeGenotype* genotype = NULL;
+  while ((genotype = batch_it.Next()) != NULL) aligner.AddSequence(genotype->GetGenome().GetSequence());
+  
+  if (method == "lineage") aligner.AlignLineage();
+  else aligner.AlignProgressive();
   
   batch_it.Reset();
-  for (int i = 0; i < num_sequences; i++) {
-    batch_it.Next()->SetAlignedSequence(sequences[i]);
+  for (int i = 0; i < aligner.GetNumSequences(); i++) {
+    batch_it.Next()->SetAlignedSequence(aligner.GetAlignedSequence(i));
   }
   
-  // Cleanup
-  delete [] sequences;
-  
   // Adjust the flags on this batch
   // batch[cur_batch].SetLineage(false);
   batch[cur_batch].SetAligned(true);
@@ -7702,8 +7799,6 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     const int max_line = genotype->GetLength();
     const Genome& base_genome = genotype->GetGenome();
     const Sequence& base_seq = base_genome.GetSequence();
-    Genome mod_genome(base_genome);
-    Sequence& seq = mod_genome.GetSequence();
     const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.GetInstSet()).GetSize();
     
     /*
@@ -7721,17 +7816,20 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     tArray<double> prob(num_insts);
     tArray<double> prob_next(num_insts);
     
+    // recalculate fitness of each single site mutant.
+    cMutantTestBatch site_tests(m_world, m_jobqueue, base_genome);
+    for (int line_num = 0; line_num < max_line; line_num++) {
+      for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) site_tests.AddMutant(line_num, mod_inst);
+    }
+    site_tests.Run();
+    
     // run through lines in genome
     for (int line_num = 0; line_num < max_line; line_num++) {
       // get the current instruction at this line/site
       int cur_inst = base_seq[line_num].GetOp();
       
-      // recalculate fitness of each mutant.
       for (int mod_inst = 0; mod_inst < num_insts; mod_inst++) {
-        seq[line_num].SetOp(mod_inst);
-        cAnalyzeGenotype test_genotype(m_world, mod_genome);
-        test_genotype.Recalculate(m_ctx);
-        test_fitness[mod_inst] = test_genotype.GetFitness();
+        test_fitness[mod_inst] = site_tests.GetFitness(line_num * num_insts + mod_inst);
       }
       
       // Adjust fitness
@@ -7822,9 +7920,6 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
       // save entropy for this line/site number
       entropy_ss_mers[line_num] = entropy_mers;
       entropy_ss_bits[line_num] = entropy_bits;
-      
-      // Reset the mod_genome back to the original sequence.
-      seq[line_num].SetOp(cur_inst);
     }
     
     /*
@@ -7845,6 +7940,19 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     // - only consider lin_num2 > lin_num1 so that we don't consider
     // Mut Info [1][45] and Mut Info [45][1]
     for (int line_num1 = 0; line_num1 < max_line; line_num1++) {
+      // recalculate fitness of each two site mutant with line_num1 as the first site
+      site_tests.Clear();
+      if (genotype->GetFitness() > 0.0) {
+        for (int line_num2 = line_num1+1; line_num2 < max_line; line_num2++) {
+          for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1++) {
+            for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2++) {
+              site_tests.AddMutant(line_num1, mod_inst1, line_num2, mod_inst2);
+            }
+          }
+        }
+        site_tests.Run();
+      }
+      
       for (int line_num2 = line_num1+1; line_num2 < max_line; line_num2++) {
         // debug
         //cout << "line #1, #2: " << line_num1 << ", " << line_num2 << endl; 
@@ -7863,15 +7971,10 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
         if (cur_inst_fitness_2s > 0.0) {
           // current fitness greater than zero
           // run through all possible instructions
+          int mutant = (line_num2 - line_num1 - 1) * num_insts * num_insts;
           for (int mod_inst1 = 0; mod_inst1 < num_insts; mod_inst1++) {
             for (int mod_inst2 = 0; mod_inst2 < num_insts; mod_inst2++) {
-              // modify mod_genome at two sites
-              seq[line_num1].SetOp(mod_inst1);
-              seq[line_num2].SetOp(mod_inst2);
-              // analyze mod_genome
-              cAnalyzeGenotype test_genotype(m_world, mod_genome);
-              test_genotype.Recalculate(m_ctx);
-              test_fitness_2s[mod_inst1][mod_inst2] = test_genotype.GetFitness();
+              test_fitness_2s[mod_inst1][mod_inst2] = site_tests.GetFitness(mutant++);
               
               // if modified fitness is greater than current fitness
               //  - set equal to current fitness
@@ -8048,10 +8151,6 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
         fp_2s.Write(entropy_ds_mers,              "Joint Entropy (MERS), Site 1 & 2 -- TWO site mut-sel balance");
         fp_2s.Write(mutual_information_mers,      "Mutual Information (MERS), Site 1 & 2 -- TWO site mut-sel balance");
         fp_2s.Endl();
-                    
-        // Reset the mod_genome back to the original sequence.
-        seq[line_num1].SetOp(cur_inst1);
-        seq[line_num2].SetOp(cur_inst2);
         
       }// end line 2
     }// end line 1
@@ -8767,6 +8866,188 @@ void cAnalyze::CommandInteractive(cString cur_string)
 }
 
 
+// Trivial compute-only job used to measure scheduling overhead of the analyze job queue
+class cJobQueueBenchmarkJob : public cAnalyzeJob
+{
+private:
+  int m_work;
+  double m_result;
+  
+public:
+  cJobQueueBenchmarkJob(int work) : m_work(work), m_result(0.0) { ; }
+  
+  void Run(cAvidaContext&)
+  {
+    double acc = 1.0;
+    for (int i = 0; i < m_work; i++) acc = acc * 1.0000001 + 0.5 / (i + 1);
+    m_result = acc;
+  }
+};
+
+static double benchmarkWallTime()
+{
+#if APTO_PLATFORM(WINDOWS)
+  return static_cast<double>(clock()) / CLOCKS_PER_SEC;  // clock() measures wall time on Windows
+#else
+  timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+#endif
+}
+
+// Arguments: [int num_jobs=100000] [int job_work=1000]
+void cAnalyze::CommandBenchmarkJobQueue(cString cur_string)
+{
+  const int num_jobs = (cur_string.GetSize()) ? cur_string.PopWord().AsInt() : 100000;
+  const int job_work = (cur_string.GetSize()) ? cur_string.PopWord().AsInt() : 1000;
+  const int worker_counts[] = { 1, 8, 64 };
+  
+  // Queues are seeded with a fixed value, so that benchmarking leaves the world RNG untouched
+  const int seed = 1;
+  
+  cout << "Benchmarking analyze job queue: " << num_jobs << " jobs of " << job_work << " iterations each" << endl;
+  
+  for (int c = 0; c < 3; c++) {
+    // Reference arm: the single locked queue, with jobs submitted one at a time as tAnalyzeJobBatch used to
+    double locked_elapsed = 0.0;
+    {
+      cAnalyzeLockedJobQueue queue(m_world, worker_counts[c], seed);
+      tSmartArray<cAnalyzeJob*> jobs(num_jobs);
+      for (int i = 0; i < num_jobs; i++) jobs[i] = new cJobQueueBenchmarkJob(job_work);
+      const double start = benchmarkWallTime();
+      for (int i = 0; i < num_jobs; i++) queue.AddJob(jobs[i]);
+      queue.Execute();
+      locked_elapsed = benchmarkWallTime() - start;
+    }
+    
+    // Work-stealing deques, with jobs submitted as one block as tAnalyzeJobBatch now does
+    double stealing_elapsed = 0.0;
+    {
+      cAnalyzeJobQueue queue(m_world, worker_counts[c], seed);
+      tSmartArray<cAnalyzeJob*> jobs(num_jobs);
+      for (int i = 0; i < num_jobs; i++) jobs[i] = new cJobQueueBenchmarkJob(job_work);
+      const double start = benchmarkWallTime();
+      queue.AddJobs(jobs);
+      queue.Execute();
+      stealing_elapsed = benchmarkWallTime() - start;
+    }
+    
+    cout << "  workers: " << setw(2) << worker_counts[c]
+         << "  locked queue  time: " << setw(10) << locked_elapsed << " s"
+         << "  jobs/s: " << ((locked_elapsed > 0.0) ? num_jobs / locked_elapsed : 0.0) << endl;
+    cout << "  workers: " << setw(2) << worker_counts[c]
+         << "  work-stealing time: " << setw(10) << stealing_elapsed << " s"
+         << "  jobs/s: " << ((stealing_elapsed > 0.0) ? num_jobs / stealing_elapsed : 0.0) << endl;
+  }
+}
+
+// Arguments: [string stat="fitness"] [string test_value="1.0"] [int repeats=10]
+void cAnalyze::CommandBenchmarkStatColumn(cString cur_string)
+{
+  const cString stat_name = (cur_string.GetSize()) ? cur_string.PopWord() : cString("fitness");
+  const cString test_value = (cur_string.GetSize()) ? cur_string.PopWord() : cString("1.0");
+  const int repeats = (cur_string.GetSize()) ? cur_string.PopWord().AsInt() : 10;
+  
+  tDataEntryCommand<cAnalyzeGenotype>* stat_command = cAnalyzeGenotype::GetDataCommandManager().GetDataCommand(stat_name);
+  if (stat_command == NULL) {
+    cerr << "Error: Unknown stat '" << stat_name << "'" << endl;
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  // Run any test CPUs first, so that both arms only time reading the stat
+  tList< tDataEntryCommand<cAnalyzeGenotype> > stat_list;
+  tListIterator< tDataEntryCommand<cAnalyzeGenotype> > stat_it(stat_list);
+  stat_list.Push(stat_command);
+  CommandDetail_Prefetch(stat_it, batch[cur_batch].List());
+  
+  tListPlus<cAnalyzeGenotype>& gen_list = batch[cur_batch].List();
+  if (!cAnalyzeStatColumn(gen_list, *stat_command).IsNumeric()) {
+    cerr << "Error: BENCHMARK_STAT_COLUMN needs a numeric stat and a non-empty batch" << endl;
+    delete stat_command;
+    if (exit_on_error) exit(1);
+    return;
+  }
+  
+  cout << "Benchmarking stat column: " << stat_name << " over " << gen_list.GetSize() << " genotypes, "
+       << repeats << " repeats" << endl;
+  
+  // FILTER [stat] >= [test_value], counting the genotypes kept rather than removing any
+  tArray<bool> rel_ok(3, false);
+  rel_ok[1] = true;
+  rel_ok[2] = true;
+  
+  int flex_kept = 0;
+  double start = benchmarkWallTime();
+  for (int r = 0; r < repeats; r++) {
+    const cFlexVar test_flex(test_value);
+    tListIterator<cAnalyzeGenotype> batch_it(gen_list);
+    cAnalyzeGenotype* genotype = NULL;
+    while ((genotype = batch_it.Next()) != NULL) {
+      if (rel_ok[1 + CompareFlexStat(stat_command->GetValue(genotype), test_flex)]) flex_kept++;
+    }
+  }
+  const double flex_filter_elapsed = benchmarkWallTime() - start;
+  
+  int packed_kept = 0;
+  start = benchmarkWallTime();
+  for (int r = 0; r < repeats; r++) {
+    cAnalyzeStatColumn column(gen_list, *stat_command);
+    tArray<bool> keep;
+    column.Filter(test_value.AsDouble(), rel_ok, keep);
+    for (int row = 0; row < keep.GetSize(); row++) if (keep[row]) packed_kept++;
+  }
+  const double packed_filter_elapsed = benchmarkWallTime() - start;
+  
+  // HISTOGRAM [stat], building the counts without printing them
+  int flex_bins = 0;
+  start = benchmarkWallTime();
+  for (int r = 0; r < repeats; r++) {
+    tDictionary<int> count_dict;
+    tListIterator<cAnalyzeGenotype> batch_it(gen_list);
+    cAnalyzeGenotype* genotype = NULL;
+    while ((genotype = batch_it.Next()) != NULL) {
+      const cString cur_name(stat_command->GetValue(genotype).AsString());
+      int count = 0;
+      count_dict.Find(cur_name, count);
+      count_dict.Set(cur_name, count + genotype->GetNumCPUs());
+    }
+    flex_bins = count_dict.GetSize();
+  }
+  const double flex_histogram_elapsed = benchmarkWallTime() - start;
+  
+  int packed_bins = 0;
+  start = benchmarkWallTime();
+  for (int r = 0; r < repeats; r++) {
+    tDictionary<int> count_dict;
+    cAnalyzeStatColumn column(gen_list, *stat_command);
+    tArray<int> num_cpus(column.GetSize());
+    for (int row = 0; row < column.GetSize(); row++) num_cpus[row] = column.GetGenotype(row)->GetNumCPUs();
+    tArray<int> first_rows;
+    tArray<int> totals;
+    column.CountDistinct(num_cpus, first_rows, totals);
+    for (int i = 0; i < first_rows.GetSize(); i++) {
+      const cString cur_name(column.GetValueString(first_rows[i]));
+      int count = 0;
+      count_dict.Find(cur_name, count);
+      count_dict.Set(cur_name, count + totals[i]);
+    }
+    packed_bins = count_dict.GetSize();
+  }
+  const double packed_histogram_elapsed = benchmarkWallTime() - start;
+  
+  delete stat_command;
+  
+  cout << "  filter     cFlexVar time: " << setw(10) << flex_filter_elapsed << " s  kept: " << flex_kept << endl;
+  cout << "  filter     packed   time: " << setw(10) << packed_filter_elapsed << " s  kept: " << packed_kept << endl;
+  cout << "  histogram  cFlexVar time: " << setw(10) << flex_histogram_elapsed << " s  bins: " << flex_bins << endl;
+  cout << "  histogram  packed   time: " << setw(10) << packed_histogram_elapsed << " s  bins: " << packed_bins << endl;
+  if (flex_kept != packed_kept || flex_bins != packed_bins) {
+    cerr << "Error: packed stat column results differ from the cFlexVar results" << endl;
+  }
+}
+
+
 /*
  FIXME@kgn
  Must categorize COMPETE command.
@@ -9547,6 +9828,8 @@ void cAnalyze::SetupCommandDefLibrary()
   AddLibraryDef("RUN", &cAnalyze::IncludeFile);
   AddLibraryDef("SYSTEM", &cAnalyze::CommandSystem);
   AddLibraryDef("INTERACTIVE", &cAnalyze::CommandInteractive);
+  AddLibraryDef("BENCHMARK_JOB_QUEUE", &cAnalyze::CommandBenchmarkJobQueue);
+  AddLibraryDef("BENCHMARK_STAT_COLUMN", &cAnalyze::CommandBenchmarkStatColumn);
   
   // Functions...
   AddLibraryDef("FUNCTION", &cAnalyze::FunctionCreate);
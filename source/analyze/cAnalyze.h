@@ -48,6 +48,7 @@ class cAnalyzeGenotype;
 class cAnalyzeScreen;
 class cCPUTestInfo;
 class cEnvironment;
+class cGenotypeLoader;
 class cInitFile;
 class cInstSet;
 class cResourceHistory;
@@ -187,6 +188,8 @@ private:
   void CommandDetail_Body(std::ostream& fp, int format_type,
                           tListIterator< tDataEntryCommand<cAnalyzeGenotype> > & output_it,
                           int time_step = -1, int max_time = 1);
+  void CommandDetail_Prefetch(tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it,
+                              tList<cAnalyzeGenotype>& genotypes);
   void CommandDetailAverage_Body(std::ostream& fp, int num_arguments,
                                  tListIterator< tDataEntryCommand<cAnalyzeGenotype> >& output_it);
   void CommandHistogram_Header(std::ostream& fp, int format_type,
@@ -202,6 +205,8 @@ private:
   // from a file specified by the user, or resource.dat by default.
   void LoadResources(cString cur_string);
   void LoadFile(cString cur_string);
+  bool LoadFile_Columns(cGenotypeLoader& loader, const cString& filetype, const cStringList& format,
+                        const cStringList& columns);
   
   // Reduction and Sampling
   void CommandFilter(cString cur_string);
@@ -310,6 +315,8 @@ private:
   void IncludeFile(cString cur_string);
   void CommandSystem(cString cur_string);
   void CommandInteractive(cString cur_string);
+  void CommandBenchmarkJobQueue(cString cur_string);
+  void CommandBenchmarkStatColumn(cString cur_string);
   
   // Uncategorized...
   void BatchCompete(cString cur_string);
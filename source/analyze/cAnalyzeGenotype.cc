@@ -518,27 +518,64 @@ void cAnalyzeGenotype::CalcKnockouts(bool check_pairs, bool check_chart) const
 }
 
 void cAnalyzeGenotype::CheckLand() const
+{
+  if (m_land == NULL) CheckLand(m_world->GetDefaultContext());
+}
+
+void cAnalyzeGenotype::CheckLand(cAvidaContext& ctx) const
 {
   if (m_land == NULL) {
-    m_land = new cLandscape(m_world, m_genome);
-    m_land->SetCPUTestInfo(m_cpu_test_info);
-    m_land->SetDistance(1);
-    m_land->Process(m_world->GetDefaultContext());
+    cLandscape* land = new cLandscape(m_world, m_genome);
+    land->SetCPUTestInfo(m_cpu_test_info);
+    land->SetDistance(1);
+    land->Process(ctx);
+    m_land = land;
   }
 }
 
 void cAnalyzeGenotype::CheckPhenPlast() const
+{
+  if (m_phenplast_stats == NULL) CheckPhenPlast(m_world->GetDefaultContext());
+}
+
+void cAnalyzeGenotype::CheckPhenPlast(cAvidaContext& ctx) const
 {
   // Implicit genotype recalculation if required
   if (m_phenplast_stats == NULL) {
     cCPUTestInfo test_info;
     
-    cPhenPlastGenotype pp(m_genome, 1000, test_info, m_world, m_world->GetDefaultContext());
+    cPhenPlastGenotype pp(m_genome, 1000, test_info, m_world, ctx);
     m_phenplast_stats = new cPhenPlastSummary(pp);
   }
 }
 
 
+int cAnalyzeGenotype::GetPrefetchFlags(const cString& entry_name)
+{
+  if (entry_name == "frac_dead" || entry_name == "frac_neg" || entry_name == "frac_neut" ||
+      entry_name == "frac_pos" || entry_name == "complexity" || entry_name == "land_fitness") {
+    return PREFETCH_LANDSCAPE;
+  }
+  
+  if (entry_name == "num_phen" || entry_name == "num_trials" || entry_name == "phen_entropy" ||
+      entry_name == "phen_max_fitness" || entry_name == "phen_max_fit_freq" || entry_name == "phen_min_fitness" ||
+      entry_name == "phen_min_freq" || entry_name == "phen_avg_fitness" || entry_name == "phen_likely_freq" ||
+      entry_name == "phen_likely_fitness" || entry_name == "prob_viable" || entry_name == "prob_task") {
+    return PREFETCH_PHENPLAST;
+  }
+  
+  return 0;
+}
+
+// Compute the selected statistics now, so that later accesses do not have to.  Safe to run concurrently on different
+// genotypes, each with its own context.
+void cAnalyzeGenotype::Prefetch(cAvidaContext& ctx, int flags) const
+{
+  if (flags & PREFETCH_LANDSCAPE) CheckLand(ctx);
+  if (flags & PREFETCH_PHENPLAST) CheckPhenPlast(ctx);
+}
+
+
 
 void cAnalyzeGenotype::CalcLandscape(cAvidaContext& ctx)
 {
@@ -549,7 +586,8 @@ void cAnalyzeGenotype::CalcLandscape(cAvidaContext& ctx)
 }
 
 
-void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials)
+void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info, cAnalyzeGenotype* parent_genotype, int num_trials,
+                                   cTestCPU* test_cpu)
 {  
   // Allocate our own test info if it wasn't provided
   tAutoRelease<cCPUTestInfo> local_test_info;
@@ -560,7 +598,7 @@ void cAnalyzeGenotype::Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info,
   }
   
   // Handling recalculation here
-  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx);
+  cPhenPlastGenotype recalc_data(m_genome, num_trials, *test_info, m_world, ctx, test_cpu);
   
   // The most likely phenotype will be assigned to the phenotype stats
   const cPlasticPhenotype* likely_phenotype = recalc_data.GetMostLikelyPhenotype();
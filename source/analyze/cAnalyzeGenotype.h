@@ -234,7 +234,9 @@ private:
   int CalcMaxGestation() const;
   void CalcKnockouts(bool check_pairs = false, bool check_chart = false) const;
   void CheckLand() const;
+  void CheckLand(cAvidaContext& ctx) const;
   void CheckPhenPlast() const;
+  void CheckPhenPlast(cAvidaContext& ctx) const;
   void SummarizePhenotypicPlasticity(const cPhenPlastGenotype& pp) const;
   
   static tDataCommandManager<cAnalyzeGenotype>* buildDataCommandManager();
@@ -249,6 +251,14 @@ public:
   static void Initialize();
   static tDataCommandManager<cAnalyzeGenotype>& GetDataCommandManager();
   
+  // Data entries backed by statistics that are expensive to compute on first access
+  enum {
+    PREFETCH_LANDSCAPE = 0x1,
+    PREFETCH_PHENPLAST = 0x2
+  };
+  static int GetPrefetchFlags(const cString& entry_name);
+  void Prefetch(cAvidaContext& ctx, int flags) const;
+  
   class ReadToken;
   ReadToken* GetReadToken() const { m_data->rwlock.ReadLock(); return new ReadToken(this); }
 
@@ -257,7 +267,8 @@ public:
   
   void SetCPUTestInfo(cCPUTestInfo& in_cpu_test_info) { m_cpu_test_info = in_cpu_test_info; }
   
-  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1);
+  void Recalculate(cAvidaContext& ctx, cCPUTestInfo* test_info = NULL, cAnalyzeGenotype* parent_genotype = NULL, int num_trials = 1,
+                   cTestCPU* test_cpu = NULL);
   void PrintTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintTasksQuality(std::ofstream& fp, int min_task = 0, int max_task = -1);
   void PrintInternalTasks(std::ofstream& fp, int min_task = 0, int max_task = -1);
@@ -21,6 +21,7 @@
 
 #include "cAnalyzeJobQueue.h"
 
+#include "apto/core/Atomic.h"
 #include "apto/platform.h"
 #include "avida/Avida.h"
 #include "avida/core/WorldDriver.h"
@@ -37,22 +38,37 @@ using namespace Avida;
 
 
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
-: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+: m_world(world), m_last_jobid(0), m_next_deque(0), m_queued(0), m_jobs(0), m_terminate(false)
 {
+  int num_workers = Apto::Platform::AvailableCPUs();
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
-  if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
+  if (max_workers > 0 && max_workers < num_workers) num_workers = max_workers;
   
+  setupWorkers(num_workers, world->GetRandom());
+}
+
+cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world, int num_workers, int seed)
+: m_world(world), m_last_jobid(0), m_next_deque(0), m_queued(0), m_jobs(0), m_terminate(false)
+{
+  cRandomMT seed_rng(seed);
+  setupWorkers(num_workers, seed_rng);
+}
+
+void cAnalyzeJobQueue::setupWorkers(int num_workers, cRandom& seed_rng)
+{
   for (int i = 0; i < MT_RANDOM_POOL_SIZE; i++) {
-    m_rng_pool[i] = new cRandomMT(world->GetRandom().GetInt(0x7FFFFFFF));
+    m_rng_pool[i] = new cRandomMT(seed_rng.GetInt(0x7FFFFFFF));
   }
   
-  if (m_workers.GetSize() > 1) {
-    for (int i = 0; i < m_workers.GetSize(); i++) {
-      m_workers[i] = new cAnalyzeJobWorker(this);
+  if (num_workers > 1) {
+    m_deques.Resize(num_workers);
+    for (int i = 0; i < m_deques.GetSize(); i++) m_deques[i] = new cJobDeque;
+    
+    m_workers.Resize(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+      m_workers[i] = new cAnalyzeJobWorker(this, i);
       m_workers[i]->Start();
     }
-  } else {
-    m_workers.Resize(0);
   }
 }
 
@@ -60,48 +76,66 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
 {
   const int num_workers = m_workers.GetSize();
   
+  // Signal all workers to terminate once they find no work, then discard anything left waiting
   m_mutex.Lock();
-  
-  // Clean out any waiting jobs
-  cAnalyzeJob* job;
-  while ((job = m_queue.Pop())) delete job;
-  
-  // Set job count so that all workers receive NULL jobs
-  m_jobs = num_workers;
-  
+  m_terminate = true;
   m_mutex.Unlock();
-  
-  // Signal all workers to check job queue
   m_cond.Broadcast();
   
   for (int i = 0; i < num_workers; i++) {
     m_workers[i]->Join();
     delete m_workers[i];
   }
+  
+  for (int i = 0; i < m_deques.GetSize(); i++) delete m_deques[i];
+  for (int i = 0; i < MT_RANDOM_POOL_SIZE; i++) delete m_rng_pool[i];
 }
 
-inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
-{
-  if (m_workers.GetSize()) m_queue.PushRear(job);
-  else singleThreadedJobExecution(job);
-}
 
 void cAnalyzeJobQueue::AddJob(cAnalyzeJob* job)
 {
-  Apto::MutexAutoLock lock(m_mutex);
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
+  job->SetID(Apto::Atomic::Add(&m_last_jobid, 1) - 1);
+  if (!m_workers.GetSize()) {
+    singleThreadedJobExecution(job);
+    return;
+  }
+  
+  Apto::Atomic::Inc(&m_jobs);
+  m_deques[(Apto::Atomic::Add(&m_next_deque, 1) & 0x7FFFFFFF) % m_deques.GetSize()]->PushRear(job);
+  Apto::Atomic::Inc(&m_queued);
 }
 
 void cAnalyzeJobQueue::AddJobImmediate(cAnalyzeJob* job)
 {
-  m_mutex.Lock();
-  job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
-  m_mutex.Unlock(); // should unlock prior to signaling condition variable
-  m_cond.Signal();
+  AddJob(job);
+  if (m_workers.GetSize()) wakeWorkers();
+}
+
+void cAnalyzeJobQueue::AddJobs(const tSmartArray<cAnalyzeJob*>& jobs)
+{
+  const int num_jobs = jobs.GetSize();
+  if (num_jobs == 0) return;
+  
+  const int first_id = Apto::Atomic::Add(&m_last_jobid, num_jobs) - num_jobs;
+  for (int i = 0; i < num_jobs; i++) jobs[i]->SetID(first_id + i);
+  
+  if (!m_workers.GetSize()) {
+    for (int i = 0; i < num_jobs; i++) singleThreadedJobExecution(jobs[i]);
+    return;
+  }
+  
+  // Deal the batch out across the deques in contiguous blocks, taking each deque lock once
+  Apto::Atomic::Add(&m_jobs, num_jobs);
+  const int num_deques = m_deques.GetSize();
+  const int first_deque = (Apto::Atomic::Add(&m_next_deque, 1) & 0x7FFFFFFF) % num_deques;
+  int offset = 0;
+  for (int i = 0; i < num_deques; i++) {
+    const int block = num_jobs / num_deques + ((i < num_jobs % num_deques) ? 1 : 0);
+    if (block == 0) break;
+    m_deques[(first_deque + i) % num_deques]->PushRear(&jobs[offset], block);
+    offset += block;
+  }
+  Apto::Atomic::Add(&m_queued, num_jobs);
 }
 
 
@@ -110,7 +144,7 @@ void cAnalyzeJobQueue::Start()
   if (m_world->GetVerbosity() >= VERBOSE_DETAILS)
     m_world->GetDriver().NotifyComment("waking worker threads...");
 
-  m_cond.Broadcast();
+  wakeWorkers();
 }
 
 
@@ -119,11 +153,11 @@ void cAnalyzeJobQueue::Execute()
   if (m_world->GetVerbosity() >= VERBOSE_DETAILS)
     m_world->GetDriver().NotifyComment("waking worker threads...");
 
-  m_cond.Broadcast();
+  wakeWorkers();
   
   // Wait for term signal
   m_mutex.Lock();
-  while (m_jobs > 0 || m_pending > 0) {
+  while (Apto::Atomic::Get(&m_jobs) > 0) {
     m_term_cond.Wait(m_mutex);
   }
   m_mutex.Unlock();
@@ -132,6 +166,7 @@ void cAnalyzeJobQueue::Execute()
     m_world->GetDriver().NotifyComment("job queue complete");
 }
 
+
 void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
   cAvidaContext ctx(m_world, NULL);
@@ -140,3 +175,85 @@ void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
   delete job;
 }
 
+cAnalyzeJob* cAnalyzeJobQueue::takeJob(int worker_id)
+{
+  if (Apto::Atomic::Get(&m_queued) <= 0) return NULL;
+  
+  const int num_deques = m_deques.GetSize();
+  const int own = worker_id % num_deques;
+  
+  cAnalyzeJob* job = m_deques[own]->PopRear();
+  for (int i = 1; !job && i < num_deques; i++) job = m_deques[(own + i) % num_deques]->PopFront();
+  
+  if (job) Apto::Atomic::Dec(&m_queued);
+  return job;
+}
+
+void cAnalyzeJobQueue::completeJob()
+{
+  if (Apto::Atomic::DecAndTest(&m_jobs)) {
+    // Take the lock so that the signal cannot slip in between Execute() testing the count and waiting
+    m_mutex.Lock();
+    m_term_cond.Broadcast();
+    m_mutex.Unlock();
+  }
+}
+
+void cAnalyzeJobQueue::wakeWorkers()
+{
+  m_mutex.Lock();
+  m_cond.Broadcast();
+  m_mutex.Unlock();
+}
+
+
+cAnalyzeJobQueue::cJobDeque::~cJobDeque()
+{
+  cAnalyzeJob* job;
+  while ((job = PopFront())) delete job;
+}
+
+void cAnalyzeJobQueue::cJobDeque::grow(int min_size)
+{
+  int new_size = (m_jobs.GetSize() > 0) ? m_jobs.GetSize() * 2 : 64;
+  while (new_size < min_size) new_size *= 2;
+  
+  tArray<cAnalyzeJob*> new_jobs(new_size);
+  for (int i = 0; i < m_count; i++) new_jobs[i] = m_jobs[(m_head + i) % m_jobs.GetSize()];
+  m_jobs = new_jobs;
+  m_head = 0;
+}
+
+void cAnalyzeJobQueue::cJobDeque::PushRear(cAnalyzeJob* job)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_count == m_jobs.GetSize()) grow(m_count + 1);
+  m_jobs[(m_head + m_count) % m_jobs.GetSize()] = job;
+  m_count++;
+}
+
+void cAnalyzeJobQueue::cJobDeque::PushRear(cAnalyzeJob* const* jobs, int num_jobs)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_count + num_jobs > m_jobs.GetSize()) grow(m_count + num_jobs);
+  for (int i = 0; i < num_jobs; i++) m_jobs[(m_head + m_count + i) % m_jobs.GetSize()] = jobs[i];
+  m_count += num_jobs;
+}
+
+cAnalyzeJob* cAnalyzeJobQueue::cJobDeque::PopRear()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_count == 0) return NULL;
+  m_count--;
+  return m_jobs[(m_head + m_count) % m_jobs.GetSize()];
+}
+
+cAnalyzeJob* cAnalyzeJobQueue::cJobDeque::PopFront()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_count == 0) return NULL;
+  cAnalyzeJob* job = m_jobs[m_head];
+  m_head = (m_head + 1) % m_jobs.GetSize();
+  m_count--;
+  return job;
+}
@@ -37,6 +37,9 @@
 #ifndef tList_h
 #include "tList.h"
 #endif
+#ifndef tSmartArray_h
+#include "tSmartArray.h"
+#endif
 
 class cAnalyzeJobWorker;
 class cWorld;
@@ -55,22 +58,52 @@ class cAnalyzeJobQueue
   friend class cAnalyzeJobWorker;
   
 private:
+  // Per-worker job deque.  The owning worker takes jobs from the rear, idle workers steal from the front.
+  // Each deque has its own lock, so in the common case a worker only ever touches uncontended state.
+  class cJobDeque
+  {
+  private:
+    Apto::Mutex m_mutex;
+    tArray<cAnalyzeJob*> m_jobs;  // ring buffer
+    int m_head;
+    int m_count;
+    
+    void grow(int min_size);
+    
+  public:
+    cJobDeque() : m_head(0), m_count(0) { ; }
+    ~cJobDeque();
+    
+    void PushRear(cAnalyzeJob* job);
+    void PushRear(cAnalyzeJob* const* jobs, int num_jobs);
+    cAnalyzeJob* PopRear();
+    cAnalyzeJob* PopFront();
+  };
+  
   cWorld* m_world;
-  tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
   cRandomMT* m_rng_pool[MT_RANDOM_POOL_SIZE];
+  
+  tArray<cJobDeque*> m_deques;
+  volatile int m_next_deque;  // round-robin submission target for jobs added from outside the workers
+  
+  // Idle workers and Execute() sleep on these, they are not touched while jobs are flowing
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
   
-  volatile int m_jobs;      // count of waiting jobs, used in condition variable constructs
-  volatile int m_pending;   // count of currently executing jobs
+  volatile int m_queued;     // count of jobs sitting in the deques, updated atomically
+  volatile int m_jobs;       // count of submitted jobs that have not yet completed, updated atomically
+  volatile bool m_terminate;
   
   tArray<cAnalyzeJobWorker*> m_workers;
 
 
+  void setupWorkers(int num_workers, cRandom& seed_rng);
   void singleThreadedJobExecution(cAnalyzeJob* job);
-  inline void queueJob(cAnalyzeJob* job);
+  cAnalyzeJob* takeJob(int worker_id);
+  void completeJob();
+  void wakeWorkers();
 
   
   cAnalyzeJobQueue(); // @not_implemented
@@ -80,14 +113,17 @@ private:
 
 public:
   cAnalyzeJobQueue(cWorld* world);
+  cAnalyzeJobQueue(cWorld* world, int num_workers, int seed);  // RNG pool seeded from seed, not the world RNG
   ~cAnalyzeJobQueue();
 
   void AddJob(cAnalyzeJob* job);
   void AddJobImmediate(cAnalyzeJob* job);
+  void AddJobs(const tSmartArray<cAnalyzeJob*>& jobs);
 
   void Start();
   void Execute();
   
+  int GetNumWorkers() const { return m_workers.GetSize(); }
   cRandom* GetRandom(int jobid) { return m_rng_pool[jobid & MT_RANDOM_INDEX_MASK]; } 
 };
 
@@ -21,6 +21,8 @@
 
 #include "cAnalyzeJobWorker.h"
 
+#include "apto/core/Atomic.h"
+
 #include "cAnalyzeJobQueue.h"
 #include "cAvidaContext.h"
 
@@ -30,34 +32,22 @@ void cAnalyzeJobWorker::Run()
   cAvidaContext ctx(m_queue->m_world, NULL);
   ctx.SetAnalyzeMode();
   
-  cAnalyzeJob* job = NULL;
-  
-  while (1) {
-    m_queue->m_mutex.Lock();
-    while (m_queue->m_jobs == 0) {
-      m_queue->m_cond.Wait(m_queue->m_mutex);
-    }
-    job = m_queue->m_queue.Pop();
-    m_queue->m_jobs--;
-    m_queue->m_pending++; 
-    m_queue->m_mutex.Unlock();
+  while (!m_queue->m_terminate) {
+    cAnalyzeJob* job = m_queue->takeJob(m_id);
     
     if (job) {
       // Set RNG from the waiting pool and execute the job
       ctx.SetRandom(m_queue->GetRandom(job->GetID()));
       job->Run(ctx);
       delete job;
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
+      m_queue->completeJob();
     } else {
-      // Terminate worker on NULL job receipt
+      // Nothing left to take or steal, sleep until more work is submitted or the queue is destroyed
       m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
+      while (Apto::Atomic::Get(&m_queue->m_queued) <= 0 && !m_queue->m_terminate) {
+        m_queue->m_cond.Wait(m_queue->m_mutex);
+      }
       m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-      break;
     }
   }
 }
@@ -0,0 +1,138 @@
+/*
+ *  cAnalyzeLockedJobQueue.cc
+ *  Avida
+ *
+ *  Copyright 2006-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeLockedJobQueue.h"
+
+#include "cAvidaContext.h"
+
+
+cAnalyzeLockedJobQueue::cAnalyzeLockedJobQueue(cWorld* world, int num_workers, int seed)
+: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0)
+{
+  cRandomMT seed_rng(seed);
+  for (int i = 0; i < MT_RANDOM_POOL_SIZE; i++) {
+    m_rng_pool[i] = new cRandomMT(seed_rng.GetInt(0x7FFFFFFF));
+  }
+  
+  if (num_workers > 1) {
+    m_workers.Resize(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+      m_workers[i] = new cWorker(this);
+      m_workers[i]->Start();
+    }
+  }
+}
+
+cAnalyzeLockedJobQueue::~cAnalyzeLockedJobQueue()
+{
+  const int num_workers = m_workers.GetSize();
+  
+  m_mutex.Lock();
+  
+  // Clean out any waiting jobs
+  cAnalyzeJob* job;
+  while ((job = m_queue.Pop())) delete job;
+  
+  // Set job count so that all workers receive NULL jobs
+  m_jobs = num_workers;
+  
+  m_mutex.Unlock();
+  
+  // Signal all workers to check job queue
+  m_cond.Broadcast();
+  
+  for (int i = 0; i < num_workers; i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+  
+  for (int i = 0; i < MT_RANDOM_POOL_SIZE; i++) delete m_rng_pool[i];
+}
+
+
+void cAnalyzeLockedJobQueue::AddJob(cAnalyzeJob* job)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  job->SetID(m_last_jobid++);
+  if (m_workers.GetSize()) m_queue.PushRear(job);
+  else singleThreadedJobExecution(job);
+  m_jobs++;
+}
+
+
+void cAnalyzeLockedJobQueue::Execute()
+{
+  m_cond.Broadcast();
+  
+  // Wait for term signal
+  m_mutex.Lock();
+  while (m_jobs > 0 || m_pending > 0) {
+    m_term_cond.Wait(m_mutex);
+  }
+  m_mutex.Unlock();
+}
+
+
+void cAnalyzeLockedJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
+{
+  cAvidaContext ctx(m_world, NULL);
+  ctx.SetRandom(GetRandom(job->GetID()));
+  job->Run(ctx);
+  delete job;
+  m_jobs--;
+}
+
+
+void cAnalyzeLockedJobQueue::cWorker::Run()
+{
+  cAvidaContext ctx(m_queue->m_world, NULL);
+  ctx.SetAnalyzeMode();
+  
+  cAnalyzeJob* job = NULL;
+  
+  while (1) {
+    m_queue->m_mutex.Lock();
+    while (m_queue->m_jobs == 0) {
+      m_queue->m_cond.Wait(m_queue->m_mutex);
+    }
+    job = m_queue->m_queue.Pop();
+    m_queue->m_jobs--;
+    m_queue->m_pending++; 
+    m_queue->m_mutex.Unlock();
+    
+    if (job) {
+      // Set RNG from the waiting pool and execute the job
+      ctx.SetRandom(m_queue->GetRandom(job->GetID()));
+      job->Run(ctx);
+      delete job;
+      m_queue->m_mutex.Lock();
+      int pending = --m_queue->m_pending;
+      m_queue->m_mutex.Unlock();
+      if (!pending) m_queue->m_term_cond.Signal();
+    } else {
+      // Terminate worker on NULL job receipt
+      m_queue->m_mutex.Lock();
+      int pending = --m_queue->m_pending;
+      m_queue->m_mutex.Unlock();
+      if (!pending) m_queue->m_term_cond.Signal();
+      break;
+    }
+  }
+}
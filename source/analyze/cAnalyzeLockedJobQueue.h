@@ -0,0 +1,99 @@
+/*
+ *  cAnalyzeLockedJobQueue.h
+ *  Avida
+ *
+ *  Copyright 2006-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeLockedJobQueue_h
+#define cAnalyzeLockedJobQueue_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#ifndef cAnalyzeJob
+#include "cAnalyzeJob.h"
+#endif
+#ifndef cAnalyzeJobQueue_h
+#include "cAnalyzeJobQueue.h"
+#endif
+#ifndef cRandom_h
+#include "cRandom.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+#ifndef tList_h
+#include "tList.h"
+#endif
+
+class cWorld;
+
+
+// The analyze job queue as it was before per-worker deques: a single job list behind one mutex, with every worker
+// taking jobs one at a time under that lock and reporting completion through a locked pending count.  Kept only as
+// the reference arm of BENCHMARK_JOB_QUEUE.
+class cAnalyzeLockedJobQueue
+{
+private:
+  class cWorker : public Apto::Thread
+  {
+  private:
+    cAnalyzeLockedJobQueue* m_queue;
+    
+    void Run();
+    
+  public:
+    cWorker(cAnalyzeLockedJobQueue* queue) : m_queue(queue) { ; }
+  };
+  friend class cWorker;
+  
+  cWorld* m_world;
+  tList<cAnalyzeJob> m_queue;
+  int m_last_jobid;
+  cRandomMT* m_rng_pool[MT_RANDOM_POOL_SIZE];
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  Apto::ConditionVariable m_term_cond;
+  
+  volatile int m_jobs;      // count of waiting jobs, used in condition variable constructs
+  volatile int m_pending;   // count of currently executing jobs
+  
+  tArray<cWorker*> m_workers;
+  
+  
+  void singleThreadedJobExecution(cAnalyzeJob* job);
+  
+  
+  cAnalyzeLockedJobQueue(); // @not_implemented
+  cAnalyzeLockedJobQueue(const cAnalyzeLockedJobQueue&); // @not_implemented
+  cAnalyzeLockedJobQueue& operator=(const cAnalyzeLockedJobQueue&); // @not_implemented
+  
+  
+public:
+  // The RNG pool is seeded from seed rather than the world RNG
+  cAnalyzeLockedJobQueue(cWorld* world, int num_workers, int seed);
+  ~cAnalyzeLockedJobQueue();
+  
+  void AddJob(cAnalyzeJob* job);
+  
+  void Execute();
+  
+  int GetNumWorkers() const { return m_workers.GetSize(); }
+  cRandom* GetRandom(int jobid) { return m_rng_pool[jobid & MT_RANDOM_INDEX_MASK]; } 
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ *  cAnalyzeStatColumn.cc
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeStatColumn.h"
+
+#include "cAnalyzeGenotype.h"
+#include "tDataEntryCommand.h"
+
+#include <cstring>
+
+
+struct sSortEntry
+{
+  double value;
+  int row;
+};
+
+// NaN compares unequal to everything, so it is ordered explicitly to keep the sort consistent
+static inline bool isNaN(double value) { return value != value; }
+
+static int compareAscending(const void* in_a, const void* in_b)
+{
+  const sSortEntry& a = *static_cast<const sSortEntry*>(in_a);
+  const sSortEntry& b = *static_cast<const sSortEntry*>(in_b);
+  if (isNaN(a.value) != isNaN(b.value)) return isNaN(a.value) ? 1 : -1;
+  if (a.value < b.value) return -1;
+  if (a.value > b.value) return 1;
+  return a.row - b.row;
+}
+
+static int compareDescending(const void* in_a, const void* in_b)
+{
+  const sSortEntry& a = *static_cast<const sSortEntry*>(in_a);
+  const sSortEntry& b = *static_cast<const sSortEntry*>(in_b);
+  if (isNaN(a.value) != isNaN(b.value)) return isNaN(a.value) ? 1 : -1;
+  if (a.value > b.value) return -1;
+  if (a.value < b.value) return 1;
+  return a.row - b.row;
+}
+
+// Hash of the bit pattern, so that values which compare equal but print differently (0.0 and -0.0) stay apart
+static inline unsigned int hashValue(double value)
+{
+  const int num_words = sizeof(double) / sizeof(unsigned int);
+  unsigned int words[num_words];
+  memcpy(words, &value, sizeof(double));
+  unsigned int hash = 0;
+  for (int i = 0; i < num_words; i++) hash = (hash ^ words[i]) * 2654435761u;
+  return hash ^ (hash >> 16);
+}
+
+
+cAnalyzeStatColumn::cAnalyzeStatColumn(const tList<cAnalyzeGenotype>& list,
+                                       const tDataEntryCommand<cAnalyzeGenotype>& stat)
+  : m_genotypes(list.GetSize()), m_type(cFlexVar::TYPE_NONE)
+{
+  tConstListIterator<cAnalyzeGenotype> it(list);
+  cAnalyzeGenotype* genotype = NULL;
+  int row = 0;
+  while ((genotype = it.Next()) != NULL) m_genotypes[row++] = genotype;
+
+  if (m_genotypes.GetSize() == 0) return;
+
+  m_type = stat.GetValue(m_genotypes[0]).GetType();
+  if (!IsNumeric()) return;
+
+  m_values.Resize(m_genotypes.GetSize());
+  for (row = 0; row < m_genotypes.GetSize(); row++) {
+    const cFlexVar value = stat.GetValue(m_genotypes[row]);
+
+    // A stat that changes type part way through cannot be formatted from the packed values
+    if (value.GetType() != m_type) {
+      m_type = cFlexVar::TYPE_NONE;
+      m_values.Resize(0);
+      return;
+    }
+    m_values[row] = value.AsDouble();
+  }
+}
+
+
+cString cAnalyzeStatColumn::GetValueString(int row) const
+{
+  cString str;
+  if (m_type == cFlexVar::TYPE_INT) str.Set("%d", static_cast<int>(m_values[row]));
+  else str.Set("%f", m_values[row]);
+  return str;
+}
+
+
+void cAnalyzeStatColumn::Filter(double test_value, const tArray<bool>& rel_ok, tArray<bool>& keep) const
+{
+  const int num_rows = m_values.GetSize();
+  keep.Resize(num_rows);
+  for (int row = 0; row < num_rows; row++) {
+    const double value = m_values[row];
+    if (value == test_value) keep[row] = rel_ok[1];
+    else if (value > test_value) keep[row] = rel_ok[2];
+    else keep[row] = rel_ok[0];
+  }
+}
+
+
+void cAnalyzeStatColumn::GetSortOrder(tArray<int>& order, bool descending) const
+{
+  const int num_rows = m_values.GetSize();
+  tArray<sSortEntry> entries(num_rows);
+  for (int row = 0; row < num_rows; row++) {
+    entries[row].value = m_values[row];
+    entries[row].row = row;
+  }
+
+  // Rows break ties, so the result is the same whatever order qsort visits the entries in
+  entries.QSort(descending ? &compareDescending : &compareAscending);
+
+  order.Resize(num_rows);
+  for (int i = 0; i < num_rows; i++) order[i] = entries[i].row;
+}
+
+
+void cAnalyzeStatColumn::CountDistinct(const tArray<int>& weights, tArray<int>& first_rows, tArray<int>& totals) const
+{
+  const int num_rows = m_values.GetSize();
+  first_rows.Resize(num_rows);
+  totals.Resize(num_rows);
+  
+  // Open addressing table from value bit patterns to runs, kept at most half full.  Rows are visited in order, so runs
+  // are created in the order their values first appear.
+  int table_size = 16;
+  while (table_size < 2 * num_rows) table_size *= 2;
+  tArray<int> table(table_size, -1);
+  
+  int num_runs = 0;
+  for (int row = 0; row < num_rows; row++) {
+    const double value = m_values[row];
+    int bin = hashValue(value) & (table_size - 1);
+    while (table[bin] != -1 && memcmp(&m_values[first_rows[table[bin]]], &value, sizeof(double)) != 0) {
+      bin = (bin + 1) & (table_size - 1);
+    }
+    
+    if (table[bin] == -1) {
+      table[bin] = num_runs;
+      first_rows[num_runs] = row;
+      totals[num_runs] = 0;
+      num_runs++;
+    }
+    totals[table[bin]] += weights[row];
+  }
+  
+  first_rows.Resize(num_runs);
+  totals.Resize(num_runs);
+}
@@ -0,0 +1,78 @@
+/*
+ *  cAnalyzeStatColumn.h
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeStatColumn_h
+#define cAnalyzeStatColumn_h
+
+#ifndef cFlexVar_h
+#include "cFlexVar.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+#ifndef tList_h
+#include "tList.h"
+#endif
+
+class cAnalyzeGenotype;
+template <class T> class tDataEntryCommand;
+
+
+// One stat read out of every genotype in a list into a packed array of doubles, so that filtering, sorting and
+// histogram passes run over plain numbers rather than a cFlexVar per genotype.  Rows follow the order of the list.
+// Only int and double stats are packed; for anything else IsNumeric() is false, the values are left empty, and
+// callers should fall back to reading cFlexVar values.  The column does not own the genotypes.
+class cAnalyzeStatColumn
+{
+private:
+  tArray<cAnalyzeGenotype*> m_genotypes;
+  tArray<double> m_values;
+  cFlexVar::eFlexType m_type;
+
+
+  cAnalyzeStatColumn(); // @not_implemented
+  cAnalyzeStatColumn(const cAnalyzeStatColumn&); // @not_implemented
+  cAnalyzeStatColumn& operator=(const cAnalyzeStatColumn&); // @not_implemented
+
+public:
+  cAnalyzeStatColumn(const tList<cAnalyzeGenotype>& list, const tDataEntryCommand<cAnalyzeGenotype>& stat);
+
+  bool IsNumeric() const { return (m_type == cFlexVar::TYPE_INT || m_type == cFlexVar::TYPE_DOUBLE); }
+
+  int GetSize() const { return m_genotypes.GetSize(); }
+  cAnalyzeGenotype* GetGenotype(int row) const { return m_genotypes[row]; }
+  double GetValue(int row) const { return m_values[row]; }
+
+  // Formatted as cFlexVar::AsString() would format the original stat value
+  cString GetValueString(int row) const;
+
+  // Set keep[row] to rel_ok[0], rel_ok[1] or rel_ok[2] as the value is less than, equal to or greater than test_value,
+  // matching cAnalyze::CompareFlexStat against a string test value; NaN counts as less.
+  void Filter(double test_value, const tArray<bool>& rel_ok, tArray<bool>& keep) const;
+
+  // Fill order with the rows sorted by value, NaN last; equal values keep their list order
+  void GetSortOrder(tArray<int>& order, bool descending = false) const;
+
+  // Collapse the rows into distinct values (compared by bit pattern), listed in the order each first appears.
+  // first_rows holds the first row carrying each value and totals the sum of weights[row] over those rows.
+  void CountDistinct(const tArray<int>& weights, tArray<int>& first_rows, tArray<int>& totals) const;
+};
+
+#endif
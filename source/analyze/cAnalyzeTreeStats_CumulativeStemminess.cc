@@ -22,6 +22,7 @@
 
 #include "cAnalyzeGenotype.h"
 #include "tHashMap.h"
+#include "tSmartArray.h"
 #include "cWorld.h"
 
 
@@ -95,6 +96,7 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   }
   tArray<cAnalyzeGenotype *> gen_array(num_gens);
   tHashMap<int, int> id_hash;  // Store array pos for each id.
+  if (num_gens > HASH_TABLE_SIZE_DEFAULT) id_hash.SetTableSize(num_gens);
   tArray<int> id_array(num_gens), pid_array(num_gens);
   tArray<int> depth_array(num_gens), birth_array(num_gens);
 
@@ -127,8 +129,6 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   tArray<int> anc_branch_pos_array(num_gens);
   anc_branch_dist_array.SetAll(-1);
   anc_branch_pos_array.SetAll(-1);
-  bool found = true;
-  int loop_count = 0;
 
   /*
   Link each offspring to its parent. {{{4
@@ -174,49 +174,40 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Finding branch points..." << endl;
   }
-  found = true;
-  loop_count = 0;
-  while (found == true) {
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << endl << "  wave " << loop_count << "...";
-    }
-    found = false;
-
-    int genotypes_already_set = 0;
-    int genotypes_identified_as_root = 0;
-    int genotypes_with_branching_parent = 0;
-    int genotypes_with_calced_parent = 0;
-    int genotypes_not_ready = 0;
-
-    for (int pos = 0; pos < num_gens; pos++) {
-      if (m_agl[pos].anc_branch_dist > -1){
-        genotypes_already_set++;
-        continue; // continue if its set.
-      }
-      found = true;
+  // Rather than sweeping the array once per generation of depth, climb from each unset genotype to the nearest
+  // ancestor that can be set directly, then set the genotypes on the way back down.
+  tSmartArray<int> climb_path;
+  for (int start_pos = 0; start_pos < num_gens; start_pos++) {
+    int pos = start_pos;
+    while (m_agl[pos].anc_branch_dist == -1) {
       int parent_pos = m_agl[pos].ppos;
+      if (parent_pos != -1 && m_agl[parent_pos].offspring_count <= 1 && m_agl[parent_pos].anc_branch_dist == -1) {
+        // Not yet ready to calculate this entry.
+        if (climb_path.GetSize() >= num_gens) {
+          // The parent links form a cycle.
+          climb_path.Resize(0);
+          break;
+        }
+        climb_path.Push(pos);
+        pos = parent_pos;
+        continue;
+      }
+      
       if (parent_pos == -1) {
-        genotypes_identified_as_root++;
         m_agl[pos].anc_branch_dist = 0;  // Org is root.
       } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
-        genotypes_with_branching_parent++;
         m_agl[pos].anc_branch_dist = 1;
         m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
         m_agl[pos].anc_branch_pos = parent_pos;
-      } else if (m_agl[parent_pos].anc_branch_dist > -1) {     // Parent calculated.
-        genotypes_with_calced_parent++;
+      } else {                                                   // Parent calculated.
         m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
         m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
         m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
-      } else {
-        genotypes_not_ready++;
-        // Otherwise, we are not yet ready to calculate this entry.
       }
+      
+      if (climb_path.GetSize() == 0) break;
+      pos = climb_path.Pop();
     }
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << " (" << genotypes_already_set << "," << genotypes_identified_as_root << "," << genotypes_with_branching_parent << "," << genotypes_with_calced_parent << "," << genotypes_not_ready << ")" << endl;
-    }
-    loop_count++;
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -242,6 +233,7 @@ void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGeno
 
   m_agl2.Resize(branch_tree_size);  // Store agl data for each id.
   tHashMap<int, int> id_hash_2;
+  if (branch_tree_size > HASH_TABLE_SIZE_DEFAULT) id_hash_2.SetTableSize(branch_tree_size);
   int array_pos_2 = 0;
   if (true) for (int pos = 0; pos < num_gens; pos++) {
     int offs_count = m_agl[pos].offspring_count;
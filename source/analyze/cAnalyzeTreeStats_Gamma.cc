@@ -118,6 +118,7 @@ void cAnalyzeTreeStats_Gamma::MapIDToGenotypePos(
   tHashMap<int, int> &out_mapping
 ){
   out_mapping.ClearAll();
+  if (lineage.GetSize() > HASH_TABLE_SIZE_DEFAULT) out_mapping.SetTableSize(lineage.GetSize());
   for(int i = 0; i < lineage.GetSize(); i++){
     out_mapping.Set(lineage[i]->GetID(), i);
   }
@@ -22,6 +22,7 @@
 #include "cGenotypeBatch.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cRandom.h"
 #include "tSmartArray.h"
 
@@ -185,22 +186,15 @@ cAnalyzeGenotype* cGenotypeBatch::FindLastCommonAncestor()
   // i.e. have an update_died of -1.
   
   // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> it(m_list);
-  tListIterator<cAnalyzeGenotype> parent_it(m_list);
-  cAnalyzeGenotype* on_child = NULL;
-  while ((on_child = it.Next())) {
-    parent_it.Reset();
-    cAnalyzeGenotype* on_parent = NULL;
-    while ((on_parent = parent_it.Next())) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
+  cPhylogenyIndex phylogeny(m_list);
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    cAnalyzeGenotype* on_child = phylogeny.GetGenotype(pos);
+    const int parent_pos = phylogeny.FindID(on_child->GetParentID());
+    if (parent_pos >= 0) on_child->LinkParent(phylogeny.GetGenotype(parent_pos));
   }
     
   // Find the genotype without a parent (there should only be one)
-  it.Reset();
+  tListIterator<cAnalyzeGenotype> it(m_list);
   cAnalyzeGenotype* lca = NULL;
   cAnalyzeGenotype* test_lca = NULL;
   while ((test_lca = it.Next())) {
@@ -232,12 +226,17 @@ cGenotypeBatch* cGenotypeBatch::FindLineage(cAnalyzeGenotype* end_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindLineage(int end_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(end_genotype_id);
+  cPhylogenyIndex phylogeny(m_list);
+  tArray<bool> in_lineage(phylogeny.GetSize());
+  in_lineage.SetAll(false);
   
-  while ((found_gen)) {
+  int pos = phylogeny.FindID(end_genotype_id);
+  while (pos >= 0 && !in_lineage[pos]) {
+    in_lineage[pos] = true;
+    cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(pos));
     batch->m_list.Push(found_gen);
     batch->m_lineage_head = found_gen;
-    found_gen = FindGenotypeID(found_gen->GetParentID());
+    pos = phylogeny.FindID(found_gen->GetParentID());
   }
     
   return batch;
@@ -356,11 +355,14 @@ cGenotypeBatch* cGenotypeBatch::FindClade(cAnalyzeGenotype* start_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindClade(int start_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  tList<cAnalyzeGenotype> list(m_list);
+  cPhylogenyIndex phylogeny(m_list);
+  tArray<bool> in_clade(phylogeny.GetSize());
+  in_clade.SetAll(false);
   tSmartArray<int> scan_list;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(start_genotype_id);
- 
-  if ((found_gen)) {
+  
+  const int start_pos = phylogeny.FindID(start_genotype_id);
+  if (start_pos >= 0) {
+    cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(start_pos));
     batch->m_list.Push(found_gen);
     batch->m_clade_head = found_gen;
     scan_list.Push(found_gen->GetID());
@@ -369,14 +371,12 @@ cGenotypeBatch* cGenotypeBatch::FindClade(int start_genotype_id) const
   while (scan_list.GetSize()) {
     int parent_id = scan_list.Pop();
     
-    // Seach for all of the offspring of this genotype...
-    tListIterator<cAnalyzeGenotype> it(list);
-    while ((found_gen = it.Next()) != NULL) {
-      if (found_gen->GetParentID() == parent_id) {
-        it.Remove();
-        scan_list.Push(found_gen->GetID());
-        batch->m_list.Push(new cAnalyzeGenotype(*found_gen));
-      }
+    // Add all of the offspring of this genotype...
+    for (int pos = phylogeny.FindFirstChild(parent_id); pos >= 0; pos = phylogeny.GetNextSibling(pos)) {
+      if (in_clade[pos]) continue;
+      in_clade[pos] = true;
+      scan_list.Push(phylogeny.GetGenotype(pos)->GetID());
+      batch->m_list.Push(new cAnalyzeGenotype(*phylogeny.GetGenotype(pos)));
     }
   }
 
@@ -0,0 +1,249 @@
+/*
+ *  cGenotypeLoader.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenotypeLoader.h"
+
+#include "apto/core/FileSystem.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cHardwareManager.h"
+#include "cInitFile.h"
+#include "cInstSet.h"
+#include "cStringUtil.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
+#include "tDataCommandManager.h"
+#include "tDataEntryCommand.h"
+#include "tList.h"
+
+
+cGenotypeLoader::cGenotypeLoader(cWorld* world, cAnalyzeJobQueue& jobqueue)
+  : m_world(world), m_jobqueue(jobqueue), m_filetype("unknown"), m_in_data(false), m_fallback(false)
+  , m_has_first_line(false), m_id_inc(false), m_hw_type(-1), m_load_count(0)
+{
+  const cInstSet& is = m_world->GetHardwareManager().GetDefaultInstSet();
+  m_hw_type = is.GetHardwareType();
+  m_inst_set = is.GetInstSetName();
+}
+
+cGenotypeLoader::~cGenotypeLoader()
+{
+  for (int i = 0; i < m_columns.GetSize(); i++) delete m_columns[i];
+}
+
+
+bool cGenotypeLoader::ReadHeader(const cString& filename, const cString& working_dir)
+{
+  cString path = cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(working_dir)));
+  m_file.Open(path);
+  if (!m_file.IsOpen()) return false;
+
+  // Directives up to the first data line apply to the whole file, exactly as cInitFile would see them
+  m_has_first_line = readLine(m_first_line);
+  m_in_data = true;
+
+  return !m_fallback;
+}
+
+
+bool cGenotypeLoader::SetupColumns(const cStringList& format, const cStringList& columns, cUserFeedback& feedback)
+{
+  for (int i = 0; i < m_columns.GetSize(); i++) delete m_columns[i];
+  m_columns.Resize(0);
+
+  tList<tDataEntryCommand<cAnalyzeGenotype> > command_list;
+  cAnalyzeGenotype::GetDataCommandManager().LoadCommandList(format, command_list, &feedback);
+  if (feedback.GetNumErrors()) {
+    while (command_list.GetSize()) delete command_list.Pop();
+    return false;
+  }
+
+  m_columns.Resize(command_list.GetSize());
+  for (int i = 0; i < m_columns.GetSize(); i++) {
+    tDataEntryCommand<cAnalyzeGenotype>* command = command_list.Pop();
+    if (columns.GetSize() && !columns.HasString(command->GetName())) {
+      delete command;
+      command = NULL;
+    }
+    m_columns[i] = command;
+  }
+
+  // Genotypes are named by ID if it is loaded, otherwise by their position in the file
+  m_id_inc = format.HasString("id") && (columns.GetSize() == 0 || columns.HasString("id"));
+
+  return true;
+}
+
+
+bool cGenotypeLoader::LoadStream(tList<cAnalyzeGenotype>& list)
+{
+  tList<cAnalyzeGenotype> loaded;
+  m_chunk.Resize(CHUNK_LINES);
+
+  int num_lines = 0;
+  if (m_has_first_line) m_chunk[num_lines++] = m_first_line;
+  m_has_first_line = false;
+
+  while (readLine(m_chunk[num_lines])) {
+    if (++num_lines == CHUNK_LINES) {
+      parseChunk(num_lines, loaded);
+      num_lines = 0;
+    }
+  }
+  m_file.Close();
+
+  if (m_fallback) {
+    while (loaded.GetSize()) delete loaded.Pop();
+    m_chunk.Resize(0);
+    m_load_count = 0;
+    return false;
+  }
+
+  if (num_lines) parseChunk(num_lines, loaded);
+  m_chunk.Resize(0);
+
+  list.Transfer(loaded);
+  return true;
+}
+
+
+void cGenotypeLoader::LoadLines(cInitFile& file, tList<cAnalyzeGenotype>& list)
+{
+  const int total_lines = file.GetNumLines();
+  m_chunk.Resize((total_lines < CHUNK_LINES) ? total_lines : CHUNK_LINES);
+
+  int num_lines = 0;
+  for (int line_id = 0; line_id < total_lines; line_id++) {
+    m_chunk[num_lines] = file.GetLine(line_id);
+    if (++num_lines == CHUNK_LINES) {
+      parseChunk(num_lines, list);
+      num_lines = 0;
+    }
+  }
+  if (num_lines) parseChunk(num_lines, list);
+  m_chunk.Resize(0);
+}
+
+
+// Returns false if the directive can only be handled by cInitFile
+bool cGenotypeLoader::processDirective(cString directive)
+{
+  cString cmd = directive.PopWord();
+
+  if (cmd == "#include" || cmd == "#import") return false;
+
+  if (cmd == "#filetype") {
+    cString ft = directive.PopWord();
+    if (m_filetype != ft && (m_in_data || m_filetype != "unknown")) return false;
+    m_filetype = ft;
+  } else if (cmd == "#format") {
+    if (m_in_data || m_format.GetSize() != 0) return false;
+    m_format.Load(directive);
+  } else if (cmd == "#define") {
+    // Definitions only affect include paths, but an invalid one is an error in cInitFile
+    if (directive.PopWord().GetSize() == 0) return false;
+  }
+
+  return true;
+}
+
+
+// Read the next logical data line, with comments removed, whitespace compressed and continued lines joined, as
+// cInitFile would produce it.  Returns false at the end of the file, or once a directive requires cInitFile.
+bool cGenotypeLoader::readLine(cString& line)
+{
+  bool continued = false;
+  line = "";
+
+  cString buf;
+  while (!m_file.Eof() && m_file.ReadLine(buf)) {
+    if (buf.GetSize() && buf[0] == '#') {
+      if (!processDirective(buf)) {
+        m_fallback = true;
+        return false;
+      }
+      continue;
+    }
+
+    int comment_pos = buf.Find('#');
+    if (comment_pos >= 0) buf.Clip(comment_pos);
+    buf.CompressWhitespace();
+
+    if (continued) line += buf;
+    else line = buf;
+
+    continued = (line.GetSize() > 0 && line[line.GetSize() - 1] == '\\');
+    if (continued) line.ClipEnd(1);
+    else if (line.GetSize() > 0) return true;
+  }
+
+  return (line.GetSize() > 0);
+}
+
+
+void cGenotypeLoader::parseChunk(int num_lines, tList<cAnalyzeGenotype>& list)
+{
+  m_parsed.Resize(num_lines);
+
+  const int num_ranges = (num_lines + RANGE_LINES - 1) / RANGE_LINES;
+  m_ranges.Resize(num_ranges);
+
+  tAnalyzeJobBatch<cParseRange> jobbatch(m_jobqueue);
+  for (int i = 0; i < num_ranges; i++) {
+    const int end = (i + 1) * RANGE_LINES;
+    m_ranges[i].Set(this, i * RANGE_LINES, (end < num_lines) ? end : num_lines);
+    jobbatch.AddJob(&m_ranges[i], &cParseRange::Parse);
+  }
+  jobbatch.RunBatch();
+
+  for (int i = 0; i < num_lines; i++) list.PushRear(m_parsed[i]);
+  m_load_count += num_lines;
+}
+
+
+void cGenotypeLoader::cParseRange::Parse(cAvidaContext&)
+{
+  // Build the default genome from a private copy of the instruction set name, since strings are not shared safely
+  // between threads
+  Genome default_genome(m_loader->m_hw_type, cString((const char*)m_loader->m_inst_set), Sequence(1));
+
+  const tArray<tDataEntryCommand<cAnalyzeGenotype>*>& columns = m_loader->m_columns;
+  for (int line_id = m_begin; line_id < m_end; line_id++) {
+    cString& cur_line = m_loader->m_chunk[line_id];
+
+    cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_loader->m_world, default_genome);
+
+    for (int i = 0; i < columns.GetSize(); i++) {
+      cString value = cur_line.PopWord();
+      if (columns[i]) columns[i]->SetValue(genotype, value);
+    }
+
+    // Give this genotype a name.  Base it on the ID if possible.
+    if (m_loader->m_id_inc == false) {
+      genotype->SetName(cStringUtil::Stringf("org-%d", m_loader->m_load_count + line_id));
+    } else {
+      genotype->SetName(cStringUtil::Stringf("org-%d", genotype->GetID()));
+    }
+
+    m_loader->m_parsed[line_id] = genotype;
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ *  cGenotypeLoader.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGenotypeLoader_h
+#define cGenotypeLoader_h
+
+#ifndef cFile_h
+#include "cFile.h"
+#endif
+#ifndef cString_h
+#include "cString.h"
+#endif
+#ifndef cStringList_h
+#include "cStringList.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cInitFile;
+class cUserFeedback;
+class cWorld;
+template<class T> class tDataEntryCommand;
+template<class T> class tList;
+
+
+// Loader for genotype_data files (LOAD).  Files that only use the #filetype, #format and #define directives are
+// streamed from disk in chunks of lines rather than read whole, and each chunk is parsed by the analyze job queue in
+// parallel before its genotypes are appended, in file order, to the target list.  Files that rely on #include or
+// #import, or that change their format after the data has started, must be read through cInitFile; ReadHeader and
+// LoadStream report this by returning false, after which the caller hands the cInitFile to LoadLines instead.
+//
+// Only the columns named in SetupColumns are stored; the remaining columns of each line are skipped.
+class cGenotypeLoader
+{
+private:
+  static const int CHUNK_LINES = 16384;  // Lines read from the file between parallel parses
+  static const int RANGE_LINES = 1024;   // Lines parsed by each job
+
+  class cParseRange
+  {
+  private:
+    cGenotypeLoader* m_loader;
+    int m_begin;
+    int m_end;
+
+  public:
+    cParseRange() : m_loader(NULL), m_begin(0), m_end(0) { ; }
+    void Set(cGenotypeLoader* loader, int begin, int end) { m_loader = loader; m_begin = begin; m_end = end; }
+
+    void Parse(cAvidaContext& ctx);
+  };
+  friend class cParseRange;
+
+  cWorld* m_world;
+  cAnalyzeJobQueue& m_jobqueue;
+
+  // Header
+  cFile m_file;
+  cString m_filetype;
+  cStringList m_format;
+  bool m_in_data;
+  bool m_fallback;
+  cString m_first_line;
+  bool m_has_first_line;
+
+  // Columns, in file order; NULL for columns that are not loaded
+  tArray<tDataEntryCommand<cAnalyzeGenotype>*> m_columns;
+  bool m_id_inc;
+  int m_hw_type;
+  cString m_inst_set;
+
+  // Chunk being parsed
+  tArray<cString> m_chunk;
+  tArray<cAnalyzeGenotype*> m_parsed;
+  tArray<cParseRange> m_ranges;
+  int m_load_count;
+
+
+  cGenotypeLoader(); // @not_implemented
+  cGenotypeLoader(const cGenotypeLoader&); // @not_implemented
+  cGenotypeLoader& operator=(const cGenotypeLoader&); // @not_implemented
+
+public:
+  cGenotypeLoader(cWorld* world, cAnalyzeJobQueue& jobqueue);
+  ~cGenotypeLoader();
+
+  // Open the file and read the directives ahead of the first data line.  Returns false if the file cannot be streamed.
+  bool ReadHeader(const cString& filename, const cString& working_dir);
+  const cString& GetFiletype() const { return m_filetype; }
+  const cStringList& GetFormat() const { return m_format; }
+
+  // Set up the data commands for each column of the format.  If columns is non-empty only the data entries it names
+  // are loaded.  Returns false, with the errors in feedback, if the format names unknown data entries.
+  bool SetupColumns(const cStringList& format, const cStringList& columns, cUserFeedback& feedback);
+
+  // Append the genotypes in the streamed file to list.  Returns false, leaving list untouched, if the remainder of
+  // the file turns out to need cInitFile.
+  bool LoadStream(tList<cAnalyzeGenotype>& list);
+
+  // Append the genotypes in an already loaded file to list.
+  void LoadLines(cInitFile& file, tList<cAnalyzeGenotype>& list);
+
+private:
+  bool processDirective(cString directive);
+  bool readLine(cString& line);
+  void parseChunk(int num_lines, tList<cAnalyzeGenotype>& list);
+};
+
+#endif
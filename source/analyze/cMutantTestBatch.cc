@@ -0,0 +1,123 @@
+/*
+ *  cMutantTestBatch.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cMutantTestBatch.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cHardwareManager.h"
+#include "cTestCPU.h"
+#include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
+
+
+cMutantTestBatch::cMutantTestBatch(cWorld* world, cAnalyzeJobQueue& jobqueue, const Genome& base_genome)
+  : m_world(world), m_jobqueue(jobqueue), m_hw_type(base_genome.GetHardwareType())
+  , m_inst_set(base_genome.GetInstSet()), m_base_seq(base_genome.GetSequence()), m_keep_genotypes(false)
+{
+}
+
+cMutantTestBatch::~cMutantTestBatch()
+{
+  clearGenotypes();
+}
+
+
+void cMutantTestBatch::Run()
+{
+  const int num_mutants = m_mutants.GetSize();
+  clearGenotypes();
+  m_fitness.Resize(num_mutants);
+  if (m_keep_genotypes) {
+    m_genotypes.Resize(num_mutants);
+    m_genotypes.SetAll(NULL);
+  }
+
+  const int num_ranges = (num_mutants + RANGE_SIZE - 1) / RANGE_SIZE;
+  m_ranges.Resize(num_ranges);
+
+  tAnalyzeJobBatch<cMutantRange> jobbatch(m_jobqueue);
+  for (int i = 0; i < num_ranges; i++) {
+    const int end = (i + 1) * RANGE_SIZE;
+    m_ranges[i].Set(this, i * RANGE_SIZE, (end < num_mutants) ? end : num_mutants);
+    jobbatch.AddJob(&m_ranges[i], &cMutantRange::Test);
+  }
+  jobbatch.RunBatch();
+}
+
+
+void cMutantTestBatch::Clear()
+{
+  clearGenotypes();
+  m_mutants.Resize(0);
+  m_fitness.Resize(0);
+}
+
+
+int cMutantTestBatch::addMutant(int site1, int inst1, int site2, int inst2)
+{
+  sMutant mutant;
+  mutant.site1 = site1;
+  mutant.inst1 = inst1;
+  mutant.site2 = site2;
+  mutant.inst2 = inst2;
+  m_mutants.Push(mutant);
+  return m_mutants.GetSize() - 1;
+}
+
+
+void cMutantTestBatch::clearGenotypes()
+{
+  for (int i = 0; i < m_genotypes.GetSize(); i++) delete m_genotypes[i];
+  m_genotypes.Resize(0);
+}
+
+
+void cMutantTestBatch::cMutantRange::Test(cAvidaContext& ctx)
+{
+  cTestCPU* testcpu = m_batch->m_world->GetHardwareManager().CreateTestCPU(ctx);
+
+  // Work on a private genome, built from a private copy of the instruction set name since strings are not shared
+  // safely between threads
+  const Sequence& base_seq = m_batch->m_base_seq;
+  Genome mod_genome(m_batch->m_hw_type, cString((const char*)m_batch->m_inst_set), base_seq);
+  Sequence& seq = mod_genome.GetSequence();
+
+  for (int i = m_begin; i < m_end; i++) {
+    const sMutant& mutant = m_batch->m_mutants[i];
+    if (mutant.site1 >= 0) seq[mutant.site1].SetOp(mutant.inst1);
+    if (mutant.site2 >= 0) seq[mutant.site2].SetOp(mutant.inst2);
+
+    cCPUTestInfo test_info;
+    test_info.CopySettings(m_batch->m_settings);
+    cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_batch->m_world, mod_genome);
+    genotype->Recalculate(ctx, &test_info, NULL, 1, testcpu);
+
+    m_batch->m_fitness[i] = genotype->GetFitness();
+    if (m_batch->m_keep_genotypes) m_batch->m_genotypes[i] = genotype;
+    else delete genotype;
+
+    // Reset the mod_genome back to the original sequence.
+    if (mutant.site1 >= 0) seq[mutant.site1] = base_seq[mutant.site1];
+    if (mutant.site2 >= 0) seq[mutant.site2] = base_seq[mutant.site2];
+  }
+
+  delete testcpu;
+}
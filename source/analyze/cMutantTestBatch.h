@@ -0,0 +1,122 @@
+/*
+ *  cMutantTestBatch.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMutantTestBatch_h
+#define cMutantTestBatch_h
+
+#include "avida/core/Genome.h"
+
+#ifndef cCPUTestInfo_h
+#include "cCPUTestInfo.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+#ifndef tSmartArray_h
+#include "tSmartArray.h"
+#endif
+
+class cAnalyzeGenotype;
+class cAnalyzeJobQueue;
+class cAvidaContext;
+class cWorld;
+
+using namespace Avida;
+
+
+// Evaluates a set of single and double site mutants of one base genome across the analyze job queue.  Mutants are
+// queued with AddMutant (or AddReplicate for unmodified copies of the base genome) and tested together by Run, in
+// ranges that each reuse a single test CPU.  Results are indexed by the order in which the mutants were added, so
+// callers can fold them back into their serial loops unchanged.
+class cMutantTestBatch
+{
+private:
+  static const int RANGE_SIZE = 8;  // Mutants tested by each job
+
+  struct sMutant
+  {
+    int site1;
+    int inst1;
+    int site2;
+    int inst2;
+  };
+
+  class cMutantRange
+  {
+  private:
+    cMutantTestBatch* m_batch;
+    int m_begin;
+    int m_end;
+
+  public:
+    cMutantRange() : m_batch(NULL), m_begin(0), m_end(0) { ; }
+    void Set(cMutantTestBatch* batch, int begin, int end) { m_batch = batch; m_begin = begin; m_end = end; }
+
+    void Test(cAvidaContext& ctx);
+  };
+  friend class cMutantRange;
+
+  cWorld* m_world;
+  cAnalyzeJobQueue& m_jobqueue;
+  int m_hw_type;
+  cString m_inst_set;
+  Sequence m_base_seq;
+  cCPUTestInfo m_settings;
+  bool m_keep_genotypes;
+
+  tSmartArray<sMutant> m_mutants;
+  tArray<double> m_fitness;
+  tArray<cAnalyzeGenotype*> m_genotypes;
+  tArray<cMutantRange> m_ranges;
+
+
+  cMutantTestBatch(); // @not_implemented
+  cMutantTestBatch(const cMutantTestBatch&); // @not_implemented
+  cMutantTestBatch& operator=(const cMutantTestBatch&); // @not_implemented
+
+public:
+  cMutantTestBatch(cWorld* world, cAnalyzeJobQueue& jobqueue, const Genome& base_genome);
+  ~cMutantTestBatch();
+
+  // Test settings (inputs, resources) to use for every mutant; only the settings of test_info are copied
+  void SetTestSettings(const cCPUTestInfo& test_info) { m_settings.CopySettings(test_info); }
+
+  // Keep the recalculated genotype of each mutant, rather than just its fitness
+  void KeepGenotypes(bool keep = true) { m_keep_genotypes = keep; }
+
+  int AddReplicate() { return addMutant(-1, 0, -1, 0); }
+  int AddMutant(int site, int inst) { return addMutant(site, inst, -1, 0); }
+  int AddMutant(int site1, int inst1, int site2, int inst2) { return addMutant(site1, inst1, site2, inst2); }
+  int GetNumMutants() const { return m_mutants.GetSize(); }
+
+  void Run();
+
+  double GetFitness(int mutant) const { return m_fitness[mutant]; }
+  cAnalyzeGenotype& GetGenotype(int mutant) { return *m_genotypes[mutant]; }
+
+  // Remove all mutants and results, keeping the base genome and settings
+  void Clear();
+
+private:
+  int addMutant(int site1, int inst1, int site2, int inst2);
+  void clearGenotypes();
+};
+
+#endif
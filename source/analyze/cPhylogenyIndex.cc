@@ -0,0 +1,70 @@
+/*
+ *  cPhylogenyIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhylogenyIndex.h"
+
+#include "cAnalyzeGenotype.h"
+
+
+cPhylogenyIndex::cPhylogenyIndex(const tList<cAnalyzeGenotype>& list)
+  : m_genotypes(list.GetSize()), m_next_sibling(list.GetSize())
+{
+  const int num_gens = list.GetSize();
+  
+  // Size the tables to the batch, since the default is meant for small maps
+  if (num_gens > HASH_TABLE_SIZE_DEFAULT) {
+    m_id_pos.SetTableSize(num_gens);
+    m_first_child.SetTableSize(num_gens);
+  }
+  
+  tConstListIterator<cAnalyzeGenotype> it(list);
+  cAnalyzeGenotype* genotype = NULL;
+  int pos = 0;
+  while ((genotype = it.Next()) != NULL) {
+    m_genotypes[pos] = genotype;
+    if (!m_id_pos.HasEntry(genotype->GetID())) m_id_pos.Set(genotype->GetID(), pos);
+    pos++;
+  }
+  
+  // Thread the children of each parent ID in list order, by linking back to front
+  for (pos = num_gens - 1; pos >= 0; pos--) {
+    const int parent_id = m_genotypes[pos]->GetParentID();
+    int next = -1;
+    m_first_child.Find(parent_id, next);
+    m_next_sibling[pos] = next;
+    m_first_child.Set(parent_id, pos);
+  }
+}
+
+
+int cPhylogenyIndex::FindID(int id) const
+{
+  int pos = -1;
+  m_id_pos.Find(id, pos);
+  return pos;
+}
+
+
+int cPhylogenyIndex::FindFirstChild(int parent_id) const
+{
+  int pos = -1;
+  m_first_child.Find(parent_id, pos);
+  return pos;
+}
@@ -0,0 +1,66 @@
+/*
+ *  cPhylogenyIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhylogenyIndex_h
+#define cPhylogenyIndex_h
+
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+#ifndef tHashMap_h
+#include "tHashMap.h"
+#endif
+#ifndef tList_h
+#include "tList.h"
+#endif
+
+class cAnalyzeGenotype;
+
+
+// Snapshot index over a list of genotypes, giving constant time lookup by ID and by parent ID so that lineage and
+// clade traversals are linear in the size of the batch.  Positions follow the order of the list; where several
+// genotypes share an ID, FindID returns the first, matching a front to back scan of the list.  The index does not
+// own the genotypes and must be rebuilt once the list changes.
+class cPhylogenyIndex
+{
+private:
+  tArray<cAnalyzeGenotype*> m_genotypes;
+  tHashMap<int, int> m_id_pos;        // ID -> first position holding it
+  tHashMap<int, int> m_first_child;   // parent ID -> first position whose parent ID it is
+  tArray<int> m_next_sibling;         // position -> next position with the same parent ID
+
+
+  cPhylogenyIndex(); // @not_implemented
+  cPhylogenyIndex(const cPhylogenyIndex&); // @not_implemented
+  cPhylogenyIndex& operator=(const cPhylogenyIndex&); // @not_implemented
+
+public:
+  cPhylogenyIndex(const tList<cAnalyzeGenotype>& list);
+
+  int GetSize() const { return m_genotypes.GetSize(); }
+  cAnalyzeGenotype* GetGenotype(int pos) const { return m_genotypes[pos]; }
+
+  // Return -1 if there is no such genotype
+  int FindID(int id) const;
+  int FindFirstChild(int parent_id) const;
+  int GetNextSibling(int pos) const { return m_next_sibling[pos]; }
+};
+
+#endif
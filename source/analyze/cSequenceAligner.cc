@@ -0,0 +1,510 @@
+/*
+ *  cSequenceAligner.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cSequenceAligner.h"
+
+#include "avida/core/Sequence.h"
+
+#include "cAnalyzeJobQueue.h"
+#include "tAnalyzeJobBatch.h"
+
+
+// Traceback of an alignment, two bits per cell of the dynamic programming chart, so that only two rows of scores
+// need to be kept.  Cells start out as MATCH (the diagonal), so only the other moves need to be set.
+class cAlignmentTrace
+{
+public:
+  enum { MATCH = 0, MUTATION, INSERTION, DELETION };
+
+private:
+  int m_cols;
+  tArray<unsigned char> m_cells;
+
+public:
+  cAlignmentTrace(int rows, int cols) : m_cols(cols), m_cells((rows * cols + 3) / 4) { m_cells.SetAll(0); }
+
+  inline void Set(int row, int col, int move)
+  {
+    const int cell = row * m_cols + col;
+    m_cells[cell >> 2] |= (move << ((cell & 3) << 1));
+  }
+
+  inline int Get(int row, int col) const
+  {
+    const int cell = row * m_cols + col;
+    return (m_cells[cell >> 2] >> ((cell & 3) << 1)) & 0x3;
+  }
+
+  // Walk back from the bottom right corner, storing the moves of the alignment in order.  Returns the number of
+  // columns in the alignment.
+  int GetMoves(int rows, tArray<char>& moves) const
+  {
+    int pos1 = m_cols - 1;
+    int pos2 = rows - 1;
+    tArray<char> reversed(pos1 + pos2);
+    int num_moves = 0;
+    while (pos1 > 0 || pos2 > 0) {
+      const int move = Get(pos2, pos1);
+      reversed[num_moves++] = move;
+      if (move != DELETION) pos1--;
+      if (move != INSERTION) pos2--;
+    }
+
+    moves.ResizeClear(num_moves);
+    for (int i = 0; i < num_moves; i++) moves[i] = reversed[num_moves - i - 1];
+    return num_moves;
+  }
+};
+
+
+// Symbol frequencies in each column of a set of aligned rows, with gaps counted as a symbol.  Columns are stored
+// sparsely since most hold only one or two distinct instructions.
+class cAlignmentProfile
+{
+private:
+  tArray<int> m_col_start;  // First symbol of each column; the final entry is the total number of symbols
+  tSmartArray<char> m_symbols;
+  tSmartArray<double> m_freqs;
+  tArray<double> m_gap_freqs;
+
+public:
+  cAlignmentProfile(const tArray<tArray<char> >& rows, const tArray<int>& members, char gap)
+  {
+    const int num_rows = members.GetSize();
+    const int num_cols = rows[members[0]].GetSize();
+    m_col_start.ResizeClear(num_cols + 1);
+    m_gap_freqs.ResizeClear(num_cols);
+
+    int counts[256];
+    for (int i = 0; i < 256; i++) counts[i] = 0;
+    tArray<unsigned char> seen(num_rows);
+
+    for (int col = 0; col < num_cols; col++) {
+      int num_seen = 0;
+      for (int row = 0; row < num_rows; row++) {
+        const unsigned char symbol = rows[members[row]][col];
+        if (counts[symbol]++ == 0) seen[num_seen++] = symbol;
+      }
+
+      m_col_start[col] = m_symbols.GetSize();
+      m_gap_freqs[col] = static_cast<double>(counts[static_cast<unsigned char>(gap)]) / num_rows;
+      for (int i = 0; i < num_seen; i++) {
+        m_symbols.Push(seen[i]);
+        m_freqs.Push(static_cast<double>(counts[seen[i]]) / num_rows);
+        counts[seen[i]] = 0;
+      }
+    }
+    m_col_start[num_cols] = m_symbols.GetSize();
+  }
+
+  int GetNumCols() const { return m_gap_freqs.GetSize(); }
+
+  // Fraction of the pairs of rows that differ when a column of this profile is placed against a gap
+  double GapCost(int col) const { return 1.0 - m_gap_freqs[col]; }
+
+  // Fraction of the pairs of rows that differ when a column of this profile is placed against one of other
+  double MatchCost(int col, const cAlignmentProfile& other, int other_col) const
+  {
+    double same = 0.0;
+    for (int i = m_col_start[col]; i < m_col_start[col + 1]; i++) {
+      for (int j = other.m_col_start[other_col]; j < other.m_col_start[other_col + 1]; j++) {
+        if (m_symbols[i] == other.m_symbols[j]) same += m_freqs[i] * other.m_freqs[j];
+      }
+    }
+    return 1.0 - same;
+  }
+};
+
+
+void cSequenceAligner::AddSequence(const Sequence& seq)
+{
+  tArray<char> symbols(seq.GetSize());
+  for (int i = 0; i < seq.GetSize(); i++) symbols[i] = seq[i].GetSymbol();
+  m_seqs.Push(symbols);
+}
+
+
+// Each sequence is aligned against the one before it, and every site it inserts opens a gap column in all of the
+// earlier sequences.  Rather than inserting those gaps one at a time, the columns opened by each step are recorded
+// and the final column of every site is found in a single backwards pass over the steps.
+//
+// An empty sequence is aligned like any other, as a row made up entirely of gaps, and the sequence after it is aligned
+// against that row.  ALIGN used to skip any step involving an empty sequence, leaving both it and its successor
+// unaligned with the rest of the lineage.
+void cSequenceAligner::AlignLineage()
+{
+  const int num_seqs = m_seqs.GetSize();
+  m_aligned.ResizeClear(num_seqs);
+  if (num_seqs == 0) return;
+
+  tArray<tArray<char> > rows(num_seqs);     // Each sequence with the gaps opened when it was aligned
+  tArray<tArray<int> > gap_cols(num_seqs);  // Columns each step opened in all of the earlier sequences
+  rows[0] = m_seqs[0];
+  for (int i = 1; i < num_seqs; i++) alignToPrevious(m_seqs[i], rows[i - 1], rows[i], gap_cols[i]);
+
+  // col_map holds the final column of each column as it stood after step i
+  const int num_cols = rows[num_seqs - 1].GetSize();
+  tArray<int> col_map(num_cols);
+  for (int col = 0; col < num_cols; col++) col_map[col] = col;
+
+  tArray<int> prev_map;
+  for (int i = num_seqs - 1; i >= 0; i--) {
+    const tArray<char>& row = rows[i];
+    tArray<char>& aligned = m_aligned[i];
+    aligned.ResizeClear(num_cols);
+    for (int col = 0; col < num_cols; col++) aligned[col] = GAP;
+    for (int col = 0; col < row.GetSize(); col++) aligned[col_map[col]] = row[col];
+
+    if (i == 0) break;
+
+    // The columns before step i are those that step i did not open
+    const tArray<int>& opened = gap_cols[i];
+    prev_map.ResizeClear(col_map.GetSize() - opened.GetSize());
+    int next_opened = 0;
+    int prev_col = 0;
+    for (int col = 0; col < col_map.GetSize(); col++) {
+      if (next_opened < opened.GetSize() && opened[next_opened] == col) next_opened++;
+      else prev_map[prev_col++] = col_map[col];
+    }
+    col_map = prev_map;
+  }
+}
+
+
+// Scores are those of cStringUtil::EditDistance, which ALIGN has always used, so that lineage alignments do not
+// change: skipping over a gap already in prev is free, and placing a site against one costs slightly less than a
+// mutation.
+void cSequenceAligner::alignToPrevious(const tArray<char>& cur, const tArray<char>& prev, tArray<char>& row,
+                                       tArray<int>& gap_cols)
+{
+  const int size1 = cur.GetSize();
+  const int size2 = prev.GetSize();
+
+  cAlignmentTrace trace(size2 + 1, size1 + 1);
+  for (int j = 1; j <= size1; j++) trace.Set(0, j, cAlignmentTrace::INSERTION);
+  for (int i = 1; i <= size2; i++) trace.Set(i, 0, cAlignmentTrace::DELETION);
+
+  double* cur_dist = new double[size1 + 1];
+  double* prev_dist = new double[size1 + 1];
+  for (int j = 0; j <= size1; j++) prev_dist[j] = (double) j;
+
+  for (int i = 0; i < size2; i++) {
+    cur_dist[0] = (double) (i + 1);
+    for (int j = 0; j < size1; j++) {
+      // If the values are equal, keep the value in the upper left.
+      if (cur[j] == prev[i]) {
+        cur_dist[j + 1] = prev_dist[j];
+        continue;
+      }
+
+      double mut_dist = prev_dist[j] + 1;
+      if ((cur[j] == GAP) || (prev[i] == GAP)) mut_dist -= 0.0001;
+      const double ins_dist = cur_dist[j] + (cur[j] != GAP);
+      const double del_dist = prev_dist[j + 1] + (prev[i] != GAP);
+
+      if (mut_dist < ins_dist && mut_dist < del_dist) {
+        cur_dist[j + 1] = mut_dist;
+        trace.Set(i + 1, j + 1, cAlignmentTrace::MUTATION);
+      } else if (ins_dist < del_dist) {
+        cur_dist[j + 1] = ins_dist;
+        trace.Set(i + 1, j + 1, cAlignmentTrace::INSERTION);
+      } else {
+        cur_dist[j + 1] = del_dist;
+        trace.Set(i + 1, j + 1, cAlignmentTrace::DELETION);
+      }
+    }
+
+    double* temp_dist = cur_dist;
+    cur_dist = prev_dist;
+    prev_dist = temp_dist;
+  }
+
+  delete [] cur_dist;
+  delete [] prev_dist;
+
+  tArray<char> moves;
+  const int num_cols = trace.GetMoves(size2 + 1, moves);
+
+  int num_ins = 0;
+  for (int col = 0; col < num_cols; col++) if (moves[col] == cAlignmentTrace::INSERTION) num_ins++;
+
+  row.ResizeClear(num_cols);
+  gap_cols.ResizeClear(num_ins);
+  int pos1 = 0;
+  num_ins = 0;
+  for (int col = 0; col < num_cols; col++) {
+    if (moves[col] == cAlignmentTrace::DELETION) {
+      row[col] = GAP;
+      continue;
+    }
+    if (moves[col] == cAlignmentTrace::INSERTION) gap_cols[num_ins++] = col;
+    row[col] = cur[pos1++];
+  }
+}
+
+
+void cSequenceAligner::AlignProgressive()
+{
+  const int num_seqs = m_seqs.GetSize();
+  m_aligned.ResizeClear(num_seqs);
+  for (int i = 0; i < num_seqs; i++) m_aligned[i] = m_seqs[i];
+  if (num_seqs < 2) return;
+
+  m_dist.ResizeClear(num_seqs, num_seqs);
+  m_jobs.ResizeClear(num_seqs);
+
+  tAnalyzeJobBatch<cAlignJob> dist_batch(m_jobqueue);
+  for (int i = 0; i < num_seqs; i++) {
+    m_jobs[i].Set(this, i);
+    dist_batch.AddJob(&m_jobs[i], &cAlignJob::FindDistances);
+  }
+  dist_batch.RunBatch();
+
+  buildGuideTree();
+
+  // Each level only depends on the levels below it, and its nodes cover disjoint sets of sequences
+  const int max_level = m_nodes[m_nodes.GetSize() - 1].level;
+  for (int level = 1; level <= max_level; level++) {
+    tAnalyzeJobBatch<cAlignJob> merge_batch(m_jobqueue);
+    int num_jobs = 0;
+    for (int node = num_seqs; node < m_nodes.GetSize(); node++) {
+      if (m_nodes[node].level != level) continue;
+      m_jobs[num_jobs].Set(this, node);
+      merge_batch.AddJob(&m_jobs[num_jobs++], &cAlignJob::MergeNode);
+    }
+    merge_batch.RunBatch();
+  }
+
+  m_dist.ResizeClear(1, 1);
+  m_nodes.ResizeClear(0);
+  m_jobs.ResizeClear(0);
+}
+
+
+cString cSequenceAligner::GetAlignedSequence(int seq) const
+{
+  const tArray<char>& aligned = m_aligned[seq];
+  cString out_string(aligned.GetSize());
+  for (int i = 0; i < aligned.GetSize(); i++) out_string[i] = aligned[i];
+  return out_string;
+}
+
+
+void cSequenceAligner::findDistances(int seq)
+{
+  for (int other = seq + 1; other < m_seqs.GetSize(); other++) {
+    const double dist = editDistance(m_seqs[seq], m_seqs[other]);
+    m_dist(seq, other) = dist;
+    m_dist(other, seq) = dist;
+  }
+}
+
+
+// UPGMA over the pairwise distances.  Each cluster keeps the slot of the distance matrix of its lowest numbered
+// sequence, and the nearest other cluster of every slot is cached so that each merge only rescans the slots whose
+// nearest cluster was merged away.
+void cSequenceAligner::buildGuideTree()
+{
+  const int num_seqs = m_seqs.GetSize();
+  m_nodes.ResizeClear(2 * num_seqs - 1);
+
+  tArray<int> clusters(num_seqs);  // Node held in each slot; -1 once the slot has been merged away
+  tArray<int> nearest(num_seqs);
+  for (int i = 0; i < num_seqs; i++) {
+    sGuideNode& leaf = m_nodes[i];
+    leaf.left = -1;
+    leaf.right = -1;
+    leaf.size = 1;
+    leaf.level = 0;
+    leaf.members.ResizeClear(1);
+    leaf.members[0] = i;
+    clusters[i] = i;
+  }
+  for (int i = 0; i < num_seqs; i++) nearest[i] = findNearest(clusters, i);
+
+  for (int node = num_seqs; node < m_nodes.GetSize(); node++) {
+    int slot1 = -1;
+    for (int i = 0; i < num_seqs; i++) {
+      if (clusters[i] < 0) continue;
+      if (slot1 < 0 || m_dist(i, nearest[i]) < m_dist(slot1, nearest[slot1])) slot1 = i;
+    }
+    int slot2 = nearest[slot1];
+    if (slot2 < slot1) {
+      const int temp_slot = slot1;
+      slot1 = slot2;
+      slot2 = temp_slot;
+    }
+
+    const sGuideNode& left = m_nodes[clusters[slot1]];
+    const sGuideNode& right = m_nodes[clusters[slot2]];
+    sGuideNode& merged = m_nodes[node];
+    merged.left = clusters[slot1];
+    merged.right = clusters[slot2];
+    merged.size = left.size + right.size;
+    merged.level = ((left.level > right.level) ? left.level : right.level) + 1;
+
+    // Average linkage to the merged cluster, which takes over slot1
+    for (int i = 0; i < num_seqs; i++) {
+      if (clusters[i] < 0 || i == slot1 || i == slot2) continue;
+      const double dist = (left.size * m_dist(slot1, i) + right.size * m_dist(slot2, i)) / merged.size;
+      m_dist(slot1, i) = dist;
+      m_dist(i, slot1) = dist;
+    }
+    clusters[slot1] = node;
+    clusters[slot2] = -1;
+
+    for (int i = 0; i < num_seqs; i++) {
+      if (clusters[i] < 0) continue;
+      if (i == slot1 || nearest[i] == slot1 || nearest[i] == slot2) nearest[i] = findNearest(clusters, i);
+      else if (m_dist(i, slot1) < m_dist(i, nearest[i])) nearest[i] = slot1;
+    }
+  }
+}
+
+
+int cSequenceAligner::findNearest(const tArray<int>& clusters, int slot) const
+{
+  int nearest = -1;
+  for (int i = 0; i < clusters.GetSize(); i++) {
+    if (clusters[i] < 0 || i == slot) continue;
+    if (nearest < 0 || m_dist(slot, i) < m_dist(slot, nearest)) nearest = i;
+  }
+  return nearest;
+}
+
+
+// Align the profiles of the two children of node.  Columns are scored by the fraction of pairs of rows that would
+// differ, counting gaps as a symbol, and ties prefer placing columns together over opening gaps.
+void cSequenceAligner::mergeNode(int node)
+{
+  sGuideNode& merged = m_nodes[node];
+  const sGuideNode& left = m_nodes[merged.left];
+  const sGuideNode& right = m_nodes[merged.right];
+
+  const cAlignmentProfile profile1(m_aligned, left.members, GAP);
+  const cAlignmentProfile profile2(m_aligned, right.members, GAP);
+  const int size1 = profile1.GetNumCols();
+  const int size2 = profile2.GetNumCols();
+
+  cAlignmentTrace trace(size2 + 1, size1 + 1);
+  for (int j = 1; j <= size1; j++) trace.Set(0, j, cAlignmentTrace::INSERTION);
+  for (int i = 1; i <= size2; i++) trace.Set(i, 0, cAlignmentTrace::DELETION);
+
+  double* cur_dist = new double[size1 + 1];
+  double* prev_dist = new double[size1 + 1];
+  prev_dist[0] = 0.0;
+  for (int j = 0; j < size1; j++) prev_dist[j + 1] = prev_dist[j] + profile1.GapCost(j);
+
+  for (int i = 0; i < size2; i++) {
+    const double gap_cost2 = profile2.GapCost(i);
+    cur_dist[0] = prev_dist[0] + gap_cost2;
+    for (int j = 0; j < size1; j++) {
+      const double mut_dist = prev_dist[j] + profile1.MatchCost(j, profile2, i);
+      const double ins_dist = cur_dist[j] + profile1.GapCost(j);
+      const double del_dist = prev_dist[j + 1] + gap_cost2;
+
+      if (mut_dist <= ins_dist && mut_dist <= del_dist) {
+        cur_dist[j + 1] = mut_dist;
+      } else if (ins_dist <= del_dist) {
+        cur_dist[j + 1] = ins_dist;
+        trace.Set(i + 1, j + 1, cAlignmentTrace::INSERTION);
+      } else {
+        cur_dist[j + 1] = del_dist;
+        trace.Set(i + 1, j + 1, cAlignmentTrace::DELETION);
+      }
+    }
+
+    double* temp_dist = cur_dist;
+    cur_dist = prev_dist;
+    prev_dist = temp_dist;
+  }
+
+  delete [] cur_dist;
+  delete [] prev_dist;
+
+  tArray<char> moves;
+  const int num_cols = trace.GetMoves(size2 + 1, moves);
+
+  // Rebuild the rows of both children in the merged columns
+  tArray<char> row(num_cols);
+  for (int m = 0; m < left.members.GetSize(); m++) {
+    tArray<char>& aligned = m_aligned[left.members[m]];
+    int pos = 0;
+    for (int col = 0; col < num_cols; col++) row[col] = (moves[col] == cAlignmentTrace::DELETION) ? GAP : aligned[pos++];
+    aligned = row;
+  }
+  for (int m = 0; m < right.members.GetSize(); m++) {
+    tArray<char>& aligned = m_aligned[right.members[m]];
+    int pos = 0;
+    for (int col = 0; col < num_cols; col++) row[col] = (moves[col] == cAlignmentTrace::INSERTION) ? GAP : aligned[pos++];
+    aligned = row;
+  }
+
+  merged.members = left.members + right.members;
+}
+
+
+// As Sequence::FindEditDistance, over instruction symbols
+int cSequenceAligner::editDistance(const tArray<char>& seq1, const tArray<char>& seq2)
+{
+  const int size1 = seq1.GetSize();
+  const int size2 = seq2.GetSize();
+  const int min_size = (size1 < size2) ? size1 : size2;
+
+  // If either size is zero, the distance is the other one
+  if (!min_size) return size1 + size2;
+
+  // Matching sites at the front and end do not add to the distance
+  int match_front = 0, match_end = 0;
+  while (match_front < min_size && seq1[match_front] == seq2[match_front]) match_front++;
+  while (match_end < min_size - match_front && seq1[size1 - match_end - 1] == seq2[size2 - match_end - 1]) match_end++;
+
+  const int test_size1 = size1 - match_front - match_end;
+  const int test_size2 = size2 - match_front - match_end;
+  if (!test_size1 || !test_size2) return test_size1 + test_size2;
+
+  int* cur_row = new int[test_size1 + 1];
+  int* prev_row = new int[test_size1 + 1];
+  for (int j = 0; j <= test_size1; j++) prev_row[j] = j;
+
+  for (int i = 0; i < test_size2; i++) {
+    const char site2 = seq2[match_front + i];
+    cur_row[0] = i + 1;
+    for (int j = 0; j < test_size1; j++) {
+      if (seq1[match_front + j] == site2) {
+        cur_row[j + 1] = prev_row[j];
+      } else {
+        int best = (prev_row[j] < prev_row[j + 1]) ? prev_row[j] : prev_row[j + 1];
+        if (cur_row[j] < best) best = cur_row[j];
+        cur_row[j + 1] = best + 1;
+      }
+    }
+
+    int* temp_row = cur_row;
+    cur_row = prev_row;
+    prev_row = temp_row;
+  }
+
+  const int dist = prev_row[test_size1];
+  delete [] cur_row;
+  delete [] prev_row;
+
+  return dist;
+}
@@ -0,0 +1,117 @@
+/*
+ *  cSequenceAligner.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cSequenceAligner_h
+#define cSequenceAligner_h
+
+#ifndef cString_h
+#include "cString.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+#ifndef tMatrix_h
+#include "tMatrix.h"
+#endif
+#ifndef tSmartArray_h
+#include "tSmartArray.h"
+#endif
+
+namespace Avida {
+  class Sequence;
+};
+
+class cAnalyzeJobQueue;
+class cAvidaContext;
+
+using namespace Avida;
+
+
+// Multiple alignment of genome sequences, in the instruction symbols used by the alignment data entry with '_' marking
+// gaps.  AlignLineage aligns each sequence against the aligned sequence before it, as ALIGN always has, which is only
+// meaningful for consecutive lineages.  AlignProgressive handles arbitrary sets of sequences: it builds a UPGMA guide
+// tree from the pairwise edit distances and aligns column profiles up the tree.  The pairwise distances, and the
+// independent merges at each level of the tree, are spread across the analyze job queue.
+class cSequenceAligner
+{
+private:
+  static const char GAP = '_';
+
+  struct sGuideNode
+  {
+    int left;             // Child nodes; -1 for sequences
+    int right;
+    int size;             // Number of sequences below this node
+    int level;            // Merges needed to build this node; nodes on the same level are aligned in parallel
+    tArray<int> members;  // Sequences below this node, in the order their rows are stacked
+  };
+
+  class cAlignJob
+  {
+  private:
+    cSequenceAligner* m_aligner;
+    int m_index;
+
+  public:
+    cAlignJob() : m_aligner(NULL), m_index(0) { ; }
+    void Set(cSequenceAligner* aligner, int index) { m_aligner = aligner; m_index = index; }
+
+    void FindDistances(cAvidaContext& ctx) { m_aligner->findDistances(m_index); }
+    void MergeNode(cAvidaContext& ctx) { m_aligner->mergeNode(m_index); }
+  };
+  friend class cAlignJob;
+
+  cAnalyzeJobQueue& m_jobqueue;
+  tSmartArray<tArray<char> > m_seqs;
+  tArray<tArray<char> > m_aligned;
+
+  // Progressive alignment
+  tMatrix<double> m_dist;
+  tArray<sGuideNode> m_nodes;
+  tArray<cAlignJob> m_jobs;
+
+
+  cSequenceAligner(); // @not_implemented
+  cSequenceAligner(const cSequenceAligner&); // @not_implemented
+  cSequenceAligner& operator=(const cSequenceAligner&); // @not_implemented
+
+public:
+  cSequenceAligner(cAnalyzeJobQueue& jobqueue) : m_jobqueue(jobqueue) { ; }
+
+  void AddSequence(const Sequence& seq);
+  int GetNumSequences() const { return m_seqs.GetSize(); }
+
+  void AlignLineage();
+  void AlignProgressive();
+
+  cString GetAlignedSequence(int seq) const;
+
+private:
+  void alignToPrevious(const tArray<char>& cur, const tArray<char>& prev, tArray<char>& row, tArray<int>& gap_cols);
+
+  void findDistances(int seq);
+  void buildGuideTree();
+  int findNearest(const tArray<int>& clusters, int slot) const;
+  void mergeNode(int node);
+
+  static int editDistance(const tArray<char>& seq1, const tArray<char>& seq2);
+};
+
+#endif
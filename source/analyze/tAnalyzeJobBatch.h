@@ -23,6 +23,7 @@
 #define tAnalyzeJobBatch_h
 
 #include "apto/core.h"
+#include "apto/core/Atomic.h"
 #include "apto/platform.h"
 
 #include "cAnalyzeJobQueue.h"
@@ -44,7 +45,8 @@ protected:
 protected:
   cAnalyzeJobQueue& m_queue;
   
-  int m_jobs;
+  tSmartArray<cAnalyzeJob*> m_batch_jobs;  // jobs collected for submission as a single block
+  volatile int m_jobs;                     // outstanding jobs, updated atomically by the workers
   
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
@@ -55,17 +57,18 @@ public:
   
   void AddJob(JobClass* target, void (JobClass::*funJ)(cAvidaContext&))
   {
-    m_mutex.Lock();
-    m_jobs++;
-    m_mutex.Unlock();
-    m_queue.AddJob(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
+    m_batch_jobs.Push(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
   }
   
   void RunBatch()
   {
+    Apto::Atomic::Add(&m_jobs, m_batch_jobs.GetSize());
+    m_queue.AddJobs(m_batch_jobs);
+    m_batch_jobs.Resize(0);
+    
     m_queue.Start();
     m_mutex.Lock();
-    while (m_jobs > 0) {
+    while (Apto::Atomic::Get(&m_jobs) > 0) {
       m_cond.Wait(m_mutex);
     }
     m_mutex.Unlock();
@@ -85,10 +88,12 @@ protected:
     {
       tAnalyzeJob<T>::Run(ctx);
       
-      m_batch->m_mutex.Lock();
-      m_batch->m_jobs--;
-      m_batch->m_mutex.Unlock();
-      m_batch->m_cond.Signal();
+      if (Apto::Atomic::DecAndTest(&m_batch->m_jobs)) {
+        // Signal under the lock so that RunBatch() cannot miss the wakeup or return before the signal is sent
+        m_batch->m_mutex.Lock();
+        m_batch->m_cond.Signal();
+        m_batch->m_mutex.Unlock();
+      }
     }
   };
 };
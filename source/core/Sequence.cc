@@ -28,6 +28,12 @@
 
 #include "cInstSet.h"
 
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace AvidaTools;
 
 
@@ -36,10 +42,71 @@ const double MEMORY_INCREASE_FACTOR = 1.5;
 const double MEMORY_SHRINK_TEST_FACTOR = 4.0;
 
 
+// Bulk site comparison.  Instructions are single bytes, so runs of sites are compared as raw bytes, sixteen at a
+// time where SSE2 is available (always the case on x86-64).  The tail, and other architectures, use byte loops
+// that the compiler is free to vectorize.
+namespace {
+  inline const unsigned char* siteBytes(const cInstruction* sites)
+  {
+    assert(sizeof(cInstruction) == 1);
+    return reinterpret_cast<const unsigned char*>(sites);
+  }
+  
+#ifdef __SSE2__
+  inline int countBits16(int mask)
+  {
+#ifdef __GNUC__
+    return __builtin_popcount(mask);
+#else
+    int count = 0;
+    for (; mask; mask &= mask - 1) count++;
+    return count;
+#endif
+  }
+#endif
+  
+  // Number of positions at which the two runs of n sites differ
+  int countMismatches(const cInstruction* sites1, const cInstruction* sites2, int n)
+  {
+    const unsigned char* a = siteBytes(sites1);
+    const unsigned char* b = siteBytes(sites2);
+    int count = 0;
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+      const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      count += 16 - countBits16(_mm_movemask_epi8(eq));
+    }
+#endif
+    for (; i < n; i++) count += (a[i] != b[i]);
+    return count;
+  }
+  
+  // Number of the n sites that hold the given instruction
+  int countOccurrences(const cInstruction* sites, const cInstruction& inst, int n)
+  {
+    const unsigned char* a = siteBytes(sites);
+    const unsigned char op = static_cast<unsigned char>(inst.GetOp());
+    int count = 0;
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i target = _mm_set1_epi8(static_cast<char>(op));
+    for (; i + 16 <= n; i += 16) {
+      const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), target);
+      count += countBits16(_mm_movemask_epi8(eq));
+    }
+#endif
+    for (; i < n; i++) count += (a[i] == op);
+    return count;
+  }
+};
+
+
 Avida::Sequence::Sequence(const Sequence& seq)
   : m_seq(seq.GetSize()), m_active_size(seq.GetSize()), m_mutation_steps(seq.GetMutationSteps())
 {
-  for (int i = 0; i < m_active_size; i++)  m_seq[i] = seq[i];
+  if (m_active_size) memcpy(m_seq.begin(), seq.m_seq.begin(), m_active_size * sizeof(cInstruction));
 }
 
 Avida::Sequence::Sequence(const cString & str)
@@ -90,7 +157,20 @@ void Avida::Sequence::prepareInsert(int pos, int num_sites)
   adjustCapacity(new_size);
   
   // Shift any sites needed...
-  for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
+  if (old_size > pos) memmove(m_seq.begin() + pos + num_sites, m_seq.begin() + pos, (old_size - pos) * sizeof(cInstruction));
+}
+
+
+// Moves the last n sites to the front of the sequence, in place
+void Avida::Sequence::rotateSites(int n)
+{
+  assert(n > 0 && n < m_active_size);
+  
+  cInstruction* seq = m_seq.begin();
+  tArray<cInstruction> head(n);
+  memcpy(head.begin(), seq + m_active_size - n, n * sizeof(cInstruction));
+  memmove(seq + n, seq, (m_active_size - n) * sizeof(cInstruction));
+  memcpy(seq, head.begin(), n * sizeof(cInstruction));
 }
 
 
@@ -119,7 +199,7 @@ void Avida::Sequence::Resize(int new_size)
   const int old_size = m_active_size;
   adjustCapacity(new_size);
   
-  for (int i = old_size; i < new_size; i++) m_seq[i].SetOp(0);
+  if (new_size > old_size) memset(m_seq.begin() + old_size, 0, (new_size - old_size) * sizeof(cInstruction));
 }
 
 void Avida::Sequence::Insert(int pos, const cInstruction& inst)
@@ -137,7 +217,7 @@ void Avida::Sequence::Insert(int pos, const Sequence& seq)
   assert(pos <= m_seq.GetSize());
   
   prepareInsert(pos, seq.GetSize());
-  for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
+  memmove(m_seq.begin() + pos, seq.m_seq.begin(), seq.GetSize() * sizeof(cInstruction));
 }
 
 void Avida::Sequence::Remove(int pos, int num_sites)
@@ -147,7 +227,7 @@ void Avida::Sequence::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of sequence
   
   const int new_size = m_active_size - num_sites;
-  for (int i = pos; i < new_size; i++) m_seq[i] = m_seq[i + num_sites];
+  if (new_size > pos) memmove(m_seq.begin() + pos, m_seq.begin() + pos + num_sites, (new_size - pos) * sizeof(cInstruction));
   adjustCapacity(new_size);
 }
 
@@ -164,7 +244,7 @@ void Avida::Sequence::Replace(int pos, int num_sites, const Sequence& seq)
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
-  for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
+  if (seq.GetSize()) memmove(m_seq.begin() + pos, seq.m_seq.begin(), seq.GetSize() * sizeof(cInstruction));
 }
 
 
@@ -224,28 +304,28 @@ void Avida::Sequence::Rotate(int n)
 
 	if (n > 0) {
 		// forward
-		Sequence head = Crop(m_active_size - n, m_active_size);
-		Sequence tail = Crop(0, m_active_size - n);
-		head.Append(tail);
-		operator=(head);
+		rotateSites(n);
 	} else {
 		assert(false);
-		// backward
-		Sequence head = Crop(0, -n); // n is < 0, so this is addition.
-		Sequence tail = Crop(-n, m_active_size);
-		tail.Append(head);
-		operator=(tail);
+		// backward, the same as moving the remaining sites forward
+		rotateSites(m_active_size + n);
 	}
+	m_mutation_steps.Clear();
 }
 
 
 void Avida::Sequence::operator=(const Sequence& other_seq)
 {
-  m_active_size = other_seq.m_active_size;
-  m_seq.ResizeClear(m_active_size);
-  
-  // Now that both code arrays are the same size, copy the other one over
-  for (int i = 0; i < m_active_size; i++) m_seq[i] = other_seq[i];
+  if (this == &other_seq) return;
+  
+  // Reuse the existing allocation when it is large enough
+  if (other_seq.m_active_size == 0) {
+    m_seq.ResizeClear(0);
+    m_active_size = 0;
+  } else {
+    adjustCapacity(other_seq.m_active_size);
+    memcpy(m_seq.begin(), other_seq.m_seq.begin(), m_active_size * sizeof(cInstruction));
+  }
   
   m_mutation_steps = other_seq.m_mutation_steps;
 }
@@ -255,12 +335,10 @@ bool Avida::Sequence::operator==(const Sequence& other_seq) const
 {
   // Make sure the sizes are the same.
   if (m_active_size != other_seq.m_active_size) return false;
+  if (m_active_size == 0) return true;
   
-  // Then go through line by line.
-  for (int i = 0; i < m_active_size; i++)
-    if (m_seq[i] != other_seq[i]) return false;
-  
-  return true;
+  // Then compare the sites as raw bytes.
+  return (memcmp(m_seq.begin(), other_seq.m_seq.begin(), m_active_size * sizeof(cInstruction)) == 0);
 }
 
 
@@ -268,7 +346,11 @@ int Avida::Sequence::FindInst(const cInstruction& inst, int start_index) const
 {
   assert(start_index < m_active_size);  // Starting search after sequence end.
   
-  for(int i = start_index; i < m_active_size; i++) if (m_seq[i] == inst) return i;
+  if (start_index >= m_active_size) return -1;
+  
+  const unsigned char* seq = siteBytes(m_seq.begin());
+  const void* found = memchr(seq + start_index, inst.GetOp(), m_active_size - start_index);
+  if (found) return static_cast<int>(static_cast<const unsigned char*>(found) - seq);
   
   // Search failed
   return -1;  
@@ -277,9 +359,7 @@ int Avida::Sequence::FindInst(const cInstruction& inst, int start_index) const
 
 int Avida::Sequence::CountInst(const cInstruction& inst) const
 {
-  int count = 0;
-  for (int i = 0; i < m_active_size; i++) if (m_seq[i] == inst) count++;
-  return count;  
+  return countOccurrences(m_seq.begin(), inst, m_active_size);
 }
 
 
@@ -337,7 +417,7 @@ Avida::Sequence Avida::Sequence::Crop(int start, int end) const
   
   const int out_length = end - start;
   Sequence out_seq(out_length);
-  for (int i = 0; i < out_length; i++) out_seq[i] = m_seq[i+start];
+  memcpy(out_seq.m_seq.begin(), m_seq.begin() + start, out_length * sizeof(cInstruction));
   
   return out_seq;
 }
@@ -355,8 +435,8 @@ Avida::Sequence Avida::Sequence::Cut(int start, int end) const
   assert(out_length > 0);             // Can't cut everything!
   
   Sequence out_seq(out_length);
-  for (int i = 0; i < start; i++) out_seq[i] = m_seq[i];
-  for (int i = start; i < out_length; i++) out_seq[i] = m_seq[i + cut_length];
+  if (start) memcpy(out_seq.m_seq.begin(), m_seq.begin(), start * sizeof(cInstruction));
+  if (out_length > start) memcpy(out_seq.m_seq.begin() + start, m_seq.begin() + end, (out_length - start) * sizeof(cInstruction));
   
   return out_seq;
 }  
@@ -368,8 +448,8 @@ Avida::Sequence Avida::Sequence::Join(const Sequence& lhs, const Sequence& rhs)
   const int out_length = length1 + length2;
   
   Sequence out_seq(out_length);
-  for (int i = 0; i < length1; i++) out_seq[i] = lhs[i];
-  for (int i = 0; i < length2; i++) out_seq[i + length1] = rhs[i];
+  if (length1) memcpy(out_seq.m_seq.begin(), lhs.m_seq.begin(), length1 * sizeof(cInstruction));
+  if (length2) memcpy(out_seq.m_seq.begin() + length1, rhs.m_seq.begin(), length2 * sizeof(cInstruction));
   
   return out_seq;
 }
@@ -397,9 +477,7 @@ int Avida::Sequence::FindHammingDistance(const Sequence& seq1, const Sequence& s
   int hamming_distance = seq1.GetSize() + seq2.GetSize() - 2 * overlap;
   
   // Cycle through the overlap adding all differences to the distance.
-  for (int i = 0; i < overlap; i++) {
-    if (seq1[start1 + i] != seq2[start2 + i])  hamming_distance++;
-  }
+  if (overlap > 0) hamming_distance += countMismatches(seq1.m_seq.begin() + start1, seq2.m_seq.begin() + start2, overlap);
   
   return hamming_distance;
 }
@@ -22,12 +22,15 @@
 
 #include "cCPUMemory.h"
 
+#include <cstring>
+
 using namespace std;
 
 
-cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : Sequence(in_memory), m_flag_array(in_memory.GetSize())
+cCPUMemory::cCPUMemory(const cCPUMemory& in_memory)
+  : Sequence(in_memory), m_flag_array(in_memory.GetSize()), m_revision(0), m_structure_revision(0)
 {
-  for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
+  if (m_active_size) memcpy(m_flag_array.begin(), in_memory.m_flag_array.begin(), m_active_size);
 }
 
 
@@ -35,6 +38,7 @@ void cCPUMemory::adjustCapacity(int new_size)
 {
   Sequence::adjustCapacity(new_size);
   if (m_seq.GetSize() != m_flag_array.GetSize()) m_flag_array.Resize(m_seq.GetSize()); 
+  structureChanged();
 }
 
 
@@ -49,8 +53,10 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
   adjustCapacity(new_size);
   
   // Shift any sites needed...
-  for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
-  for (int i = old_size - 1; i >= pos; i--) m_flag_array[i + num_sites] = m_flag_array[i];
+  if (old_size > pos) {
+    memmove(m_seq.begin() + pos + num_sites, m_seq.begin() + pos, (old_size - pos) * sizeof(cInstruction));
+    memmove(m_flag_array.begin() + pos + num_sites, m_flag_array.begin() + pos, old_size - pos);
+  }
 }
 
 
@@ -70,9 +76,9 @@ void cCPUMemory::Resize(int new_size)
   const int old_size = m_active_size;
   adjustCapacity(new_size);
   
-  for (int i = old_size; i < new_size; i++) {
-    m_seq[i].SetOp(0);
-    m_flag_array[i] = 0;
+  if (new_size > old_size) {
+    memset(m_seq.begin() + old_size, 0, (new_size - old_size) * sizeof(cInstruction));
+    memset(m_flag_array.begin() + old_size, 0, new_size - old_size);
   }
 }
 
@@ -84,7 +90,7 @@ void cCPUMemory::ResizeOld(int new_size)
   const int old_size = m_active_size;
   adjustCapacity(new_size);
 
-  for (int i = old_size; i < new_size; i++) m_flag_array[i] = 0;
+  if (new_size > old_size) memset(m_flag_array.begin() + old_size, 0, new_size - old_size);
 }
 
 
@@ -95,7 +101,7 @@ void cCPUMemory::Copy(int to, int from)
   assert(from >= 0);
   assert(from < m_seq.GetSize());
   
-  m_seq[to] = m_seq[from];
+  SetInst(to, m_seq[from]);
   m_flag_array[to] = m_flag_array[from];
 }
 
@@ -116,9 +122,9 @@ void cCPUMemory::Insert(int pos, const Sequence& genome)
   assert(pos <= m_seq.GetSize());
 
   prepareInsert(pos, genome.GetSize());
-  for (int i = 0; i < genome.GetSize(); i++) {
-    m_seq[i + pos] = genome[i];
-    m_flag_array[i + pos] = 0;
+  if (genome.GetSize()) {
+    memmove(m_seq.begin() + pos, &genome[0], genome.GetSize() * sizeof(cInstruction));
+    memset(m_flag_array.begin() + pos, 0, genome.GetSize());
   }
 }
 
@@ -129,9 +135,9 @@ void cCPUMemory::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of genome.
 
   const int new_size = m_active_size - num_sites;
-  for (int i = pos; i < new_size; i++) {
-    m_seq[i] = m_seq[i + num_sites];
-    m_flag_array[i] = m_flag_array[i + num_sites];
+  if (new_size > pos) {
+    memmove(m_seq.begin() + pos, m_seq.begin() + pos + num_sites, (new_size - pos) * sizeof(cInstruction));
+    memmove(m_flag_array.begin() + pos, m_flag_array.begin() + pos + num_sites, new_size - pos);
   }
   adjustCapacity(new_size);
 }
@@ -149,22 +155,23 @@ void cCPUMemory::Replace(int pos, int num_sites, const Sequence& genome)
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
-  for (int i = 0; i < genome.GetSize(); i++) {
-    m_seq[i + pos] = genome[i];
-    m_flag_array[i + pos] = 0;
+  if (genome.GetSize()) {
+    memmove(m_seq.begin() + pos, &genome[0], genome.GetSize() * sizeof(cInstruction));
+    memset(m_flag_array.begin() + pos, 0, genome.GetSize());
   }
+  structureChanged();
 }
 
 
 void cCPUMemory::operator=(const cCPUMemory& other_memory)
 {
+  if (this == &other_memory) return;
   adjustCapacity(other_memory.m_active_size);
   
   // Fill in the new information...
-  for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_memory.m_seq[i];
-    m_flag_array[i] = other_memory.m_flag_array[i];
-  }
+  memcpy(m_seq.begin(), other_memory.m_seq.begin(), m_active_size * sizeof(cInstruction));
+  memcpy(m_flag_array.begin(), other_memory.m_flag_array.begin(), m_active_size);
+  structureChanged();
 }
 
 
@@ -173,9 +180,21 @@ void cCPUMemory::operator=(const Sequence& other_genome)
   adjustCapacity(other_genome.GetSize());
   
   // Fill in the new information...
-  for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_genome[i];
-    m_flag_array[i] = 0;
-  }
+  if (this != &other_genome) memcpy(m_seq.begin(), &other_genome[0], m_active_size * sizeof(cInstruction));
+  memset(m_flag_array.begin(), 0, m_active_size);
+  structureChanged();
+}
+
+
+void cCPUMemory::Rotate(int n)
+{
+  assert(n < m_active_size);
+  if (n == 0) return;
+  if (n < 0) n += m_active_size;
+
+  // Rotation clears the flags, but leaves the mutation steps in place
+  rotateSites(n);
+  memset(m_flag_array.begin(), 0, m_active_size);
+  structureChanged();
 }
 
@@ -46,16 +46,45 @@ private:
   
   tArray<unsigned char> m_flag_array;
 
+  // Sites are versioned so that derived indexes (e.g. cLabelIndex) can tell when they are stale.  Every change to
+  // the instructions bumps m_revision; single site writes made through SetInst are also logged, so an index that
+  // is only a few writes behind can patch itself instead of rebuilding.  Any other change is structural.
+  static const int WRITE_LOG_SIZE = 32;
+  unsigned int m_revision;
+  unsigned int m_structure_revision;
+  int m_write_log[WRITE_LOG_SIZE];
+
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
+  inline void structureChanged() { m_structure_revision = ++m_revision; }
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const Sequence& in_genome) : Sequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : Sequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const cString& in_string) : Sequence(in_string), m_flag_array(in_string.GetSize()) { ; }
+  cCPUMemory(const Sequence& in_genome)
+    : Sequence(in_genome), m_flag_array(in_genome.GetSize()), m_revision(0), m_structure_revision(0) { ; }
+  explicit cCPUMemory(int size = 1)
+    : Sequence(size), m_flag_array(size), m_revision(0), m_structure_revision(0) { ClearFlags(); }
+  cCPUMemory(const cString& in_string)
+    : Sequence(in_string), m_flag_array(in_string.GetSize()), m_revision(0), m_structure_revision(0) { ; }
   ~cCPUMemory() { ; }
 
+  // Writes to a single site should go through SetInst, rather than operator[], so that the change is tracked
+  inline void SetInst(int pos, const cInstruction& inst)
+  {
+    m_seq[pos] = inst;
+    m_write_log[++m_revision % WRITE_LOG_SIZE] = pos;
+  }
+
+  inline unsigned int GetRevision() const { return m_revision; }
+  
+  // Returns true if every change made after revision was a logged single site write
+  inline bool HasWriteLogSince(unsigned int revision) const
+  {
+    return (revision >= m_structure_revision && m_revision - revision <= (unsigned int)WRITE_LOG_SIZE);
+  }
+  // Returns the site written by the change that produced revision (see HasWriteLogSince)
+  inline int GetLoggedWrite(unsigned int revision) const { return m_write_log[revision % WRITE_LOG_SIZE]; }
+
   inline bool FlagCopied(int pos) const     { return MASK_COPIED   & m_flag_array[pos]; }
   inline bool FlagMutated(int pos) const    { return MASK_MUTATED  & m_flag_array[pos]; }
   inline bool FlagExecuted(int pos) const   { return MASK_EXECUTED & m_flag_array[pos]; }
@@ -88,6 +117,7 @@ public:
 			m_flag_array[i] = 0;
 		}
     m_mutation_steps.Clear();
+    structureChanged();
 	}
   inline void ClearFlags() { m_flag_array.SetAll(0); }
   void Reset(int new_size);     // Reset size, clearing contents...
@@ -100,6 +130,7 @@ public:
   void Insert(int pos, const Sequence& genome);
   void Remove(int pos, int num_sites = 1);
   void Replace(int pos, int num_sites, const Sequence& genome);
+  void Rotate(int n);
 
   void operator=(const cCPUMemory& other_memory);
   void operator=(const Sequence& other_genome);
@@ -27,6 +27,7 @@
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cResourceHistory.h"
+#include "cTestCPUCache.h"
 
 #include <cassert>
 
@@ -34,10 +35,12 @@ cCPUTestInfo::cCPUTestInfo(int max_tests)
   : generation_tests(max_tests)  // These vars not reset on Clear()
   , trace_task_order(false)
   , use_random_inputs(false)
+  , m_cache_random_inputs(false)
   , use_manual_inputs(false)
   , m_tracer(NULL)
   , m_cur_sg(0)
   , org_array(max_tests)
+  , m_cache_entry(NULL)
   , m_res_method(RES_INITIAL)
   , m_res(NULL)
   , m_res_update(0)
@@ -48,6 +51,10 @@ cCPUTestInfo::cCPUTestInfo(int max_tests)
 }
 
 cCPUTestInfo::cCPUTestInfo(const cCPUTestInfo& test_info)
+  : generation_tests(0)
+  , m_tracer(NULL)
+  , m_cache_entry(NULL)
+  , m_res(NULL)
 {
   *this = test_info;
 }
@@ -55,9 +62,15 @@ cCPUTestInfo::cCPUTestInfo(const cCPUTestInfo& test_info)
 
 cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
 {
+  if (this == &test_info) return *this;
+  
+  // Release the cache entry or organisms held from any previous test
+  Clear();
+  
   generation_tests = test_info.generation_tests;
   trace_task_order = test_info.trace_task_order;
   use_random_inputs = test_info.use_random_inputs;
+  m_cache_random_inputs = test_info.m_cache_random_inputs;
 	use_manual_inputs = test_info.use_manual_inputs;
   manual_inputs = test_info.manual_inputs; 
   m_tracer = NULL;
@@ -73,6 +86,8 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
   cycle_to = test_info.cycle_to;
   used_inputs = test_info.used_inputs; 
   org_array = test_info.org_array;
+  m_cache_entry = test_info.m_cache_entry;
+  if (m_cache_entry) m_cache_entry->AddRef();
   m_res_method = test_info.m_res_method;
   m_res = NULL;  //Beware -- Resource history is NOT COPIED.
   m_res_update = test_info.m_res_update;
@@ -83,12 +98,35 @@ cCPUTestInfo& cCPUTestInfo::operator=(const cCPUTestInfo& test_info)
 
 cCPUTestInfo::~cCPUTestInfo()
 {
+  if (m_cache_entry) {
+    m_cache_entry->Release();
+    return;
+  }
+  
   for (int i = 0; i < generation_tests; i++) {
     if (org_array[i] != NULL) delete org_array[i];
   }
 }
 
 
+// Copies only the input and resource settings, leaving the results (and test organisms) of this test info untouched.
+// Unlike operator=, the resource history is shared, so that independent test infos can be handed to separate workers.
+void cCPUTestInfo::CopySettings(const cCPUTestInfo& test_info)
+{
+  trace_task_order = test_info.trace_task_order;
+  use_random_inputs = test_info.use_random_inputs;
+  m_cache_random_inputs = test_info.m_cache_random_inputs;
+  use_manual_inputs = test_info.use_manual_inputs;
+  manual_inputs = test_info.manual_inputs;
+  m_mut_rates = test_info.m_mut_rates;
+  m_cur_sg = test_info.m_cur_sg;
+  m_res_method = test_info.m_res_method;
+  m_res = test_info.m_res;
+  m_res_update = test_info.m_res_update;
+  m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+}
+
+
 void cCPUTestInfo::Clear()
 {
   is_viable = false;
@@ -97,6 +135,14 @@ void cCPUTestInfo::Clear()
   max_cycle = 0;
   cycle_to = -1;
 
+  // Cached organisms belong to the cache entry, just drop the reference
+  if (m_cache_entry) {
+    org_array.SetAll(NULL);
+    m_cache_entry->Release();
+    m_cache_entry = NULL;
+    return;
+  }
+  
   for (int i = 0; i < generation_tests; i++) {
     if (org_array[i] == NULL) break;
     delete org_array[i];
@@ -41,6 +41,7 @@ class cOrganism;
 class cPhenotype;
 class cResourceHistory;
 class cString;
+class cTestCPUCacheEntry;
 
 
 enum eTestCPUResourceMethod { RES_INITIAL = 0, RES_CONSTANT, RES_UPDATED_DEPLETABLE, RES_DYNAMIC, RES_LAST };  
@@ -55,11 +56,13 @@ enum eTestCPUResourceMethod { RES_INITIAL = 0, RES_CONSTANT, RES_UPDATED_DEPLETA
 class cCPUTestInfo
 {
   friend class cTestCPU;
+  friend class cTestCPUCache;
 private:
   // Inputs...
   int generation_tests; // Maximum depth in generations to test
   bool trace_task_order;      // Should we keep track of ordering of tasks?
   bool use_random_inputs;     // Should we give the organism random inputs?
+  bool m_cache_random_inputs; // May a random input test be served from (and stored in) the test CPU cache?
 	bool use_manual_inputs;     // Do we have inputs that we must use?
 	tArray<int> manual_inputs;  //   if so, use these.
   cHardwareTracer* m_tracer;
@@ -76,6 +79,7 @@ private:
 	tArray<int> used_inputs; //Depth 0 inputs
 
   tArray<cOrganism*> org_array;
+  cTestCPUCacheEntry* m_cache_entry;  // If set, org_array is owned by this cached result
   
   // Information about how to handle resources
   eTestCPUResourceMethod m_res_method;
@@ -91,12 +95,14 @@ public:
   ~cCPUTestInfo();
 
   void Clear();
+  void CopySettings(const cCPUTestInfo& test_info);
  
   // Input Setup
   void TraceTaskOrder(bool _trace=true) { trace_task_order = _trace; }
   void UseRandomInputs(bool _rand=true) { use_random_inputs = _rand; use_manual_inputs = false; }
   void UseManualInputs(tArray<int> inputs) {use_manual_inputs = true; use_random_inputs = false; manual_inputs = inputs;}
   void ResetInputMode() {use_manual_inputs = false; use_random_inputs = false;}
+  void CacheRandomInputs(bool _cache=true) { m_cache_random_inputs = _cache; }
   void SetTraceExecution(cHardwareTracer* tracer = NULL) { m_tracer = tracer; }
   void SetResourceOptions(int res_method = RES_INITIAL, cResourceHistory* res = NULL, int update = 0, int cpu_cycle_offset = 0)
     { m_res_method = (eTestCPUResourceMethod)res_method; m_res = res; m_res_update = update; m_res_cpu_cycle_offset = cpu_cycle_offset; }
@@ -120,6 +126,7 @@ public:
   int GetDepthFound() const { return depth_found; }
   int GetMaxCycle() const { return max_cycle; }
   int GetCycleTo() const { return cycle_to; }
+  bool WasCached() const { return (m_cache_entry != NULL); }
 
   // Genotype Stats...
   inline cOrganism* GetTestOrganism(int level = 0);
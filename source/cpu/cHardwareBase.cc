@@ -32,6 +32,7 @@
 #include "cHardwareStatusPrinter.h"
 #include "cHeadCPU.h"
 #include "cInstSet.h"
+#include "cLabelIndex.h"
 #include "cOrganism.h"
 #include "cPhenotype.h"
 #include "cPopulation.h"
@@ -64,6 +65,7 @@ cHardwareBase::cHardwareBase(cWorld* world, cOrganism* in_organism, cInstSet* in
                              m_world->GetConfig().IMPLICIT_REPRO_BONUS.Get() ||
                              m_world->GetConfig().IMPLICIT_REPRO_END.Get() ||
                              m_world->GetConfig().IMPLICIT_REPRO_ENERGY.Get());
+  m_label_index = NULL;
 	
   assert(m_organism != NULL);
 }
@@ -506,7 +508,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
         char before_mutation = memory[site].GetSymbol();
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         memory.GetMutationSteps().AddSubstitutionMutation(site, before_mutation, memory[site].GetSymbol());
         totalMutations++;
       }
@@ -848,6 +850,21 @@ unsigned cHardwareBase::Divide_DoExactMutations(cAvidaContext& ctx, double mut_m
 }
 
 
+// Runs the offspring genome through a test CPU with random inputs.  When REVERT_TEST_CACHE is set, an offspring genome
+// that was already tested at birth is served from the test CPU cache instead of being run again.
+void cHardwareBase::testOffspring(cAvidaContext& ctx, cCPUTestInfo& test_info)
+{
+  test_info.UseRandomInputs();
+  if (m_world->GetConfig().REVERT_TEST_CACHE.Get()) test_info.CacheRandomInputs();
+  
+  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  testcpu->TestGenome(ctx, test_info, m_organism->OffspringGenome());
+  delete testcpu;
+  
+  if (test_info.WasCached()) m_world->GetStats().IncDivideTestsAvoided();
+  else m_world->GetStats().IncDivideTestsRun();
+}
+
 // test whether the offspring creature contains an advantageous mutation.
 /*
  Return true iff only a reversion is performed -- returns false is sterilized regardless of whether or 
@@ -875,12 +892,9 @@ bool cHardwareBase::Divide_TestFitnessMeasures(cAvidaContext& ctx)
   const double neut_min = parent_fitness * (1.0 - m_organism->GetNeutralMin());
   const double neut_max = parent_fitness * (1.0 + m_organism->GetNeutralMax());
   
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   cCPUTestInfo test_info;
-  test_info.UseRandomInputs();
-  testcpu->TestGenome(ctx, test_info, m_organism->OffspringGenome());
+  testOffspring(ctx, test_info);
   const double child_fitness = test_info.GetGenotypeFitness();
-  delete testcpu;
   
   bool revert = false;
   bool sterilize = false;
@@ -987,12 +1001,9 @@ bool cHardwareBase::Divide_TestFitnessMeasures1(cAvidaContext& ctx)
   const double neut_min = parent_fitness * (1.0 - m_organism->GetNeutralMin());
   const double neut_max = parent_fitness * (1.0 + m_organism->GetNeutralMax());
   
-  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   cCPUTestInfo test_info;
-  test_info.UseRandomInputs();
-  testcpu->TestGenome(ctx, test_info, m_organism->OffspringGenome());
+  testOffspring(ctx, test_info);
   const double child_fitness = test_info.GetGenotypeFitness();
-  delete testcpu;
   
   bool revert = false;
   bool sterilize = false;
@@ -1102,7 +1113,7 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
       for (int i = 0; i < num_mut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
         char before_mutation = memory[site].GetSymbol();
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         memory.GetMutationSteps().AddSubstitutionMutation(site, before_mutation, memory[site].GetSymbol());
         totalMutations++;
       }
@@ -1168,6 +1179,14 @@ cHeadCPU cHardwareBase::FindLabelFull(const cCodeLabel& label)
   
   cHeadCPU temp_head(this);
   
+  // Answer from the label index if it covers the memory being searched
+  int found_pos = -1;
+  if (m_label_index && &m_label_index->GetMemory() == &temp_head.GetMemory() &&
+      m_label_index->FindFull(*m_inst_set, label, found_pos)) {
+    temp_head.AbsSet(found_pos);
+    return temp_head;
+  }
+  
   while (temp_head.InMemory()) {
     // If we are not in a label, jump to the next checkpoint...
     if (!m_inst_set->IsNop(temp_head.GetInst())) {
@@ -43,9 +43,11 @@ class cAvidaContext;
 class cBioUnit;
 class cCodeLabel;
 class cCPUMemory;
+class cCPUTestInfo;
 class cHardwareTracer;
 class cHeadCPU;
 class cInstruction;
+class cLabelIndex;
 class cMutation;
 class cOrganism;
 class cString;
@@ -97,6 +99,7 @@ protected:
   // --------  Base Hardware Feature Support  ---------
   tSmartArray<int> m_ext_mem;
   bool m_implicit_repro_active;
+  cLabelIndex* m_label_index;       // Set by hardware types that index label searches over their main memory.
   
 	// --------  Bit masks  ---------
 	static const unsigned int MASK_SIGNBIT = 0x7FFFFFFF;	
@@ -294,6 +297,7 @@ protected:
 
 private:
   void checkImplicitRepro(cAvidaContext& ctx, bool exec_last_inst = false);
+  void testOffspring(cAvidaContext& ctx, cCPUTestInfo& test_info);
 };
 
 
@@ -759,9 +759,11 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
 
 cHardwareCPU::cHardwareCPU(cAvidaContext& ctx, cWorld* world, cOrganism* in_organism, cInstSet* in_inst_set)
 : cHardwareBase(world, in_organism, in_inst_set)
+, m_memory_labels(m_memory)
 , m_last_cell_data(false, 0)
 {
   m_functions = s_inst_slib->GetFunctions();
+  m_label_index = &m_memory_labels;
   
   m_spec_die = false;
   m_epigenetic_state = false;
@@ -1182,19 +1184,28 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
   }
   
   // Call special functions depending on if jump is forwards or backwards.
+  // The label index gives the same answers as the scans, but declines the first search after a structural change
   int found_pos = 0;
   if ( direction < 0 ) {
-    found_pos = FindLabel_Backward(search_label, m_memory, inst_ptr.GetPosition() - search_label.GetSize());
+    const int search_start = inst_ptr.GetPosition() - search_label.GetSize();
+    if (!m_memory_labels.FindBackward(*m_inst_set, search_label, search_start, found_pos)) {
+      found_pos = FindLabel_Backward(search_label, m_memory, search_start);
+    }
   }
   
   // Jump forward.
   else if (direction > 0) {
-    found_pos = FindLabel_Forward(search_label, m_memory, inst_ptr.GetPosition());
+    const int search_start = inst_ptr.GetPosition();
+    if (!m_memory_labels.FindForward(*m_inst_set, search_label, search_start, found_pos)) {
+      found_pos = FindLabel_Forward(search_label, m_memory, search_start);
+    }
   }
   
   // Jump forward from the very beginning.
   else {
-    found_pos = FindLabel_Forward(search_label, m_memory, 0);
+    if (!m_memory_labels.FindForward(*m_inst_set, search_label, 0, found_pos)) {
+      found_pos = FindLabel_Forward(search_label, m_memory, 0);
+    }
   }
   
   // Return the last line of the found label, if it was found.
@@ -1638,7 +1649,7 @@ bool cHardwareCPU::Allocate_Random(cAvidaContext& ctx, const int old_size, const
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
@@ -30,6 +30,7 @@
 #include "cCPUMemory.h"
 #include "cCPUStack.h"
 #include "cHardwareBase.h"
+#include "cLabelIndex.h"
 #include "cString.h"
 #include "cStats.h"
 #include "tArray.h"
@@ -107,6 +108,7 @@ protected:
   const tMethod* m_functions;
 
   cCPUMemory m_memory;          // Memory...
+  cLabelIndex m_memory_labels;  // Label search index over m_memory
   cCPUStack m_global_stack;     // A stack that all threads share.
 
   tArray<cLocalThread> m_threads;
@@ -36,13 +36,14 @@
 #include "cInstSet.h"
 #include "cStringList.h"
 #include "cStringUtil.h"
+#include "cTestCPUCache.h"
 #include "cWorld.h"
 
 using namespace Avida;
 
 
 cHardwareManager::cHardwareManager(cWorld* world)
-: m_world(world)
+: m_world(world), m_test_cpu_cache(new cTestCPUCache(world, world->GetConfig().TEST_CPU_CACHE_SIZE.Get()))
 {
   cString filename = world->GetConfig().INST_SET.Get();
   m_is_name_map.SetDefault(-1);
@@ -51,6 +52,8 @@ cHardwareManager::cHardwareManager(cWorld* world)
 
 cHardwareManager::~cHardwareManager()
 {
+  // Cached test organisms reference the instruction sets, so release them first
+  delete m_test_cpu_cache;
   for (int i = 0; i < m_inst_sets.GetSize(); i++) delete m_inst_sets[i];
 }
 
@@ -34,6 +34,7 @@ class cHardwareBase;
 class cInstSet;
 class cOrganism;
 class cStringList;
+class cTestCPUCache;
 class cUserFeedback;
 class cWorld;
 template<typename T> class tList;
@@ -47,6 +48,7 @@ private:
   cWorld* m_world;
   tArray<cInstSet*> m_inst_sets;
   tDictionary<int> m_is_name_map;
+  cTestCPUCache* m_test_cpu_cache;
   
   cHardwareManager(); // @not_implemented
   cHardwareManager(const cHardwareManager&); // @not_implemented
@@ -62,6 +64,7 @@ public:
   
   cHardwareBase* Create(cAvidaContext& ctx, cOrganism* org, const Genome& mg);
   inline cTestCPU* CreateTestCPU(cAvidaContext& ctx) { return new cTestCPU(ctx, m_world); }
+  cTestCPUCache& GetTestCPUCache() { return *m_test_cpu_cache; }
 
   inline bool IsInstSet(const cString& name) const { return m_is_name_map.HasEntry(name); }
   
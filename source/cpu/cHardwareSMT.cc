@@ -1038,7 +1038,7 @@ void cHardwareSMT::Inject_DoMutations(cAvidaContext& ctx, double mut_multiplier,
       for (int i = 0; i < num_mut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
         char before_mutation = memory[site].GetSymbol();
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         memory.GetMutationSteps().AddSubstitutionMutation(site, before_mutation, memory[site].GetSymbol());
       }
     }
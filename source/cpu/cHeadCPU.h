@@ -90,7 +90,7 @@ public:
   inline const cInstruction& GetInst(int offset) const { return GetMemory()[m_position + offset]; }
   inline cInstruction GetNextInst() const;
 
-  inline void SetInst(const cInstruction& value) { GetMemory()[m_position] = value; }
+  inline void SetInst(const cInstruction& value) { GetMemory().SetInst(m_position, value); }
   inline void InsertInst(const cInstruction& inst) { GetMemory().Insert(m_position, inst); }
   inline void RemoveInst() { GetMemory().Remove(m_position); }
 
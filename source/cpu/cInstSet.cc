@@ -52,6 +52,7 @@ cInstSet::cInstSet(const cInstSet& _in)
   , m_has_female_costs(_in.m_has_female_costs)
   , m_has_choosy_female_costs(_in.m_has_choosy_female_costs)
   , m_has_post_costs(_in.m_has_post_costs)
+  , m_version(0)
 {
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
 }
@@ -72,6 +73,7 @@ cInstSet& cInstSet::operator=(const cInstSet& _in)
   m_has_female_costs = _in.m_has_female_costs;
   m_has_choosy_female_costs = _in.m_has_choosy_female_costs;
   m_has_post_costs = _in.m_has_post_costs;
+  m_version++;
 
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
   return *this;
@@ -112,11 +114,19 @@ cInstruction cInstSet::ActivateNullInst()
   m_lib_name_map[inst_id].res_cost = 0.0; 
   m_lib_name_map[inst_id].fem_res_cost = 0.0; 
   m_lib_name_map[inst_id].post_cost = 0;
+  m_version++;
   
   return cInstruction(inst_id);
 }
 
 
+bool cInstSet::HasProbFail() const
+{
+  for (int i = 0; i < m_lib_name_map.GetSize(); i++) if (m_lib_name_map[i].prob_fail > 0.0) return true;
+  return false;
+}
+
+
 cString cInstSet::FindBestMatch(const cString& in_name) const
 {
   int best_dist = 1024;
@@ -302,5 +312,6 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
      }
      m_mutation_index->SetWeight(id, m_lib_name_map[id].redundancy);
   }
+  m_version++;
   return success;
 }
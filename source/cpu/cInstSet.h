@@ -99,13 +99,15 @@ public:
   bool m_has_choosy_female_costs;
   bool m_has_post_costs;
   
+  int m_version;              // Incremented whenever the instruction set is modified (used to invalidate cached test results)
+  
   cInstSet(); // @not_implemented
 
 public:
   inline cInstSet(cWorld* world, const cString& name, int hw_type, cInstLib* inst_lib)
     : m_world(world), m_name(name), m_hw_type(hw_type), m_inst_lib(inst_lib), m_mutation_index(NULL), 
       m_has_costs(false), m_has_ft_costs(false), m_has_energy_costs(false), m_has_res_costs(false), m_has_fem_res_costs(false),
-      m_has_female_costs(false), m_has_choosy_female_costs(false), m_has_post_costs(false) { ; }
+      m_has_female_costs(false), m_has_choosy_female_costs(false), m_has_post_costs(false), m_version(0) { ; }
   cInstSet(const cInstSet&); 
   cInstSet& operator=(const cInstSet&); 
   inline ~cInstSet() { if (m_mutation_index != NULL) delete m_mutation_index; }
@@ -152,6 +154,9 @@ public:
   bool HasFemaleCosts() const { return m_has_female_costs; }
   bool HasChoosyFemaleCosts() const { return m_has_choosy_female_costs; }
   bool HasPostCosts() const { return m_has_post_costs; }
+  bool HasProbFail() const;
+  
+  int GetVersion() const { return m_version; }
   
   // Instruction Analysis.
   int IsNop(const cInstruction& inst) const { return (inst.GetOp() < m_lib_nopmod_map.GetSize()); }
@@ -166,8 +171,8 @@ public:
   cInstruction ActivateNullInst();
   
   // Modification of instructions during run.
-  void SetProbFail(const cInstruction& inst, double _prob_fail) { m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail; }
-  void SetRedundancy(const cInstruction& inst, int _redundancy) { m_lib_name_map[inst.GetOp()].redundancy = _redundancy; m_mutation_index->SetWeight(inst.GetOp(), _redundancy);} //@CHC
+  void SetProbFail(const cInstruction& inst, double _prob_fail) { m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail; m_version++; }
+  void SetRedundancy(const cInstruction& inst, int _redundancy) { m_lib_name_map[inst.GetOp()].redundancy = _redundancy; m_mutation_index->SetWeight(inst.GetOp(), _redundancy); m_version++; } //@CHC
 
   // accessors for instruction library
   cInstLib* GetInstLib() { return m_inst_lib; }
@@ -0,0 +1,190 @@
+/*
+ *  cLabelIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cLabelIndex.h"
+
+#include "cCPUMemory.h"
+#include "cInstSet.h"
+
+#include <cstring>
+
+
+bool cLabelIndex::FindForward(const cInstSet& inst_set, const cCodeLabel& label, int search_start, int& pos)
+{
+  if (!sync(inst_set)) return false;
+
+  const sLabelEntry& entry = getEntry(inst_set, label);
+  const int label_size = label.GetSize();
+
+  // The scan skips the template it starts on, so a match at search_start only counts if it is followed by a nop
+  int idx = lowerBound(entry, search_start);
+  if (idx < entry.num_offsets && entry.offsets[idx] == search_start) {
+    const int next = search_start + label_size;
+    if (next >= m_memory.GetSize() || !inst_set.IsNop(m_memory[next])) idx++;
+  }
+
+  pos = (idx < entry.num_offsets) ? entry.offsets[idx] + label_size : -1;
+  return true;
+}
+
+
+bool cLabelIndex::FindBackward(const cInstSet& inst_set, const cCodeLabel& label, int search_start, int& pos)
+{
+  if (!sync(inst_set)) return false;
+
+  const sLabelEntry& entry = getEntry(inst_set, label);
+  const int label_size = label.GetSize();
+
+  // Last match that ends at or before search_start
+  const int idx = lowerBound(entry, search_start - label_size + 1) - 1;
+  if (idx < 0) {
+    pos = -1;
+    return true;
+  }
+
+  // The scan returns the end of the label the match was found in, clipped to search_start
+  pos = entry.offsets[idx] + label_size;
+  while (pos < search_start && inst_set.IsNop(m_memory[pos])) pos++;
+  return true;
+}
+
+
+bool cLabelIndex::FindFull(const cInstSet& inst_set, const cCodeLabel& label, int& pos)
+{
+  if (!sync(inst_set)) return false;
+
+  const sLabelEntry& entry = getEntry(inst_set, label);
+  const int label_size = label.GetSize();
+
+  // Only a match that is the whole of its label counts
+  for (int i = 0; i < entry.num_offsets; i++) {
+    const int offset = entry.offsets[i];
+    const int end = offset + label_size;
+    if (offset > 0 && inst_set.IsNop(m_memory[offset - 1])) continue;
+    if (end < m_memory.GetSize() && inst_set.IsNop(m_memory[end])) continue;
+    pos = end;
+    return true;
+  }
+
+  pos = -1;
+  return true;
+}
+
+
+bool cLabelIndex::sync(const cInstSet& inst_set)
+{
+  const unsigned int revision = m_memory.GetRevision();
+  if (m_synced && m_revision == revision) return true;
+
+  if (m_synced && m_memory.HasWriteLogSince(m_revision)) {
+    while (m_revision != revision) patchSite(inst_set, m_memory.GetLoggedWrite(++m_revision));
+    return true;
+  }
+
+  m_synced = true;
+  m_revision = revision;
+  m_num_labels = 0;
+  return false;
+}
+
+
+cLabelIndex::sLabelEntry& cLabelIndex::getEntry(const cInstSet& inst_set, const cCodeLabel& label)
+{
+  for (int i = 0; i < m_num_labels; i++) if (m_labels[i].label == label) return m_labels[i];
+
+  int slot = m_num_labels;
+  if (m_num_labels < MAX_LABELS) {
+    m_num_labels++;
+  } else {
+    slot = m_next_evict;
+    m_next_evict = (m_next_evict + 1) % MAX_LABELS;
+  }
+
+  sLabelEntry& entry = m_labels[slot];
+  entry.label = label;
+  entry.num_offsets = 0;
+
+  const int last_offset = m_memory.GetSize() - label.GetSize();
+  for (int offset = 0; offset <= last_offset; offset++) {
+    if (!matchesAt(inst_set, label, offset)) continue;
+    if (entry.num_offsets == entry.offsets.GetSize()) entry.offsets.Resize(entry.num_offsets * 2 + 8);
+    entry.offsets[entry.num_offsets++] = offset;
+  }
+
+  return entry;
+}
+
+
+void cLabelIndex::patchSite(const cInstSet& inst_set, int site)
+{
+  for (int i = 0; i < m_num_labels; i++) {
+    sLabelEntry& entry = m_labels[i];
+    const int label_size = entry.label.GetSize();
+
+    // Recheck every offset whose match would cover the site
+    int first = site - label_size + 1;
+    if (first < 0) first = 0;
+    int last = m_memory.GetSize() - label_size;
+    if (last > site) last = site;
+
+    const int lo = lowerBound(entry, first);
+    int hi = lo;
+    while (hi < entry.num_offsets && entry.offsets[hi] <= site) hi++;
+
+    int num_matches = 0;
+    int matches[nHardware::MAX_LABEL_SIZE];
+    for (int offset = first; offset <= last; offset++) {
+      if (matchesAt(inst_set, entry.label, offset)) matches[num_matches++] = offset;
+    }
+    if (num_matches == 0 && hi == lo) continue;
+
+    const int new_count = entry.num_offsets - (hi - lo) + num_matches;
+    if (new_count > entry.offsets.GetSize()) entry.offsets.Resize(new_count * 2 + 8);
+    if (hi < entry.num_offsets && num_matches != hi - lo) {
+      memmove(entry.offsets.begin() + lo + num_matches, entry.offsets.begin() + hi, (entry.num_offsets - hi) * sizeof(int));
+    }
+    for (int j = 0; j < num_matches; j++) entry.offsets[lo + j] = matches[j];
+    entry.num_offsets = new_count;
+  }
+}
+
+
+bool cLabelIndex::matchesAt(const cInstSet& inst_set, const cCodeLabel& label, int offset) const
+{
+  const int label_size = label.GetSize();
+  for (int i = 0; i < label_size; i++) {
+    const cInstruction& inst = m_memory[offset + i];
+    if (!inst_set.IsNop(inst) || inst_set.GetNopMod(inst) != label[i]) return false;
+  }
+  return true;
+}
+
+
+int cLabelIndex::lowerBound(const sLabelEntry& entry, int offset)
+{
+  int lo = 0;
+  int hi = entry.num_offsets;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (entry.offsets[mid] < offset) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
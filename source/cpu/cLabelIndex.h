@@ -0,0 +1,86 @@
+/*
+ *  cLabelIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cLabelIndex_h
+#define cLabelIndex_h
+
+#ifndef cCodeLabel_h
+#include "cCodeLabel.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+
+class cCPUMemory;
+class cInstSet;
+
+
+// Index of the offsets at which recently searched labels occur in a cCPUMemory, sorted so that the nearest match in
+// either direction is found by binary search.  The index follows the memory's revision: single site writes are
+// patched in, while any structural change drops the cached labels.  The first query after a structural change is
+// left to the caller's own scan, since indexing a label costs a full pass over a memory that may be about to change.
+class cLabelIndex
+{
+private:
+  struct sLabelEntry
+  {
+    cCodeLabel label;
+    tArray<int> offsets;  // start of every match, ascending
+    int num_offsets;
+
+    sLabelEntry() : num_offsets(0) { ; }
+  };
+
+  static const int MAX_LABELS = 8;
+
+  const cCPUMemory& m_memory;
+  unsigned int m_revision;
+  bool m_synced;
+  sLabelEntry m_labels[MAX_LABELS];
+  int m_num_labels;
+  int m_next_evict;
+
+
+  cLabelIndex(); // @not_implemented
+  cLabelIndex(const cLabelIndex&); // @not_implemented
+  cLabelIndex& operator=(const cLabelIndex&); // @not_implemented
+
+  bool sync(const cInstSet& inst_set);
+  sLabelEntry& getEntry(const cInstSet& inst_set, const cCodeLabel& label);
+  void patchSite(const cInstSet& inst_set, int site);
+
+  bool matchesAt(const cInstSet& inst_set, const cCodeLabel& label, int offset) const;
+  static int lowerBound(const sLabelEntry& entry, int offset);
+
+public:
+  cLabelIndex(const cCPUMemory& memory) : m_memory(memory), m_revision(0), m_synced(false), m_num_labels(0), m_next_evict(0) { ; }
+
+  const cCPUMemory& GetMemory() const { return m_memory; }
+
+  // Equivalent to cHardwareCPU::FindLabel_Forward and FindLabel_Backward on the memory.  Return false, leaving pos
+  // untouched, if the memory changed structurally since the last query; the caller should then do the scan itself.
+  bool FindForward(const cInstSet& inst_set, const cCodeLabel& label, int search_start, int& pos);
+  bool FindBackward(const cInstSet& inst_set, const cCodeLabel& label, int search_start, int& pos);
+
+  // Equivalent to cHardwareBase::FindLabelFull; pos is set to the end of the first label that matches exactly
+  bool FindFull(const cInstSet& inst_set, const cCodeLabel& label, int& pos);
+};
+
+#endif
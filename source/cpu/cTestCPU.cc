@@ -37,6 +37,7 @@
 #include "cResourceHistory.h"
 #include "cResourceLib.h"
 #include "cStringUtil.h"
+#include "cTestCPUCache.h"
 #include "cTestCPUInterface.h"
 #include "cWorld.h"
 #include "tMatrix.h"
@@ -213,8 +214,7 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
 bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome)
 {
   ctx.SetTestMode();
-  test_info.Clear();
-  TestGenome_Body(ctx, test_info, genome, 0);
+  TestGenome_Cached(ctx, test_info, genome);
   ctx.ClearTestMode();
   
   return test_info.is_viable;
@@ -223,8 +223,7 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
 bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, ofstream& out_fp)
 {
   ctx.SetTestMode();
-  test_info.Clear();
-  TestGenome_Body(ctx, test_info, genome, 0);
+  TestGenome_Cached(ctx, test_info, genome);
 
   ////////////////////////////////////////////////////////////////
   // IsViable() == false
@@ -253,6 +252,29 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
+// Runs a full test, serving deterministic tests from the test CPU cache when it is enabled
+void cTestCPU::TestGenome_Cached(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome)
+{
+  test_info.Clear();
+  
+  cTestCPUCache& cache = m_world->GetHardwareManager().GetTestCPUCache();
+  if (!cache.IsEnabled()) {
+    TestGenome_Body(ctx, test_info, genome, 0);
+    return;
+  }
+  
+  if (!cache.IsCacheable(genome, test_info)) {
+    cache.NotifyBypassed();
+    TestGenome_Body(ctx, test_info, genome, 0);
+    return;
+  }
+  
+  if (cache.Lookup(genome, test_info)) return;
+  
+  TestGenome_Body(ctx, test_info, genome, 0);
+  cache.Insert(genome, test_info);
+}
+
 bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
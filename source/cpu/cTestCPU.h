@@ -83,6 +83,7 @@ private:
 
   bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
   bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  void TestGenome_Cached(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
 
   
   cTestCPU(); // @not_implemented
@@ -0,0 +1,310 @@
+/*
+ *  cTestCPUCache.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cTestCPUCache.h"
+
+#include "cAvidaConfig.h"
+#include "cEnvironment.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cOrganism.h"
+#include "cTestCPUInterface.h"
+#include "cWorld.h"
+
+#include <cassert>
+
+
+cTestCPUCacheEntry::~cTestCPUCacheEntry()
+{
+  for (int i = 0; i < m_org_array.GetSize(); i++) delete m_org_array[i];
+}
+
+
+cTestCPUCache::cTestCPUCache(cWorld* world, int capacity)
+  : m_world(world), m_capacity((capacity > 0) ? capacity : 0), m_bucket_mask(0), m_num_entries(0)
+  , m_lru_head(NULL), m_lru_tail(NULL), m_hits(0), m_misses(0), m_bypassed(0), m_evictions(0)
+{
+  if (m_capacity == 0) return;
+
+  // Size the bucket array to a power of two at least twice the capacity, keeping chains short
+  int num_buckets = 16;
+  while (num_buckets < 2 * m_capacity) num_buckets <<= 1;
+  m_buckets.Resize(num_buckets);
+  m_buckets.SetAll(NULL);
+  m_bucket_mask = num_buckets - 1;
+}
+
+cTestCPUCache::~cTestCPUCache()
+{
+  Clear();
+}
+
+
+bool cTestCPUCache::IsCacheable(const Genome& genome, const cCPUTestInfo& test_info) const
+{
+  if (m_capacity == 0) return false;
+  if (test_info.m_tracer) return false;
+  if (test_info.use_random_inputs && !test_info.m_cache_random_inputs) return false;
+  if (test_info.m_mut_rates.HasGestationMutations()) return false;
+
+  // Instruction failures are drawn from the RNG as the genome executes
+  if (m_world->GetHardwareManager().GetInstSet(genome.GetInstSet()).HasProbFail()) return false;
+
+  // Specific inputs with a random mask are drawn from the RNG on every test
+  const cEnvironment& env = m_world->GetEnvironment();
+  if (env.GetUseSpecificInputs() && env.GetSpecificRandomMask()) return false;
+
+  return true;
+}
+
+
+bool cTestCPUCache::Lookup(const Genome& genome, cCPUTestInfo& test_info)
+{
+  assert(IsCacheable(genome, test_info));
+  assert(test_info.m_cache_entry == NULL);
+
+  const unsigned int hash = hashKey(genome, test_info);
+
+  cTestCPUCacheEntry* entry = NULL;
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+    entry = findEntry(hash, genome, test_info);
+    if (entry) {
+      lruUnlink(entry);
+      lruPushFront(entry);
+      entry->AddRef();
+    }
+  }
+
+  if (!entry) {
+    Apto::Atomic::Inc(&m_misses);
+    return false;
+  }
+  Apto::Atomic::Inc(&m_hits);
+
+  // Entries are immutable once indexed, so the results may be copied outside of the lock
+  test_info.is_viable = entry->m_is_viable;
+  test_info.max_depth = entry->m_max_depth;
+  test_info.depth_found = entry->m_depth_found;
+  test_info.max_cycle = entry->m_max_cycle;
+  test_info.cycle_to = entry->m_cycle_to;
+  test_info.used_inputs = entry->m_used_inputs;
+  for (int i = 0; i < test_info.org_array.GetSize(); i++) test_info.org_array[i] = entry->m_org_array[i];
+  test_info.m_cache_entry = entry;
+
+  return true;
+}
+
+
+void cTestCPUCache::Insert(const Genome& genome, cCPUTestInfo& test_info)
+{
+  assert(IsCacheable(genome, test_info));
+  if (test_info.m_cache_entry) return;
+
+  const unsigned int hash = hashKey(genome, test_info);
+  const cEnvironment& env = m_world->GetEnvironment();
+
+  cTestCPUCacheEntry* entry = new cTestCPUCacheEntry(genome);
+  entry->m_hash = hash;
+  entry->m_generation_tests = test_info.generation_tests;
+  entry->m_trace_task_order = test_info.trace_task_order;
+  entry->m_use_random_inputs = test_info.use_random_inputs;
+  entry->m_use_manual_inputs = test_info.use_manual_inputs;
+  if (test_info.use_manual_inputs) entry->m_manual_inputs = test_info.manual_inputs;
+  entry->m_cur_sg = test_info.m_cur_sg;
+  entry->m_res_method = test_info.m_res_method;
+  entry->m_res = test_info.m_res;
+  entry->m_res_update = test_info.m_res_update;
+  entry->m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+  entry->m_env_version = env.GetVersion();
+  entry->m_inst_set_version = getInstSetVersion(genome);
+  entry->m_time_mod = m_world->GetConfig().TEST_CPU_TIME_MOD.Get();
+
+  entry->m_is_viable = test_info.is_viable;
+  entry->m_max_depth = test_info.max_depth;
+  entry->m_depth_found = test_info.depth_found;
+  entry->m_max_cycle = test_info.max_cycle;
+  entry->m_cycle_to = test_info.cycle_to;
+  entry->m_used_inputs = test_info.used_inputs;
+
+  {
+    Apto::MutexAutoLock lock(m_mutex);
+
+    // Another thread may have tested the same genome concurrently, keep the existing entry in that case
+    if (findEntry(hash, genome, test_info)) {
+      delete entry;
+      return;
+    }
+
+    // Hand the test organisms over to the entry, test_info retains a reference.  The organisms outlive the test CPU
+    // and test info that ran them, so their interfaces must no longer refer to either.
+    entry->m_org_array = test_info.org_array;
+    for (int i = 0; i < entry->m_org_array.GetSize(); i++) {
+      if (entry->m_org_array[i]) static_cast<cTestCPUInterface&>(entry->m_org_array[i]->GetOrgInterface()).Detach();
+    }
+    entry->AddRef();
+    test_info.m_cache_entry = entry;
+
+    const int bucket = hash & m_bucket_mask;
+    entry->m_bucket_next = m_buckets[bucket];
+    m_buckets[bucket] = entry;
+    lruPushFront(entry);
+    m_num_entries++;
+
+    while (m_num_entries > m_capacity) {
+      removeEntry(m_lru_tail);
+      Apto::Atomic::Inc(&m_evictions);
+    }
+  }
+}
+
+
+void cTestCPUCache::Clear()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  while (m_lru_tail) removeEntry(m_lru_tail);
+}
+
+
+int cTestCPUCache::GetSize()
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  return m_num_entries;
+}
+
+
+void cTestCPUCache::ResetStats()
+{
+  m_hits = 0;
+  m_misses = 0;
+  m_bypassed = 0;
+  m_evictions = 0;
+}
+
+
+int cTestCPUCache::getInstSetVersion(const Genome& genome) const
+{
+  return m_world->GetHardwareManager().GetInstSet(genome.GetInstSet()).GetVersion();
+}
+
+
+unsigned int cTestCPUCache::hashKey(const Genome& genome, const cCPUTestInfo& test_info) const
+{
+  // FNV-1a over the instruction sequence, then mixing in the settings that select distinct results
+  unsigned int hash = 2166136261u;
+  const Sequence& seq = genome.GetSequence();
+  for (int i = 0; i < seq.GetSize(); i++) {
+    hash ^= (unsigned int)seq[i].GetOp();
+    hash *= 16777619u;
+  }
+
+  const cString& inst_set = genome.GetInstSet();
+  for (int i = 0; i < inst_set.GetSize(); i++) {
+    hash ^= (unsigned int)inst_set[i];
+    hash *= 16777619u;
+  }
+
+  const unsigned int settings[] = {
+    (unsigned int)genome.GetHardwareType(),
+    (unsigned int)seq.GetSize(),
+    (unsigned int)test_info.m_res_method,
+    (unsigned int)test_info.m_res_update,
+    (unsigned int)test_info.m_res_cpu_cycle_offset,
+    (unsigned int)test_info.m_cur_sg,
+    (unsigned int)m_world->GetEnvironment().GetVersion(),
+    (unsigned int)getInstSetVersion(genome)
+  };
+  for (unsigned int i = 0; i < sizeof(settings) / sizeof(unsigned int); i++) {
+    hash ^= settings[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+
+bool cTestCPUCache::keyMatches(const cTestCPUCacheEntry& entry, unsigned int hash, const Genome& genome,
+                               const cCPUTestInfo& test_info) const
+{
+  if (entry.m_hash != hash) return false;
+  if (entry.m_generation_tests != test_info.generation_tests) return false;
+  if (entry.m_trace_task_order != test_info.trace_task_order) return false;
+  if (entry.m_use_random_inputs != test_info.use_random_inputs) return false;
+  if (entry.m_cur_sg != test_info.m_cur_sg) return false;
+  if (entry.m_res_method != test_info.m_res_method) return false;
+  if (entry.m_res != test_info.m_res) return false;
+  if (entry.m_res_update != test_info.m_res_update) return false;
+  if (entry.m_res_cpu_cycle_offset != test_info.m_res_cpu_cycle_offset) return false;
+  if (entry.m_env_version != m_world->GetEnvironment().GetVersion()) return false;
+  if (entry.m_inst_set_version != getInstSetVersion(genome)) return false;
+  if (entry.m_time_mod != m_world->GetConfig().TEST_CPU_TIME_MOD.Get()) return false;
+
+  if (entry.m_use_manual_inputs != test_info.use_manual_inputs) return false;
+  if (test_info.use_manual_inputs) {
+    if (entry.m_manual_inputs.GetSize() != test_info.manual_inputs.GetSize()) return false;
+    for (int i = 0; i < entry.m_manual_inputs.GetSize(); i++) {
+      if (entry.m_manual_inputs[i] != test_info.manual_inputs[i]) return false;
+    }
+  }
+
+  return (entry.m_genome == genome);
+}
+
+
+cTestCPUCacheEntry* cTestCPUCache::findEntry(unsigned int hash, const Genome& genome, const cCPUTestInfo& test_info)
+{
+  for (cTestCPUCacheEntry* entry = m_buckets[hash & m_bucket_mask]; entry; entry = entry->m_bucket_next) {
+    if (keyMatches(*entry, hash, genome, test_info)) return entry;
+  }
+  return NULL;
+}
+
+
+void cTestCPUCache::lruUnlink(cTestCPUCacheEntry* entry)
+{
+  if (entry->m_lru_prev) entry->m_lru_prev->m_lru_next = entry->m_lru_next;
+  else m_lru_head = entry->m_lru_next;
+  if (entry->m_lru_next) entry->m_lru_next->m_lru_prev = entry->m_lru_prev;
+  else m_lru_tail = entry->m_lru_prev;
+  entry->m_lru_prev = NULL;
+  entry->m_lru_next = NULL;
+}
+
+void cTestCPUCache::lruPushFront(cTestCPUCacheEntry* entry)
+{
+  entry->m_lru_prev = NULL;
+  entry->m_lru_next = m_lru_head;
+  if (m_lru_head) m_lru_head->m_lru_prev = entry;
+  m_lru_head = entry;
+  if (!m_lru_tail) m_lru_tail = entry;
+}
+
+void cTestCPUCache::removeEntry(cTestCPUCacheEntry* entry)
+{
+  cTestCPUCacheEntry** link = &m_buckets[entry->m_hash & m_bucket_mask];
+  while (*link != entry) link = &(*link)->m_bucket_next;
+  *link = entry->m_bucket_next;
+
+  lruUnlink(entry);
+  m_num_entries--;
+
+  // Drop the cache's reference, any cCPUTestInfo still holding the results keeps the entry alive
+  entry->Release();
+}
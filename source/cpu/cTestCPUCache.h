@@ -0,0 +1,158 @@
+/*
+ *  cTestCPUCache.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cTestCPUCache_h
+#define cTestCPUCache_h
+
+#include "apto/core.h"
+#include "apto/core/Atomic.h"
+
+#include "avida/core/Genome.h"
+
+#ifndef cCPUTestInfo_h
+#include "cCPUTestInfo.h"
+#endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+
+class cOrganism;
+class cResourceHistory;
+class cWorld;
+
+using namespace Avida;
+
+
+// A single memoized test CPU evaluation.  Entries are reference counted: the cache holds one reference while the
+// entry is indexed, and every cCPUTestInfo handed the cached results holds another.  The test organisms are owned by
+// the entry and destroyed when the last reference is released, so eviction never invalidates a live cCPUTestInfo.
+class cTestCPUCacheEntry
+{
+  friend class cTestCPUCache;
+private:
+  volatile int m_refs;
+
+  // Key
+  unsigned int m_hash;
+  Genome m_genome;
+  int m_generation_tests;
+  bool m_trace_task_order;
+  bool m_use_random_inputs;
+  bool m_use_manual_inputs;
+  tArray<int> m_manual_inputs;
+  int m_cur_sg;
+  int m_res_method;
+  cResourceHistory* m_res;
+  int m_res_update;
+  int m_res_cpu_cycle_offset;
+  int m_env_version;
+  int m_inst_set_version;
+  int m_time_mod;
+
+  // Results
+  bool m_is_viable;
+  int m_max_depth;
+  int m_depth_found;
+  int m_max_cycle;
+  int m_cycle_to;
+  tArray<int> m_used_inputs;
+  tArray<cOrganism*> m_org_array;
+
+  // Index links
+  cTestCPUCacheEntry* m_bucket_next;
+  cTestCPUCacheEntry* m_lru_prev;
+  cTestCPUCacheEntry* m_lru_next;
+
+
+  cTestCPUCacheEntry(const Genome& genome) : m_refs(1), m_genome(genome), m_bucket_next(NULL), m_lru_prev(NULL), m_lru_next(NULL) { ; }
+  ~cTestCPUCacheEntry();
+
+  cTestCPUCacheEntry(); // @not_implemented
+  cTestCPUCacheEntry(const cTestCPUCacheEntry&); // @not_implemented
+  cTestCPUCacheEntry& operator=(const cTestCPUCacheEntry&); // @not_implemented
+
+public:
+  void AddRef() { Apto::Atomic::Inc(&m_refs); }
+  void Release() { if (Apto::Atomic::DecAndTest(&m_refs)) delete this; }
+};
+
+
+// Bounded, thread-safe LRU cache of test CPU results keyed by genome and the test settings that affect the outcome.
+// Only deterministic evaluations are cached; tests with tracing, gestation mutations or instruction failure bypass it,
+// as do tests with random inputs unless the caller has explicitly accepted a representative result
+// (cCPUTestInfo::CacheRandomInputs).
+class cTestCPUCache
+{
+private:
+  cWorld* m_world;
+
+  Apto::Mutex m_mutex;
+  int m_capacity;
+  tArray<cTestCPUCacheEntry*> m_buckets;
+  int m_bucket_mask;
+  int m_num_entries;
+  cTestCPUCacheEntry* m_lru_head;  // most recently used
+  cTestCPUCacheEntry* m_lru_tail;  // least recently used
+
+  volatile int m_hits;
+  volatile int m_misses;
+  volatile int m_bypassed;
+  volatile int m_evictions;
+
+
+  cTestCPUCache(); // @not_implemented
+  cTestCPUCache(const cTestCPUCache&); // @not_implemented
+  cTestCPUCache& operator=(const cTestCPUCache&); // @not_implemented
+
+public:
+  cTestCPUCache(cWorld* world, int capacity);
+  ~cTestCPUCache();
+
+  bool IsEnabled() const { return (m_capacity > 0); }
+  bool IsCacheable(const Genome& genome, const cCPUTestInfo& test_info) const;
+
+  // Lookup fills test_info with the cached results on a hit.  Insert transfers ownership of the test organisms in
+  // test_info to the cache (test_info keeps a reference to them), detaching them from the test CPU that ran them.
+  // Both expect the genome and test_info to be cacheable.
+  bool Lookup(const Genome& genome, cCPUTestInfo& test_info);
+  void Insert(const Genome& genome, cCPUTestInfo& test_info);
+  void Clear();
+
+  int GetSize();
+  int GetCapacity() const { return m_capacity; }
+  int GetNumHits() { return Apto::Atomic::Get(&m_hits); }
+  int GetNumMisses() { return Apto::Atomic::Get(&m_misses); }
+  int GetNumBypassed() { return Apto::Atomic::Get(&m_bypassed); }
+  int GetNumEvictions() { return Apto::Atomic::Get(&m_evictions); }
+  void NotifyBypassed() { Apto::Atomic::Inc(&m_bypassed); }
+  void ResetStats();
+
+private:
+  int getInstSetVersion(const Genome& genome) const;
+  unsigned int hashKey(const Genome& genome, const cCPUTestInfo& test_info) const;
+  bool keyMatches(const cTestCPUCacheEntry& entry, unsigned int hash, const Genome& genome, const cCPUTestInfo& test_info) const;
+  cTestCPUCacheEntry* findEntry(unsigned int hash, const Genome& genome, const cCPUTestInfo& test_info);
+
+  void lruUnlink(cTestCPUCacheEntry* entry);
+  void lruPushFront(cTestCPUCacheEntry* entry);
+  void removeEntry(cTestCPUCacheEntry* entry);
+};
+
+#endif
@@ -73,6 +73,11 @@ const tArray<double>& cTestCPUInterface::GetCellResources(int cell_id, cAvidaCon
   return m_testcpu->GetCellResources(cell_id, ctx); 
 }
 
+double cTestCPUInterface::GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id)
+{
+  return m_testcpu->GetFrozenResources(ctx, cell_id)[res_id];
+}
+
 const tArray<double>& cTestCPUInterface::GetFrozenResources(cAvidaContext& ctx, int cell_id) 
 {
   return m_testcpu->GetFrozenResources(ctx, cell_id); 
@@ -107,13 +112,13 @@ int cTestCPUInterface::BuyValue(const int label, const int buy_price)
 
 bool cTestCPUInterface::UpdateMerit(double new_merit)
 {
-  m_test_info.GetTestPhenotype(m_cur_depth).SetMerit(cMerit(new_merit));
+  m_test_info->GetTestPhenotype(m_cur_depth).SetMerit(cMerit(new_merit));
   return true;
 }
 
 int cTestCPUInterface::GetStateGridID(cAvidaContext& ctx)
 {
-  return m_test_info.GetStateGridID();
+  return m_test_info->GetStateGridID();
 }
 
 tArray<cOrganism*> cTestCPUInterface::GetFacedAVs(int av_num)
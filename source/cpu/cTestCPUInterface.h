@@ -37,14 +37,17 @@ class cTestCPUInterface : public cOrgInterface
 {
 private:
   cTestCPU* m_testcpu;
-  cCPUTestInfo& m_test_info;
+  cCPUTestInfo* m_test_info;
   int m_cur_depth;
 
 public:
   cTestCPUInterface(cTestCPU* testcpu, cCPUTestInfo& test_info, int cur_depth)
-    : m_testcpu(testcpu), m_test_info(test_info), m_cur_depth(cur_depth) { ; }
+    : m_testcpu(testcpu), m_test_info(&test_info), m_cur_depth(cur_depth) { ; }
   virtual ~cTestCPUInterface() { ; }
 
+  // Drops the test CPU and test info, for organisms kept after the test that ran them (e.g. in the test CPU cache)
+  void Detach() { m_testcpu = NULL; m_test_info = NULL; }
+
   
   const tSmartArray <cOrganism*> GetLiveOrgList() const;
   cPopulationCell* GetCell() { return NULL; }
@@ -93,6 +96,7 @@ public:
   const tArray<double>& GetDemeResources(int deme_id, cAvidaContext& ctx); 
   const tArray<double>& GetCellResources(int cell_id, cAvidaContext& ctx); 
   const tArray<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id);
+  double GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id);
   const tArray< tArray<int> >& GetCellIdLists();  
   int GetCurrPeakX(cAvidaContext& ctx, int res_id) { return 0; } 
   int GetCurrPeakY(cAvidaContext& ctx, int res_id) { return 0; } 
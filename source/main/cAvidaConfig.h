@@ -469,6 +469,10 @@ public:
   CONFIG_ADD_GROUP(MP_GROUP, "Config options for multiple, distributed populations");
   CONFIG_ADD_VAR(ENABLE_MP, int, 0, "Enable multi-process Avida; 0=disabled (default),\n1=enabled.");
   CONFIG_ADD_VAR(MP_SCHEDULING_STYLE, int, 0, "Style of scheduling:\n0=non-MP aware (default)\n1=MP aware, integrated across worlds.");
+  CONFIG_ADD_VAR(MP_LOAD_BALANCE, int, 0, "Balance load across multi-process worlds (mass action only):\n0=off (default)\n1=worlds whose update cost is above the mean shed organisms to worlds below it.");
+  CONFIG_ADD_VAR(MP_LOAD_BALANCE_INTERVAL, int, 10, "Number of updates over which update costs are measured between load balancing steps.");
+  CONFIG_ADD_VAR(MP_LOAD_BALANCE_THRESHOLD, double, 1.25, "A world sheds organisms when its update cost exceeds this multiple of the mean.");
+  CONFIG_ADD_VAR(MT_NUM_WORLDS, int, 4, "Number of worlds run as threads of a single process by avida-mt;\nspatial universes (BIRTH_METHOD 0) must use a square number.");
 	
   
   // -------- Deme config options --------
@@ -532,6 +536,7 @@ public:
   CONFIG_ADD_ALIAS(FAIL_IMPLICIT);
   CONFIG_ADD_VAR(NEUTRAL_MAX,double, 0.0, "Percent benifical change from parent fitness to be considered neutral.");
   CONFIG_ADD_VAR(NEUTRAL_MIN,double, 0.0, "Percent deleterious change from parent fitness to be considered neutral.");
+  CONFIG_ADD_VAR(REVERT_TEST_CACHE, bool, 0, "Reuse the birth test results of offspring genomes that were already tested?\n  Requires TEST_CPU_CACHE_SIZE > 0.  The first (random input) test of a\n  genome stands in for all later offspring with the same genome.");
 
   
   // -------- Time Slicing config options --------
@@ -586,6 +591,7 @@ public:
   CONFIG_ADD_GROUP(GENEOLOGY_GROUP, "Geneology");
   CONFIG_ADD_VAR(THRESHOLD, int, 3, "Number of organisms in a genotype needed for it\n  to be considered viable.");
   CONFIG_ADD_VAR(TEST_CPU_TIME_MOD, int, 20, "Time allocated in test CPUs (multiple of length)");
+  CONFIG_ADD_VAR(TEST_CPU_CACHE_SIZE, int, 0, "Number of test CPU results to memoize (0 = off).\n  Only tests without random inputs or mutations are cached; instruction\n  sets that draw random numbers during execution should leave this off.");
   
 
   // -------- Log File config options --------
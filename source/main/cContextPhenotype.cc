@@ -3,6 +3,21 @@
 using namespace std;
 
 
+void cContextPhenotype::ResizeCounts(int number_tasks, int number_reactions)
+{
+    // Clears the counts if the number of tasks or reactions has changed, as adding counts does
+    if(m_number_tasks != number_tasks) {
+      m_cur_task_count.ResizeClear(number_tasks);
+      m_cur_task_count.SetAll(0);
+      m_number_tasks = number_tasks;
+    }
+    if(m_number_reactions != number_reactions) {
+      m_cur_reaction_count.ResizeClear(number_reactions);
+      m_cur_reaction_count.SetAll(0);
+      m_number_reactions = number_reactions;
+    }
+}
+
 void cContextPhenotype::AddTaskCounts(int number_tasks, tArray<int>& cur_task_count)
 {
     // Step 1: Resize m_cur_thread_task_count array if necessary.  This is necessary
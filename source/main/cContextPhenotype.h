@@ -43,6 +43,7 @@ public:
   int m_number_reactions;
 // cur_task_count(m_world->GetEnvironment().GetNumTasks())
 
+  void ResizeCounts(int number_tasks, int number_reactions);
   void AddTaskCounts(int count, tArray<int>& cur_task_count);
   tArray<int>& GetTaskCounts() { return m_cur_task_count; }
   void AddReactionCounts(int count, tArray<int>& cur_task_count);
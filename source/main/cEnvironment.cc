@@ -54,10 +54,11 @@ using namespace Avida;
 
 cEnvironment::cEnvironment(cWorld* world) : m_world(world) , m_tasklib(world),
 m_input_size(INPUT_SIZE_DEFAULT), m_output_size(OUTPUT_SIZE_DEFAULT), m_true_rand(false),
-m_use_specific_inputs(false), m_specific_inputs(), m_mask(0)
+m_use_specific_inputs(false), m_specific_inputs(), m_mask(0), m_version(0)
 {
   mut_rates.Setup(world);
   if (m_world->GetConfig().DEFAULT_GROUP.Get() != -1) possible_group_ids.insert(m_world->GetConfig().DEFAULT_GROUP.Get());
+  buildOutputPlan();
 }
 
 cEnvironment::~cEnvironment()
@@ -1242,6 +1243,8 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
 /* Routine to read in a line from the enviroment file and hand that line
  line to the approprate routine to process it.                         */
 {
+  m_version++;
+
   cString type = line.PopWord();      // Determine type of this entry.
   type.ToUpper();                     // Make type case insensitive.
 
@@ -1258,6 +1261,9 @@ bool cEnvironment::LoadLine(cString line, Feedback& feedback)
     return false;
   }
 
+  buildOutputPlan();
+  resource_lib.UpdateHabitatIndex();
+
   if (load_ok == false) {
     feedback.Error("failed in loading '%s'", (const char*)type);
     return false;
@@ -1384,14 +1390,18 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
   // Do setup for reaction tests...
   m_tasklib.SetupTests(taskctx);
 
-  // Loop through all reactions to see if any have been triggered...
-  const int num_reactions = reaction_lib.GetSize();
-  for (int i = 0; i < num_reactions; i++) {
+  // Context requisites are tested against counts sized for this environment
+  if (context_phenotype != 0) context_phenotype->ResizeCounts(task_count.GetSize(), reaction_lib.GetSize());
+
+  // Loop through the active reactions that can be triggered by an output with this logic ID...
+  const int logic_id = taskctx.GetLogicId();
+  const tArray<int>& plan = m_output_plan[(logic_id >= 0 && logic_id < 256) ? logic_id : 256];
+  const int num_planned = plan.GetSize();
+  for (int plan_idx = 0; plan_idx < num_planned; plan_idx++) {
+    const int i = plan[plan_idx];
     cReaction* cur_reaction = reaction_lib.GetReaction(i);
     assert(cur_reaction != NULL);
-
-    // Only use active reactions...
-    if (cur_reaction->GetActive() == false) continue;
+    assert(cur_reaction->GetActive());
 
     // Examine the task trigger associated with this reaction
     cTaskEntry* cur_task = cur_reaction->GetTask();
@@ -1410,18 +1420,6 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
     }
 
     if (context_phenotype != 0) {
-      tArray<int> blank_tasks;
-      tArray<int> blank_reactions;
-      blank_tasks.ResizeClear(task_count.GetSize());
-      for(int count=0;count<task_count.GetSize();count++) {
-        blank_tasks[count] = 0;
-      }
-      blank_reactions.ResizeClear(this->GetReactionLib().GetSize());
-      for(int count=0;count<reaction_count.GetSize();count++) {
-        blank_reactions[count] = 0;
-      }
-      context_phenotype->AddTaskCounts(blank_tasks.GetSize(), blank_tasks);
-      context_phenotype->AddReactionCounts(blank_reactions.GetSize(), blank_reactions);
       int context_task_count = context_phenotype->GetTaskCounts()[task_id];
       if (TestContextRequisites(cur_reaction, context_task_count, context_phenotype->GetReactionCounts(), on_divide) == false) {
         if (!skipProcessing) {  // for those parasites again
@@ -1462,6 +1460,50 @@ bool cEnvironment::TestOutput(cAvidaContext& ctx, cReactionResult& result,
   return result.GetActive();
 }
 
+// Build the table of reactions TestOutput examines for each logic ID (index 256 holds outputs without a consistent
+// logic ID).  Reactions whose task depends only on the logic ID are listed under just the IDs that perform it; all
+// other active reactions are listed everywhere, in reaction order.  Reactions with phenotypic plasticity bonuses that
+// force their task to be marked are always examined, since they can be marked without the task being performed.
+void cEnvironment::buildOutputPlan()
+{
+  const int num_reactions = reaction_lib.GetSize();
+  tArray<int> always(num_reactions);   // 1 = examine for every logic ID, 0 = only matching IDs, -1 = never (inactive)
+  for (int i = 0; i < num_reactions; i++) {
+    cReaction* cur_reaction = reaction_lib.GetReaction(i);
+    if (!cur_reaction->GetActive()) {
+      always[i] = -1;
+      continue;
+    }
+
+    always[i] = 1;
+    const cTaskEntry* cur_task = cur_reaction->GetTask();
+    if (cur_task == NULL || !cur_task->IsLogicOnly()) continue;
+
+    // Any phenotypic plasticity method other than DEFAULT makes GetTaskProbability run (and lazily compute) the
+    // random-input plasticity trials for this task whatever the logic ID, drawing from the RNG, so such reactions
+    // must keep being examined for every output to preserve the RNG sequence
+    bool forces_examine = false;
+    tLWConstListIterator<cReactionProcess> proc_it(cur_reaction->GetProcesses());
+    const cReactionProcess* cur_proc;
+    while ((cur_proc = proc_it.Next()) != NULL) {
+      if (cur_proc->GetPhenPlastBonusMethod() != DEFAULT) forces_examine = true;
+    }
+    if (!forces_examine) always[i] = 0;
+  }
+
+  m_output_plan.ResizeClear(257);
+  for (int logic_id = 0; logic_id <= 256; logic_id++) {
+    tArray<int>& plan = m_output_plan[logic_id];
+    plan.Resize(0);
+    for (int i = 0; i < num_reactions; i++) {
+      if (always[i] == 1 || (always[i] == 0 && reaction_lib.GetReaction(i)->GetTask()->TestLogicId(logic_id))) {
+        plan.Push(i);
+      }
+    }
+  }
+}
+
+
 bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_reaction,
                                   int task_count, const tArray<int>& reaction_count, const bool on_divide) const
 {
@@ -1483,7 +1525,7 @@ bool cEnvironment::TestRequisites(cTaskContext& taskctx, const cReaction* cur_re
     
     if (taskctx.GetOrganism()) {
       // Have all reactions been met?
-      const tArray<int> stolen_reactions = taskctx.GetOrganism()->GetPhenotype().GetStolenReactionCount(); 
+      const tArray<int>& stolen_reactions = taskctx.GetOrganism()->GetPhenotype().GetStolenReactionCount(); 
       tLWConstListIterator<cReaction> reaction_it(cur_req->GetReactions());
       while (reaction_it.Next() != NULL) {
         int react_id = reaction_it.Get()->GetID();
@@ -1912,6 +1954,7 @@ double cEnvironment::GetReactionValue(int reaction_id)
 
 bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, double value)
 {
+  m_version++;
   const int num_reactions = reaction_lib.GetSize();
 
   // See if this should be applied to all reactions.
@@ -1953,6 +1996,7 @@ bool cEnvironment::SetReactionValue(cAvidaContext& ctx, const cString& name, dou
 
 bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->MultiplyValue(value_mult);
@@ -1961,6 +2005,7 @@ bool cEnvironment::SetReactionValueMult(const cString& name, double value_mult)
 
 bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   found_reaction->ModifyInst(inst_name);
@@ -1969,6 +2014,7 @@ bool cEnvironment::SetReactionInst(const cString& name, cString inst_name)
 
 bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinTaskCount( min_count );
@@ -1976,6 +2022,7 @@ bool cEnvironment::SetReactionMinTaskCount(const cString& name, int min_count)
 
 bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxTaskCount( max_count );
@@ -1983,6 +2030,7 @@ bool cEnvironment::SetReactionMaxTaskCount(const cString& name, int max_count)
 
 bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMinReactionCount( reaction_min_count );
@@ -1990,6 +2038,7 @@ bool cEnvironment::SetReactionMinCount(const cString& name, int reaction_min_cou
 
 bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_count)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
   return found_reaction->SetMaxReactionCount( reaction_max_count );
@@ -1997,6 +2046,7 @@ bool cEnvironment::SetReactionMaxCount(const cString& name, int reaction_max_cou
 
 bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 {
+  m_version++;
   cReaction* found_reaction = reaction_lib.GetReaction(name);
   if (found_reaction == NULL) return false;
 
@@ -2005,6 +2055,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
     if (m_tasklib.GetTask(i).GetName() == task)
     {
       found_reaction->SetTask( m_tasklib.GetTaskReference(i) );
+      buildOutputPlan();
       return true;
     }
   }
@@ -2014,6 +2065,7 @@ bool cEnvironment::SetReactionTask(const cString& name, const cString& task)
 
 bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 {
+  m_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetInflow( _inflow );
@@ -2022,6 +2074,7 @@ bool cEnvironment::SetResourceInflow(const cString& name, double _inflow )
 
 bool cEnvironment::SetResourceOutflow(const cString& name, double _outflow )
 {
+  m_version++;
   cResource* found_resource = resource_lib.GetResource(name);
   if (found_resource == NULL) return false;
   found_resource->SetOutflow( _outflow );
@@ -74,6 +74,10 @@ private:
   
   unsigned int m_mask;
   
+  int m_version;              // Incremented whenever the environment is modified (used to invalidate cached test results)
+  
+  tArray<tArray<int> > m_output_plan;  // Reactions to examine in TestOutput, indexed by logic ID (256 = no logic ID)
+  
   tArray<cStateGrid*> m_state_grids;
 
 	std::set<int> possible_group_ids;
@@ -94,8 +98,10 @@ public:
 
   // Interaction with the organisms
   void SetupInputs(cAvidaContext& ctx, tArray<int>& input_array, bool random = true) const;
-  void SetSpecificInputs(const tArray<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; }
-  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; }
+  void SetSpecificInputs(const tArray<int> in_input_array) { m_use_specific_inputs = true; m_specific_inputs = in_input_array; m_version++; }
+  void SetSpecificRandomMask(unsigned int mask) { m_mask = mask; m_version++; }
+  bool GetUseSpecificInputs() const { return m_use_specific_inputs; }
+  unsigned int GetSpecificRandomMask() const { return m_mask; }
   void SwapInputs(cAvidaContext& ctx, tArray<int>& src_input_array, tArray<int>& dest_input_array) const;
 
 
@@ -129,6 +135,8 @@ public:
   int GetNumStateGrids() const { return m_state_grids.GetSize(); }
   const cStateGrid& GetStateGrid(int sg) const { return *m_state_grids[sg]; }  
 
+  int GetVersion() const { return m_version; }
+
   int GetInputSize()  const { return m_input_size; };
   int GetOutputSize() const { return m_output_size; };
 
@@ -153,7 +161,7 @@ public:
   bool IsTargetID(int test_id);
   std::set<int> GetTargetIDs() { return possible_target_ids; }
 
-  void AddHabitat(int new_habitat) { possible_habitats.insert(new_habitat); }
+  void AddHabitat(int new_habitat) { possible_habitats.insert(new_habitat); resource_lib.UpdateHabitatIndex(); }
   bool IsHabitat(int test_habitat);
   std::set<int> GetHabitats() { return possible_habitats; }
 
@@ -180,6 +188,8 @@ private:
 
                             const tList<cReactionProcess>& req_proc, bool& force_mark_task) const;
   
+  void buildOutputPlan();
+  
   bool TestRequisites(cTaskContext& taskctx, const cReaction* cur_reaction, int task_count,
                       const tArray<int>& reaction_count, const bool on_divide = false) const; 
   bool TestContextRequisites(const cReaction* cur_reaction, int task_count, 
@@ -107,6 +107,7 @@ cGradientCount::cGradientCount(cWorld* world, int peakx, int peaky, int height,
   , m_pred_odds(0.0)
   , m_guarded_juvs_per_adult(0)
   , m_probabilistic(false)
+  , m_num_footprint_cells(0)
 {
   ResetGradRes(m_world->GetDefaultContext(), worldx, worldy);
 }
@@ -451,92 +452,140 @@ void cGradientCount::refreshResourceValues()
     m_current_height = m_height;
   }
 
-  int plateau_cell = 0;
-  for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
-    for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
-      double thisheight = 0.0;
-      double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
-      if (m_spread >= thisdist) {
-        // determine theoretical individual cells values and add one to distance from center 
-        // (so that center point = radius 1, not 0)
-        // also used to distinguish plateau cells
-        
-        thisheight = m_current_height / (thisdist + 1);
-        
-        // set the floor values
-        // plateaus will override this so that plateaus can hit 0 when being eaten
-        if (thisheight < m_floor) thisheight = m_floor;
-        
-        // create cylindrical profiles of resources whereever thisheight would be >1 (area where thisdist + 1 <= m_height)
-        // and slopes outside of that range
-        // plateau = -1 turns off this option; if activated, causes 'peaks' to be flat plateaus = plateau value 
-        bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
-        // apply plateau inflow(s) and outflow 
-        if ((is_plat_cell && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize())) { 
-          if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
-            m_past_height = m_height;
-            if (m_plateau >= 0.0) {
-              thisheight = m_plateau;
-            } 
-            else {
-              thisheight = m_height;
-            }
-          } 
-          else { 
-            if (m_is_plateau_common == 0) {
-              m_past_height = m_plateau_array[plateau_cell]; 
-              thisheight = m_past_height + m_plateau_inflow - (m_past_height * m_plateau_outflow);
-              thisheight += m_gradient_inflow / (thisdist + 1);
-              if (thisheight > m_plateau && m_plateau >= 0) {
-                thisheight = m_plateau;
-              } 
-              if (m_plateau < 0 && thisdist == 0 && thisheight > m_height) {
-                thisheight = m_height;
-              }
-            }
-            else if (m_is_plateau_common == 1) {   
-              thisheight = m_common_plat_height;
-            }
-          }
-          if (m_initial && m_initial_plat != -1) thisheight = m_initial_plat;
-          if (thisheight < 0) thisheight = 0;
-          m_plateau_array[plateau_cell] = thisheight;
-          m_plateau_cell_IDs[plateau_cell] = jj * GetX() + ii;
-          plateau_cell ++;
-         }
-        // now apply any off-plateau inflow(s) and outflow
-        else if (!is_plat_cell && (m_cone_inflow > 0 || m_cone_outflow > 0 || m_gradient_inflow > 0)) {
-          if (!m_just_reset && m_world->GetStats().GetUpdate() > 0) {
-            int offsetx = m_old_peakx - m_peakx;
-            int offsety = m_old_peaky - m_peaky;
-            
-            int old_cell_x = ii + offsetx;
-            int old_cell_y = jj + offsety;
-            
-            // cone cells that were previously off the world and moved onto world, start at 0
-            if ( old_cell_x < 0 || old_cell_y < 0 || (old_cell_y > (GetY() - 1)) || (old_cell_x > (GetX() - 1)) ) {
-              thisheight = 0;
-            }
-            else {
-              double past_height = Element(old_cell_y * GetX() + old_cell_x).GetAmount(); 
-              double newheight = past_height; 
-              if (m_cone_inflow > 0 || m_cone_outflow > 0) newheight += m_cone_inflow - (past_height * m_cone_outflow);
-              if (m_gradient_inflow > 0) newheight += m_gradient_inflow / (thisdist + 1); 
-              // don't exceed expected slope value
-              if (newheight < thisheight) thisheight = newheight;
-              if (thisheight < 0) thisheight = 0;
-            }
-          }
+  // without cone flows no cell depends on its neighbors' previous values, so only the cells under the old and new
+  // peak footprints need to be visited
+  const bool cone_flows = (m_cone_inflow > 0 || m_cone_outflow > 0 || m_gradient_inflow > 0);
+  if (!m_just_reset && !cone_flows) {
+    refreshFootprint();
+  } else {
+    m_num_footprint_cells = 0;
+    if (m_footprint_cells.GetSize() < (2 * m_spread + 1) * (2 * m_spread + 1)) m_footprint_cells.Resize((2 * m_spread + 1) * (2 * m_spread + 1));
+    int plateau_cell = 0;
+    for (int ii = min_pos_x; ii < max_pos_x + 1; ii++) {
+      for (int jj = min_pos_y; jj < max_pos_y + 1; jj++) {
+        double thisheight = 0.0;
+        double thisdist = sqrt((double) (m_peakx - ii) * (m_peakx - ii) + (m_peaky - jj) * (m_peaky - jj));
+        if (m_spread >= thisdist) {
+          thisheight = getCellHeight(ii, jj, thisdist, plateau_cell);
+          m_footprint_cells[m_num_footprint_cells++] = jj * GetX() + ii;
         }
+        Element(jj * GetX() + ii).SetAmount(thisheight);
       }
-      Element(jj * GetX() + ii).SetAmount(thisheight);
     }
-  }         
+  }
   SetCurrPeakX(m_peakx);
   SetCurrPeakY(m_peaky);
   m_just_reset = false;
 }
 
+// Updates the cells within spread of the peak and zeroes those left behind by its last move, in the same
+// (x-major) order as the full pass so that plateau cells keep their slots in m_plateau_array
+void cGradientCount::refreshFootprint()
+{
+  const int spread_sq = m_spread * m_spread;
+  
+  // clear the cells the peak has moved off of
+  for (int i = 0; i < m_num_footprint_cells; i++) {
+    const int cell_id = m_footprint_cells[i];
+    const int dx = cell_id % GetX() - m_peakx;
+    const int dy = cell_id / GetX() - m_peaky;
+    if (dx * dx + dy * dy > spread_sq) Element(cell_id).SetAmount(0.0);
+  }
+  
+  m_num_footprint_cells = 0;
+  if (m_footprint_cells.GetSize() < (2 * m_spread + 1) * (2 * m_spread + 1)) m_footprint_cells.Resize((2 * m_spread + 1) * (2 * m_spread + 1));
+  
+  int plateau_cell = 0;
+  const int max_pos_x = min(m_peakx + m_spread, GetX() - 1);
+  for (int ii = max(m_peakx - m_spread, 0); ii < max_pos_x + 1; ii++) {
+    const int dx = m_peakx - ii;
+    int span = 0;
+    while ((span + 1) * (span + 1) + dx * dx <= spread_sq) span++;
+    const int max_pos_y = min(m_peaky + span, GetY() - 1);
+    for (int jj = max(m_peaky - span, 0); jj < max_pos_y + 1; jj++) {
+      const double thisdist = sqrt((double) dx * dx + (m_peaky - jj) * (m_peaky - jj));
+      Element(jj * GetX() + ii).SetAmount(getCellHeight(ii, jj, thisdist, plateau_cell));
+      m_footprint_cells[m_num_footprint_cells++] = jj * GetX() + ii;
+    }
+  }
+}
+
+// Computes the value of a cell within spread of the peak, recording plateau cells as they are passed
+double cGradientCount::getCellHeight(int ii, int jj, double thisdist, int& plateau_cell)
+{
+  // determine theoretical individual cells values and add one to distance from center 
+  // (so that center point = radius 1, not 0)
+  // also used to distinguish plateau cells
+  double thisheight = m_current_height / (thisdist + 1);
+
+  // set the floor values
+  // plateaus will override this so that plateaus can hit 0 when being eaten
+  if (thisheight < m_floor) thisheight = m_floor;
+
+  // create cylindrical profiles of resources whereever thisheight would be >1 (area where thisdist + 1 <= m_height)
+  // and slopes outside of that range
+  // plateau = -1 turns off this option; if activated, causes 'peaks' to be flat plateaus = plateau value 
+  bool is_plat_cell = ((m_height / (thisdist + 1)) >= 1);
+  // apply plateau inflow(s) and outflow 
+  if ((is_plat_cell && m_plateau >= 0) || (m_plateau < 0 && thisdist == 0 && m_plateau_array.GetSize())) { 
+    if (m_just_reset || m_world->GetStats().GetUpdate() <= 0) {
+      m_past_height = m_height;
+      if (m_plateau >= 0.0) {
+        thisheight = m_plateau;
+      } 
+      else {
+        thisheight = m_height;
+      }
+    } 
+    else { 
+      if (m_is_plateau_common == 0) {
+        m_past_height = m_plateau_array[plateau_cell]; 
+        thisheight = m_past_height + m_plateau_inflow - (m_past_height * m_plateau_outflow);
+        thisheight += m_gradient_inflow / (thisdist + 1);
+        if (thisheight > m_plateau && m_plateau >= 0) {
+          thisheight = m_plateau;
+        } 
+        if (m_plateau < 0 && thisdist == 0 && thisheight > m_height) {
+          thisheight = m_height;
+        }
+      }
+      else if (m_is_plateau_common == 1) {   
+        thisheight = m_common_plat_height;
+      }
+    }
+    if (m_initial && m_initial_plat != -1) thisheight = m_initial_plat;
+    if (thisheight < 0) thisheight = 0;
+    m_plateau_array[plateau_cell] = thisheight;
+    m_plateau_cell_IDs[plateau_cell] = jj * GetX() + ii;
+    plateau_cell ++;
+  }
+  // now apply any off-plateau inflow(s) and outflow
+  else if (!is_plat_cell && (m_cone_inflow > 0 || m_cone_outflow > 0 || m_gradient_inflow > 0)) {
+    if (!m_just_reset && m_world->GetStats().GetUpdate() > 0) {
+      int offsetx = m_old_peakx - m_peakx;
+      int offsety = m_old_peaky - m_peaky;
+
+      int old_cell_x = ii + offsetx;
+      int old_cell_y = jj + offsety;
+
+      // cone cells that were previously off the world and moved onto world, start at 0
+      if ( old_cell_x < 0 || old_cell_y < 0 || (old_cell_y > (GetY() - 1)) || (old_cell_x > (GetX() - 1)) ) {
+        thisheight = 0;
+      }
+      else {
+        double past_height = Element(old_cell_y * GetX() + old_cell_x).GetAmount(); 
+        double newheight = past_height; 
+        if (m_cone_inflow > 0 || m_cone_outflow > 0) newheight += m_cone_inflow - (past_height * m_cone_outflow);
+        if (m_gradient_inflow > 0) newheight += m_gradient_inflow / (thisdist + 1); 
+        // don't exceed expected slope value
+        if (newheight < thisheight) thisheight = newheight;
+        if (thisheight < 0) thisheight = 0;
+      }
+    }
+  }
+  return thisheight;
+}
+
 void cGradientCount::getCurrentPlatValues()
 { 
   int temp_height = 0;
@@ -809,6 +858,7 @@ void cGradientCount::ResetGradRes(cAvidaContext& ctx, int worldx, int worldy)
   m_var_plat_inflow = 0;
   m_initial = true;
   ResizeClear(worldx, worldy, m_geometry);
+  m_num_footprint_cells = 0;
   if (m_habitat == 2) {
     generateBarrier(ctx);
   }
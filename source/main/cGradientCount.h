@@ -106,6 +106,9 @@ private:
   bool m_probabilistic;
   tArray<int> m_prob_res_cells;
   
+  tArray<int> m_footprint_cells;  // cells within spread of the peak as of the last refresh
+  int m_num_footprint_cells;
+  
 public:
   cGradientCount(cWorld* world, int peakx, int peaky, int height, int spread, double plateau, int decay,              
                  int max_x, int max_y, int min_x, int min_y, double move_a_scaler, int updatestep, 
@@ -166,6 +169,8 @@ public:
   
 private:
   void refreshResourceValues();
+  void refreshFootprint();
+  double getCellHeight(int ii, int jj, double thisdist, int& plateau_cell);
   void generatePeak(cAvidaContext& ctx);
   void getCurrentPlatValues();
   void generateBarrier(cAvidaContext& ctx);
@@ -34,10 +34,10 @@ private:
 
 public:
   // Constructors and Destructor...
+  // Copy and destruction are left implicit so that instructions remain trivially copyable; sequences move them
+  // in bulk with memmove/memcpy.
   cInstruction() : m_operand(0) { ; }
-  cInstruction(const cInstruction& inst) { *this = inst; }
   explicit cInstruction(int in_op) { SetOp(in_op); }
-  ~cInstruction() { ; }
   
   // Accessors...
   int GetOp() const { return static_cast<int>(m_operand); }
@@ -49,7 +49,6 @@ public:
   void SetOp(int in_op) { assert(in_op < 256); m_operand = in_op; }
 
   // Operators...
-  void operator=(const cInstruction& inst) { if (this != &inst) m_operand = inst.m_operand; }
   bool operator==(const cInstruction& inst) const { return (m_operand == inst.m_operand); }
   bool operator!=(const cInstruction& inst) const { return !(operator==(inst)); }
 
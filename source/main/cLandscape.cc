@@ -22,6 +22,7 @@
 
 #include "cLandscape.h"
 
+#include "cAnalyzeJobQueue.h"
 #include "cCPUMemory.h"
 #include "cDataFile.h"
 #include "cEnvironment.h"
@@ -32,6 +33,7 @@
 #include "cStats.h"             // For GetUpdate in outputs...
 #include "cTestCPU.h"
 #include "cWorld.h"
+#include "tAnalyzeJob.h"
 
 
 cLandscape::cLandscape(cWorld* world, const Genome& in_genome)
@@ -143,12 +145,99 @@ void cLandscape::Process(cAvidaContext& ctx)
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
   
-  // Now Process the new creature at the proper distance.
-  Process_Body(ctx, testcpu, base_genome, distance, 0);
+  // Now Process the new creature at the proper distance, one first mutated site at a time.
+  SetupSites();
+  cCPUTestInfo test_info;
+  test_info.CopySettings(m_cpu_test_info);
+  for (int site = 0; site < m_site_results.GetSize(); site++) ProcessSite_Body(ctx, testcpu, test_info, site);
 
   delete testcpu;
   
-  // Calculate the complexity...
+  CompleteSites();
+}
+
+
+// Splits the landscape across the job queue, one job per first mutated site.  Results are available once the job queue
+// has finished executing.
+void cLandscape::ProcessParallel(cAvidaContext& ctx, cAnalyzeJobQueue& jobqueue)
+{
+  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  ProcessBase(ctx, testcpu);
+  delete testcpu;
+  
+  SetupSites();
+  m_cur_site = 0;
+  m_completed = 0;
+  
+  const int num_sites = m_site_results.GetSize();
+  if (num_sites == 0) {
+    CompleteSites();
+    return;
+  }
+  for (int i = 0; i < num_sites; i++) jobqueue.AddJob(new tAnalyzeJob<cLandscape>(this, &cLandscape::ProcessSite));
+}
+
+
+void cLandscape::ProcessSite(cAvidaContext& ctx)
+{
+  m_mutex.Lock();
+  const int cur_site = m_cur_site++;
+  m_mutex.Unlock();
+  
+  // Each worker needs its own test CPU and test info
+  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  cCPUTestInfo test_info;
+  test_info.CopySettings(m_cpu_test_info);
+  ProcessSite_Body(ctx, testcpu, test_info, cur_site);
+  delete testcpu;
+  
+  m_mutex.Lock();
+  const bool complete = (++m_completed == m_site_results.GetSize());
+  m_mutex.Unlock();
+  
+  if (complete) CompleteSites();
+}
+
+
+void cLandscape::SetupSites()
+{
+  const int num_sites = (distance > 0) ? base_genome.GetSize() - distance + 1 : 0;
+  m_site_results.ResizeClear((num_sites > 0) ? num_sites : 0);
+  for (int i = 0; i < m_site_results.GetSize(); i++) {
+    sSiteResults& results = m_site_results[i];
+    results.peak_fitness = base_fitness;
+    results.site_count.Resize(base_genome.GetSize() + 1, 0);
+  }
+}
+
+
+void cLandscape::ProcessSite_Body(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, int site)
+{
+  Process_Body(ctx, testcpu, test_info, m_site_results[site], base_genome, distance, site, site + 1);
+}
+
+
+// Reduce the per-site results in site order, then calculate the complexity.
+void cLandscape::CompleteSites()
+{
+  for (int i = 0; i < m_site_results.GetSize(); i++) {
+    const sSiteResults& results = m_site_results[i];
+    total_fitness += results.total_fitness;
+    total_sqr_fitness += results.total_sqr_fitness;
+    total_count += results.total_count;
+    dead_count += results.dead_count;
+    neg_count += results.neg_count;
+    neut_count += results.neut_count;
+    pos_count += results.pos_count;
+    pos_size += results.pos_size;
+    neg_size += results.neg_size;
+    if (results.peak_fitness > peak_fitness) {
+      peak_fitness = results.peak_fitness;
+      peak_genome = results.peak_genome;
+    }
+    for (int j = 0; j <= base_genome.GetSize(); j++) site_count[j] += results.site_count[j];
+  }
+  m_site_results.Resize(0);
   
   double max_ent = log((double) m_world->GetHardwareManager().GetInstSet(base_genome.GetInstSet()).GetSize());
   total_entropy = 0;
@@ -163,12 +252,42 @@ void cLandscape::Process(cAvidaContext& ctx)
 }
 
 
+double cLandscape::ProcessSiteGenome(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info,
+                                     sSiteResults& results, Genome& in_genome)
+{
+  testcpu->TestGenome(ctx, test_info, in_genome);
+  
+  double test_fitness = test_info.GetColonyFitness();
+  
+  results.total_fitness += test_fitness;
+  results.total_sqr_fitness += test_fitness * test_fitness;
+  results.total_count++;
+  if (test_fitness == 0) {
+    results.dead_count++;
+  } else if (test_fitness < neut_min) {
+    results.neg_count++;
+    results.neg_size += test_fitness;
+  } else if (test_fitness <= neut_max) {
+    results.neut_count++;
+  } else {
+    results.pos_count++;
+    results.pos_size += test_fitness;
+    if (test_fitness > results.peak_fitness) {
+      results.peak_fitness = test_fitness;
+      results.peak_genome = in_genome;
+    }
+  }
+  
+  return test_fitness;
+}
+
+
 // For distances greater than one, this needs to be called recursively.
 
-void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome,
-                              int cur_distance, int start_line)
+void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, sSiteResults& results,
+                              Genome& cur_genome, int cur_distance, int start_line, int end_line)
 {
-  const int max_line = base_genome.GetSize() - cur_distance + 1;
+  const int max_line = (end_line >= 0) ? end_line : base_genome.GetSize() - cur_distance + 1;
   const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.GetInstSet()).GetSize();
   
   Genome mg(cur_genome);
@@ -184,10 +303,9 @@ void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur
       
       mod_genome[line_num].SetOp(inst_num);
       if (cur_distance <= 1) {
-        ProcessGenome(ctx, testcpu, mg);
-        if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+        if (ProcessSiteGenome(ctx, testcpu, test_info, results, mg) >= neut_min) results.site_count[line_num]++;
       } else {
-        Process_Body(ctx, testcpu, mg, cur_distance - 1, line_num + 1);
+        Process_Body(ctx, testcpu, test_info, results, mg, cur_distance - 1, line_num + 1);
       }
     }
     
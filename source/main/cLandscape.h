@@ -23,6 +23,7 @@
 #ifndef cLandscape_h
 #define cLandscape_h
 
+#include "apto/core.h"
 #include "avida/core/Genome.h"
 
 #ifndef cCPUTestInfo_h
@@ -31,10 +32,14 @@
 #ifndef cString_h
 #include "cString.h"
 #endif
+#ifndef tArray_h
+#include "tArray.h"
+#endif
 #ifndef tMatrix_h
 #include "tMatrix.h"
 #endif
 
+class cAnalyzeJobQueue;
 class cAvidaContext;
 class cDataFile;
 class cInstSet;
@@ -95,6 +100,32 @@ private:
   tMatrix<double> fitness_chart; // Chart of all one-step mutations.
   
   int m_num_found;
+  
+  // Full landscapes are computed independently for each first mutated site, then reduced in site order so that the
+  // results do not depend on whether (or how) the sites were spread across the analyze job queue.
+  struct sSiteResults
+  {
+    double total_fitness;
+    double total_sqr_fitness;
+    int total_count;
+    int dead_count;
+    int neg_count;
+    int neut_count;
+    int pos_count;
+    double pos_size;
+    double neg_size;
+    double peak_fitness;
+    Genome peak_genome;
+    tArray<int> site_count;
+    
+    sSiteResults() : total_fitness(0.0), total_sqr_fitness(0.0), total_count(0), dead_count(0), neg_count(0),
+      neut_count(0), pos_count(0), pos_size(0.0), neg_size(0.0), peak_fitness(0.0) { ; }
+  };
+  tArray<sSiteResults> m_site_results;
+  
+  Apto::Mutex m_mutex;
+  int m_cur_site;
+  int m_completed;
 
 
   cLandscape(); // @not_implemented
@@ -108,6 +139,8 @@ public:
   void Reset(const Genome& in_genome);
 
   void Process(cAvidaContext& ctx);
+  void ProcessParallel(cAvidaContext& ctx, cAnalyzeJobQueue& jobqueue);
+  void ProcessSite(cAvidaContext& ctx);
   void ProcessDelete(cAvidaContext& ctx);
   void ProcessInsert(cAvidaContext& ctx);
   void PredictWProcess(cAvidaContext& ctx, cDataFile& df, int update = -1);
@@ -177,7 +210,13 @@ private:
   void BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu);
   double ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome);
   void ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu);
-  void Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome, int cur_distance, int start_line);
+  void Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, sSiteResults& results,
+                    Genome& cur_genome, int cur_distance, int start_line, int end_line = -1);
+  double ProcessSiteGenome(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, sSiteResults& results,
+                           Genome& in_genome);
+  void SetupSites();
+  void ProcessSite_Body(cAvidaContext& ctx, cTestCPU* testcpu, cCPUTestInfo& test_info, int site);
+  void CompleteSites();
   
   double TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mod_genome, int line1, int line2,
                      const cInstruction& mut1, const cInstruction& mut2);  
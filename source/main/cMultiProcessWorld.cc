@@ -38,12 +38,13 @@
 #include "cPopulationCell.h"
 #include "cMultiProcessWorld.h"
 #include "nGeometry.h"
-#include <map>
+#include <boost/serialization/vector.hpp>
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <cmath>
-#include <boost/optional.hpp>
+#include <cstring>
 
 using namespace Avida;
 
@@ -52,18 +53,25 @@ using namespace Avida;
 static const char* UPDATE="mean update time [ut]";
 static const char* POSTUPDATE="mean post-update time [post]";
 static const char* CALCUPDATE="mean calc-update time [calc]";
+static const char* UPDATECOST="mean update cost [cost]";
+static const char* IMBALANCE="update cost imbalance [max/mean]";
+static const char* SHED="organisms shed for load balancing [shed]";
 
 /*! Message that is sent from one cMultiProcessWorld to another during organism
  migration.
+ 
+ Migrants are packed back-to-back into a single binary buffer per destination
+ world per update.  Each record is a fixed-size header followed by the instruction
+ set name and the instruction opcodes, one byte each.  All worlds in a universe run
+ the same binary, so native byte order and type sizes are used.
  */
 struct migration_message {
 	//! Default constructor.
 	migration_message() { }
 	
 	//! Initializing constructor.
-	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage)
-	: _merit(merit), _lineage(lineage) {
-		_genome = org->GetGenome().AsString();
+	migration_message(cOrganism* org, const cPopulationCell& cell, double merit, int lineage, bool balance=false)
+	: _genome(org->GetGenome()), _merit(merit), _lineage(lineage), _balance(balance) {
 		cell.GetPosition(_x, _y);
 		_generation = org->GetPhenotype().GetGeneration();
 	}
@@ -74,20 +82,66 @@ struct migration_message {
 		org->GetPhenotype().SetGeneration(_generation);
 	}	
 	
-	//! Serializer, used to (de)marshal organisms for migration.
-	template<class Archive>
-	void serialize(Archive & ar, const unsigned int version) {
-		ar & _genome & _merit & _lineage & _x & _y & _generation;
+	//! Append this message to a packed buffer.
+	void pack(std::vector<char>& buf) const {
+		const cString& inst_set = _genome.GetInstSet();
+		const Sequence& seq = _genome.GetSequence();
+		header h = { _merit, _genome.GetHardwareType(), inst_set.GetSize(), seq.GetSize(), _lineage, _x, _y, _generation, _balance };
+		
+		const std::size_t offset = buf.size();
+		buf.resize(offset + sizeof(header) + h.inst_set_len + h.seq_len);
+		char* p = &buf[offset];
+		std::memcpy(p, &h, sizeof(header));
+		p += sizeof(header);
+		if (h.inst_set_len) std::memcpy(p, static_cast<const char*>(inst_set), h.inst_set_len);
+		p += h.inst_set_len;
+		for (int i = 0; i < h.seq_len; ++i) p[i] = static_cast<char>(seq[i].GetOp());
+	}
+	
+	//! Read the message starting at p, returning a pointer just past it.
+	const char* unpack(const char* p) {
+		header h;
+		std::memcpy(&h, p, sizeof(header));
+		p += sizeof(header);
+		
+		Sequence seq(h.seq_len);
+		for (int i = 0; i < h.seq_len; ++i) seq[i].SetOp(static_cast<unsigned char>(p[h.inst_set_len + i]));
+		_genome = Genome(h.hw_type, cString(p, h.inst_set_len), seq);
+		
+		_merit = h.merit;
+		_lineage = h.lineage;
+		_x = h.x;
+		_y = h.y;
+		_generation = h.generation;
+		_balance = (h.balance != 0);
+		return p + h.inst_set_len + h.seq_len;
 	}
 	
-	std::string _genome; //!< Genome of the migrating organism.
+	//! Fixed-size portion of a packed migrant.
+	struct header {
+		double merit;
+		int hw_type;
+		int inst_set_len;
+		int seq_len;
+		int lineage;
+		int x;
+		int y;
+		int generation;
+		int balance;
+	};
+	
+	Genome _genome; //!< Genome of the migrating organism.
 	double _merit; //!< Merit of this organism in its originating population.
 	int _lineage; //!< Lineage label of this organism in its orginating population.
 	int _x; //!< X-coordinate of the cell from which this migrant originated.
 	int _y; //!< Y-coordinate of the cell from which this migrant originated.
 	int _generation; //!< Generation of this organism.
+	bool _balance; //!< True if this organism was moved for load balancing rather than by migration.
 };
 
+//! Tag used for the neighbor-only migrant exchange.
+static const int MIGRANT_TAG=1;
+
 
 /*! Create and initialize a cMultiProcessWorld.
  */
@@ -114,7 +168,9 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 , m_universe_dim(0)
 , m_universe_x(0)
 , m_universe_y(0)
-, m_universe_popsize(-1) {
+, m_universe_popsize(-1)
+, m_cost_accum(0.0)
+, m_cost_updates(0) {
 	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
 		// there are a couple bugs in spatial that still need to be worked out:
 		// specifically, what to do about size(1) universes?
@@ -128,7 +184,19 @@ cMultiProcessWorld::cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, bo
 		// where is *this* world in the universe?
 		m_universe_x = m_mpi_world.rank() % m_universe_dim;
 		m_universe_y = m_mpi_world.rank() / m_universe_dim;
+		
+		// spatial migrants only ever travel to the (wrapped) worlds left, right, below, and above:
+		const int left = m_universe_y * m_universe_dim + (m_universe_x + m_universe_dim - 1) % m_universe_dim;
+		const int right = m_universe_y * m_universe_dim + (m_universe_x + 1) % m_universe_dim;
+		const int down = ((m_universe_y + m_universe_dim - 1) % m_universe_dim) * m_universe_dim + m_universe_x;
+		const int up = ((m_universe_y + 1) % m_universe_dim) * m_universe_dim + m_universe_x;
+		const int nbrs[] = { left, right, down, up };
+		m_neighbors.assign(nbrs, nbrs + 4);
+		std::sort(m_neighbors.begin(), m_neighbors.end());
+		m_neighbors.erase(std::unique(m_neighbors.begin(), m_neighbors.end()), m_neighbors.end());
 	}
+	
+	m_outbox.resize(m_mpi_world.size());
 }
 
 
@@ -146,20 +214,22 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 	// which world is this organism migrating to?
 	switch(GetConfig().BIRTH_METHOD.Get()) {
 		case POSITION_OFFSPRING_RANDOM: { // spatial, random in neighborhood
+			// neighbors wrap around the universe; on a bounded grid, IsWorldBoundary() has
+			// already ruled out migrations off the edge of the universe.
 			int x, y;
 			cell.GetPosition(x,y);
 			if(x == 0) {
 				// migrate left
-				dst_world = m_mpi_world.rank() - 1;
+				dst_world = m_universe_y * m_universe_dim + (m_universe_x + m_universe_dim - 1) % m_universe_dim;
 			} else if(x == (GetConfig().WORLD_X.Get()-1)) {
 				// migrate right
-				dst_world = m_mpi_world.rank() + 1;
+				dst_world = m_universe_y * m_universe_dim + (m_universe_x + 1) % m_universe_dim;
 			} else if(y == 0) {
 				// migrate down
-				dst_world = m_mpi_world.rank() - m_universe_dim;
+				dst_world = ((m_universe_y + m_universe_dim - 1) % m_universe_dim) * m_universe_dim + m_universe_x;
 			} else if(y == (GetConfig().WORLD_Y.Get()-1)) {
 				// migrate up
-				dst_world = m_mpi_world.rank() + m_universe_dim;
+				dst_world = ((m_universe_y + 1) % m_universe_dim) * m_universe_dim + m_universe_x;
 			}
 			break;
 		}
@@ -184,9 +254,9 @@ void cMultiProcessWorld::MigrateOrganism(cOrganism* org, const cPopulationCell&
 	assert(dst_world < m_mpi_world.size());
 	assert(dst_world >= 0);
 
-	// the tag is set to the number of messages previously sent; this is to allow
-	// the receiver to sort messages for consistency.
-	m_reqs.push_back(m_mpi_world.isend(dst_world, m_reqs.size(), migration_message(org, cell, merit.GetDouble(), lineage)));
+	// migrants are buffered per destination and sent as a single message in ProcessPostUpdate;
+	// the order in which they are packed is the order in which they will be injected.
+	migration_message(org, cell, merit.GetDouble(), lineage).pack(m_outbox[dst_world]);
 	
 	// stats tracking:
 	GetStats().OutgoingMigrant(org);
@@ -259,17 +329,19 @@ bool cMultiProcessWorld::IsWorldBoundary(const cPopulationCell& cell) {
 /*! Process post-update events.
  
  This method is called after each update of the local population completes.  Here
- we check to see if this world has received any migrants from other worlds, and if
- so, we inject them into the local population.  Note that this is an unconditional
- injection -- that is, migrants are "pushed" to this world.
+ we exchange the migrants buffered during the update with the other worlds, and
+ inject the ones we received into the local population.  Note that this is an
+ unconditional injection -- that is, migrants are "pushed" to this world.
  
- Migrants are injected according to BIRTH_METHOD.
+ Each world sends exactly one packed buffer to each world it may migrate to (possibly
+ empty), so no barrier or probing is needed to know that everything has arrived.  In
+ spatial universes only the neighboring worlds take part in the exchange; under mass
+ action every world may receive from every other, and an all-to-all is used.
  
- \todo What to do about cross-world lineage labels?
+ Migrants are injected according to BIRTH_METHOD, ordered by source rank and then by
+ the order in which they were sent, so runs are reproducible.
  
- \todo At the moment, this method forces synchronization on update boundaries across
- *all* worlds.  This could slow things down quite a bit, so we may need to consider a
- second mode that relaxes consistency in favor of speed.
+ \todo What to do about cross-world lineage labels?
  */
 void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 	namespace mpi = boost::mpi;
@@ -279,36 +351,168 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 	m_pf[UPDATE] = m_update_timer.elapsed();
 	m_post_update_timer.restart();
 	
-	// wait until we're sure that this process has sent all its messages:
-	mpi::wait_all(m_reqs.begin(), m_reqs.end());
-	m_reqs.clear();
+	// the cost of an update is the time spent on it, less any time spent waiting on the
+	// other worlds while calculating the update size:
+	double cost = m_pf[UPDATE];
+	cStats::profiling_stats_t::iterator calc = m_pf.find(CALCUPDATE);
+	if(calc != m_pf.end()) {
+		cost = std::max(0.0, cost - calc->second);
+	}
+	m_pf[UPDATECOST] = cost;
+	
+	if(GetConfig().MP_LOAD_BALANCE.Get()) {
+		m_cost_accum += cost;
+		if(++m_cost_updates >= std::max(1, GetConfig().MP_LOAD_BALANCE_INTERVAL.Get())) {
+			balanceLoad(ctx);
+			m_cost_accum = 0.0;
+			m_cost_updates = 0;
+		}
+	}
+	
+	std::vector<std::vector<char> > inbox(m_mpi_world.size());
+	if(GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
+		exchangeWithNeighbors(inbox);
+	} else {
+		mpi::all_to_all(m_mpi_world, m_outbox, inbox);
+	}
+	
+	for(std::size_t i=0; i<m_outbox.size(); ++i) {
+		m_outbox[i].clear();
+	}
+	
+	injectMigrants(ctx, inbox);
+
+	// record profiling stats:
+	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
+	GetStats().ProfilingData(m_pf);
+	m_pf.clear();
+	
+	// restart the update timer!
+	m_update_timer.restart();
+}
+
+
+/*! Shed organisms from this world if it is costing the universe more than its share.
+ 
+ Every world gathers the update cost of all worlds, accumulated over the last
+ MP_LOAD_BALANCE_INTERVAL updates.  Since the barrier-free exchange still forces all
+ worlds to proceed in lock-step, the slowest world sets the pace of the universe.  A
+ world whose cost exceeds MP_LOAD_BALANCE_THRESHOLD times the mean moves a fraction of
+ its organisms (chosen at random) to worlds with below-mean costs, each destination
+ chosen in proportion to how far under the mean it is.  The shed organisms are packed
+ into the outbox with this update's migrants and placed in empty cells at their
+ destination, when there are any.
+ 
+ Only mass action universes are balanced: in spatial universes an organism's location
+ is part of the model, and moving whole sub-populations would change it.
+ */
+void cMultiProcessWorld::balanceLoad(cAvidaContext& ctx) {
+	namespace mpi = boost::mpi;
+	
+	std::vector<double> costs;
+	mpi::all_gather(m_mpi_world, m_cost_accum, costs);
 	
-	// at this point, we know that *this* process has sent everything.  but, we don't
-	// know if it's *received* everything.  so, we're going to put in a synchronization
-	// barrier, which means that every process must reach the barrier before any are allowed
-	// to proceed.  since we just finished waiting for all communication to complete,
-	// this means that all messages must have been received, too.
-	m_mpi_world.barrier();	
+	double mean = 0.0, max_cost = 0.0;
+	for(std::size_t i=0; i<costs.size(); ++i) {
+		mean += costs[i];
+		max_cost = std::max(max_cost, costs[i]);
+	}
+	mean /= costs.size();
+	if(mean <= 0.0) {
+		return;
+	}
+	m_pf[IMBALANCE] = max_cost / mean;
 	
-	// now, receive all the messages, but store them in order by source and tag:
-	typedef std::map<int,migration_message> rx_tag_t;
-	typedef std::map<int,rx_tag_t> rx_src_t;
-	rx_src_t recvd;
-	optional<mpi::status> s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);
-	while(s.is_initialized()) {
-		migration_message msg;
-		m_mpi_world.recv(s->source(), s->tag(), msg);
-		recvd[s->source()][s->tag()] = msg;		
-		// any others?
-		s = m_mpi_world.iprobe(mpi::any_source,mpi::any_tag);		
+	const double local = costs[m_mpi_world.rank()];
+	int shed = 0;
+	if((GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_FULL_SOUP_RANDOM)
+		 && (local > GetConfig().MP_LOAD_BALANCE_THRESHOLD.Get() * mean)) {
+		// destinations are the under-loaded worlds, weighted by their slack:
+		std::vector<double> slack(costs.size(), 0.0);
+		double total_slack = 0.0;
+		int last_dst = 0;
+		for(std::size_t i=0; i<costs.size(); ++i) {
+			if(costs[i] < mean) {
+				slack[i] = mean - costs[i];
+				total_slack += slack[i];
+				last_dst = i;
+			}
+		}
+		
+		if(total_slack > 0.0) {
+			// cost is taken to scale with population size; never move more than half the
+			// population at once, so that a noisy measurement can't empty a world.
+			cPopulation& pop = GetPopulation();
+			std::vector<int> occupied;
+			occupied.reserve(pop.GetNumOrganisms());
+			for(int i=0; i<pop.GetSize(); ++i) {
+				if(pop.GetCell(i).IsOccupied()) {
+					occupied.push_back(i);
+				}
+			}
+			const double fraction = std::min(0.5, 1.0 - (mean / local));
+			const int num_shed = static_cast<int>(fraction * occupied.size());
+			
+			for(int i=0; i<num_shed; ++i) {
+				// partial Fisher-Yates shuffle selects the organisms to shed:
+				const int j = i + GetRandom().GetInt(occupied.size() - i);
+				std::swap(occupied[i], occupied[j]);
+				cPopulationCell& cell = pop.GetCell(occupied[i]);
+				cOrganism* org = cell.GetOrganism();
+				
+				double r = GetRandom().GetDouble(total_slack);
+				int dst_world = 0;
+				while((dst_world < last_dst) && ((slack[dst_world] == 0.0) || (r >= slack[dst_world]))) {
+					r -= slack[dst_world];
+					++dst_world;
+				}
+				
+				migration_message(org, cell, org->GetPhenotype().GetMerit().GetDouble(), org->GetLineageLabel(), true).pack(m_outbox[dst_world]);
+				GetStats().OutgoingMigrant(org);
+				pop.KillOrganism(cell, ctx, false); // moved, not dead
+				++shed;
+			}
+		}
 	}
+	m_pf[SHED] = shed;
+}
+
+
+/*! Exchange packed migrants with the neighboring worlds only.
+ 
+ Messages between a pair of ranks with the same tag are non-overtaking, so the buffer
+ received from each neighbor is always the one it sent for this update.
+ */
+void cMultiProcessWorld::exchangeWithNeighbors(std::vector<std::vector<char> >& inbox) {
+	namespace mpi = boost::mpi;
 	
-	// iterate over received messages in-order, injecting genomes into our population:
-	for(rx_src_t::iterator i=recvd.begin(); i!=recvd.end(); ++i) {
-		for(rx_tag_t::iterator j=i->second.begin(); j!=i->second.end(); ++j) {
-			//std::cerr << "**********  INJECTING *********** " << i->first << " " << j->first << std::endl;
+	std::vector<mpi::request> reqs;
+	reqs.reserve(2 * m_neighbors.size());
+	for(std::size_t i=0; i<m_neighbors.size(); ++i) {
+		reqs.push_back(m_mpi_world.irecv(m_neighbors[i], MIGRANT_TAG, inbox[m_neighbors[i]]));
+	}
+	for(std::size_t i=0; i<m_neighbors.size(); ++i) {
+		reqs.push_back(m_mpi_world.isend(m_neighbors[i], MIGRANT_TAG, m_outbox[m_neighbors[i]]));
+	}
+	mpi::wait_all(reqs.begin(), reqs.end());
+}
+
+
+/*! Inject all migrants in the inbox, in order of source rank and then send order.
+ */
+void cMultiProcessWorld::injectMigrants(cAvidaContext& ctx, const std::vector<std::vector<char> >& inbox) {
+	for(std::size_t src=0; src<inbox.size(); ++src) {
+		const std::vector<char>& buf = inbox[src];
+		if(buf.empty()) {
+			continue;
+		}
+		
+		const char* p = &buf[0];
+		const char* end = p + buf.size();
+		while(p < end) {
 			// ok, add this migrant to the current population
-			migration_message& migrant = j->second;
+			migration_message migrant;
+			p = migrant.unpack(p);
 			int target_cell=-1;
 			
 			switch(GetConfig().BIRTH_METHOD.Get()) {
@@ -320,7 +524,13 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 					break;
 				}
 				case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action
-					target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+					// organisms moved for load balancing go to an empty cell, if there is one:
+					if(migrant._balance) {
+						target_cell = GetPopulation().FindRandEmptyCell();
+					}
+					if(target_cell < 0) {
+						target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+					}
 					break;
 				}
 				default: {
@@ -330,29 +540,14 @@ void cMultiProcessWorld::ProcessPostUpdate(cAvidaContext& ctx) {
 			
 			GetPopulation().InjectGenome(target_cell,
 																	 SRC_ORGANISM_RANDOM, // for right now, we'll treat this as a random organism injection
-																	 Genome(cString(migrant._genome.c_str())), // genome unpacked from message
+																	 migrant._genome, // genome unpacked from message
 																	 ctx, migrant._lineage); // lineage label
 			// unpack the rest from the message:
 			migrant.unpack(GetPopulation().GetCell(target_cell).GetOrganism());
 			GetStats().IncomingMigrant(GetPopulation().GetCell(target_cell).GetOrganism());
 		}
+		assert(p == end);
 	}
-	
-	// oh, sweet sanity; make sure that we actually processed all messages.
-	assert(!m_mpi_world.iprobe(mpi::any_source,mpi::any_tag).is_initialized());
-	
-	// finally, we need another barrier down here, in the off chance that one of the
-	// processes is really speedy and manages to migrate another org to this world
-	// before we finished the probe-loop.
-	m_mpi_world.barrier();
-
-	// record profiling stats:
-	m_pf[POSTUPDATE] = m_post_update_timer.elapsed();
-	GetStats().ProfilingData(m_pf);
-	m_pf.clear();
-	
-	// restart the update timer!
-	m_update_timer.restart();
 }
 
 
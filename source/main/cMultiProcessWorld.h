@@ -50,17 +50,29 @@ class cMultiProcessWorld : public cWorld
 	protected:
 		boost::mpi::environment& m_mpi_env; //!< MPI environment.
 		boost::mpi::communicator& m_mpi_world; //!< World-wide MPI communicator.
-		std::vector<boost::mpi::request> m_reqs; //!< Requests outstanding since the last ProcessPostUpdate.
+		std::vector<std::vector<char> > m_outbox; //!< Packed migrants for each destination rank, sent in ProcessPostUpdate.
+		std::vector<int> m_neighbors; //!< Ranks of the neighboring worlds (spatial universes only), in ascending order.
 		int m_universe_dim; //!< Dimension (x & y) of the universe (number of worlds along the side of a grid of worlds).
 		int m_universe_x; //!< X coordinate of this world.
 		int m_universe_y; //!< Y coordinate of this world.
 		int m_universe_popsize; //!< Total size of the universe, delayed one update.
+		double m_cost_accum; //!< Update cost of this world accumulated since the last load balancing.
+		int m_cost_updates; //!< Number of updates accumulated in m_cost_accum.
 		
 		boost::timer m_update_timer; //!< Tracks the clock-time of updates.
 		boost::timer m_post_update_timer; //!< Tracks the clock-time of post-update processing.
 		boost::timer m_calc_update_timer; //!< Tracks the clock-time of calculating the update size.
 		cStats::profiling_stats_t m_pf; //!< Buffers profiling stats until the post-update step.
 		
+		//! Shed organisms to less loaded worlds if this world is costing more than its share (MP_LOAD_BALANCE).
+		void balanceLoad(cAvidaContext& ctx);
+		
+		//! Exchange packed migrants with the neighboring worlds only (spatial universes).
+		void exchangeWithNeighbors(std::vector<std::vector<char> >& inbox);
+		
+		//! Inject all migrants in the inbox, in order of source rank and then send order.
+		void injectMigrants(cAvidaContext& ctx, const std::vector<std::vector<char> >& inbox);
+		
 		//! Constructor (prefer Initialize).
 		cMultiProcessWorld(cAvidaConfig* cfg, const cString& cwd, boost::mpi::environment& env, boost::mpi::communicator& worldcomm);
 
@@ -0,0 +1,411 @@
+/*
+ *  cMultiThreadWorld.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cMultiThreadWorld.h"
+
+#include "avida/core/Genome.h"
+#include "avida/core/Sequence.h"
+
+#include "cAvidaConfig.h"
+#include "cDefaultRunDriver.h"
+#include "cMerit.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+#include "cUserFeedback.h"
+#include "nGeometry.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+using namespace Avida;
+
+
+/*! Create and initialize a cMultiThreadWorld.
+ */
+cMultiThreadWorld* cMultiThreadWorld::Initialize(cAvidaConfig* cfg, const cString& cwd, cMultiThreadUniverse* universe,
+                                                 int index, cUserFeedback* feedback)
+{
+  const int birth_method = cfg->BIRTH_METHOD.Get();
+  if (birth_method != POSITION_OFFSPRING_RANDOM && birth_method != POSITION_OFFSPRING_FULL_SOUP_RANDOM) {
+    if (feedback) feedback->Error("multi-threaded worlds only support BIRTH_METHODs 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM)");
+    return NULL;
+  }
+  if (birth_method == POSITION_OFFSPRING_RANDOM && universe->GetDimension() * universe->GetDimension() != universe->GetNumWorlds()) {
+    if (feedback) feedback->Error("spatial multi-threaded universes must be square");
+    return NULL;
+  }
+
+  cMultiThreadWorld* world = new cMultiThreadWorld(cfg, cwd, universe, index);
+  if (!world->setup(feedback)) {
+    delete world;
+    world = NULL;
+  }
+  return world;
+}
+
+
+cMultiThreadWorld::cMultiThreadWorld(cAvidaConfig* cfg, const cString& cwd, cMultiThreadUniverse* universe, int index)
+: cWorld(cfg, cwd)
+, m_universe(universe)
+, m_index(index)
+, m_universe_x(index % universe->GetDimension())
+, m_universe_y(index / universe->GetDimension())
+, m_universe_popsize(-1)
+, m_universe_merit(0.0)
+, m_local_merit(0.0)
+, m_sent(0)
+, m_parity(0)
+, m_retired(universe->GetNumWorlds(), false)
+{
+}
+
+
+/*! Migrate this organism to a different world.
+
+ Destinations are chosen exactly as in cMultiProcessWorld.  The migrant is packed onto
+ this world's mailbox at the destination for the current update parity, which no other
+ thread writes; migrants bound for worlds that have finished running are dropped.
+ */
+void cMultiThreadWorld::MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage)
+{
+  assert(org != NULL);
+  const int num_worlds = m_universe->GetNumWorlds();
+  const int dim = m_universe->GetDimension();
+  int dst_world = -1;
+
+  switch (GetConfig().BIRTH_METHOD.Get()) {
+    case POSITION_OFFSPRING_RANDOM: { // spatial, neighbors wrap around the universe
+      int x, y;
+      cell.GetPosition(x, y);
+      if (x == 0) {
+        dst_world = m_universe_y * dim + (m_universe_x + dim - 1) % dim;
+      } else if (x == (GetConfig().WORLD_X.Get() - 1)) {
+        dst_world = m_universe_y * dim + (m_universe_x + 1) % dim;
+      } else if (y == 0) {
+        dst_world = ((m_universe_y + dim - 1) % dim) * dim + m_universe_x;
+      } else if (y == (GetConfig().WORLD_Y.Get() - 1)) {
+        dst_world = ((m_universe_y + 1) % dim) * dim + m_universe_x;
+      }
+      break;
+    }
+    case POSITION_OFFSPRING_FULL_SOUP_RANDOM: { // mass action, never back to this world unless it is the only one
+      if (num_worlds == 1) {
+        dst_world = 0;
+      } else {
+        dst_world = GetRandom().GetInt(num_worlds - 1);
+        if (dst_world >= m_index) ++dst_world;
+      }
+      break;
+    }
+    default:
+      GetDriver().RaiseFatalException(-1, "Multi-threaded worlds only support BIRTH_METHODs 0 (POSITION_OFFSPRING_RANDOM) and 4 (POSITION_OFFSPRING_FULL_SOUP_RANDOM).");
+  }
+
+  assert(dst_world >= 0 && dst_world < num_worlds);
+
+  GetStats().OutgoingMigrant(org);
+  if (m_retired[dst_world]) return;
+
+  const Genome& genome = org->GetGenome();
+  const cString& inst_set = genome.GetInstSet();
+  const Sequence& seq = genome.GetSequence();
+
+  cMultiThreadUniverse::sMigrant migrant;
+  migrant.merit = merit.GetDouble();
+  migrant.hw_type = genome.GetHardwareType();
+  migrant.inst_set_len = inst_set.GetSize();
+  migrant.seq_len = seq.GetSize();
+  migrant.lineage = lineage;
+  cell.GetPosition(migrant.x, migrant.y);
+  migrant.generation = org->GetPhenotype().GetGeneration();
+
+  cMultiThreadUniverse::tMailbox& outbox = m_universe->mailbox(m_parity, dst_world, m_index);
+  const std::size_t offset = outbox.size();
+  outbox.resize(offset + sizeof(migrant) + migrant.inst_set_len + migrant.seq_len);
+  char* p = &outbox[offset];
+  std::memcpy(p, &migrant, sizeof(migrant));
+  p += sizeof(migrant);
+  if (migrant.inst_set_len) std::memcpy(p, static_cast<const char*>(inst_set), migrant.inst_set_len);
+  p += migrant.inst_set_len;
+  for (int i = 0; i < migrant.seq_len; i++) p[i] = static_cast<char>(seq[i].GetOp());
+  m_sent++;
+}
+
+
+/*! Returns true if an organism should be migrated to a different world, as in cMultiProcessWorld.
+ */
+bool cMultiThreadWorld::TestForMigration()
+{
+  if (GetConfig().BIRTH_METHOD.Get() != POSITION_OFFSPRING_FULL_SOUP_RANDOM) return false;
+
+  const int num_worlds = m_universe->GetNumWorlds();
+  if (num_worlds == 1) return true; // 1 world == always migrate
+  return GetRandom().P((double)(num_worlds - 1) / (double)num_worlds);
+}
+
+
+/*! Returns true if the given cell is on the boundary of the world, false otherwise.
+ */
+bool cMultiThreadWorld::IsWorldBoundary(const cPopulationCell& cell)
+{
+  if (GetConfig().BIRTH_METHOD.Get() != POSITION_OFFSPRING_RANDOM) return false;
+
+  const int world_x = GetConfig().WORLD_X.Get();
+  const int world_y = GetConfig().WORLD_Y.Get();
+  int x, y;
+  cell.GetPosition(x, y);
+
+  // cells in the interior of this world can never cause a migration, regardless of geometry
+  if (!(x == 0 || x == (world_x - 1) || y == 0 || y == (world_y - 1))) return false;
+
+  switch (GetConfig().WORLD_GEOMETRY.Get()) {
+    case nGeometry::GRID: { // bounded grid, the edges of the universe do not migrate
+      const int dim = m_universe->GetDimension();
+      const int uni_x = x + world_x * m_universe_x;
+      const int uni_y = y + world_y * m_universe_y;
+      return !(uni_x == 0 || uni_x == (world_x * dim - 1) || uni_y == 0 || uni_y == (world_y * dim - 1));
+    }
+    case nGeometry::TORUS:
+      return true;
+    default:
+      GetDriver().RaiseFatalException(-1, "Only bounded grid and toroidal geometries are supported for cell migration.");
+  }
+  return false;
+}
+
+
+/*! Process post-update events.
+
+ Publishes this world's population size and merit, waits for every running world to
+ finish the update, then injects the migrants sent to this world during the update.
+ Migrants are injected in order of source world and then send order, so runs with the
+ same seeds are reproducible regardless of thread scheduling.
+
+ Migrants still in the mailboxes are counted with the population size so that the
+ universe never looks empty while organisms are in flight.
+ */
+void cMultiThreadWorld::ProcessPostUpdate(cAvidaContext& ctx)
+{
+  const int parity = m_parity;
+
+  double merit = 0.0;
+  if (GetConfig().MP_SCHEDULING_STYLE.Get() == MP_SCHEDULING_INTEGRATED) {
+    // there's no clean way to do this across the different schedulers in avida, so sum them
+    for (int i = 0; i < GetPopulation().GetSize(); i++) {
+      cPopulationCell& cell = GetPopulation().GetCell(i);
+      if (cell.IsOccupied()) merit += cell.GetOrganism()->GetPhenotype().GetMerit().GetDouble();
+    }
+  }
+  m_local_merit = merit;
+
+  m_universe->syncWorlds(m_index, GetPopulation().GetNumOrganisms() + m_sent, merit,
+                         m_universe_popsize, m_universe_merit, m_retired);
+  m_sent = 0;
+  m_parity ^= 1;
+
+  const int world_x = GetConfig().WORLD_X.Get();
+  const int world_y = GetConfig().WORLD_Y.Get();
+  for (int src = 0; src < m_universe->GetNumWorlds(); src++) {
+    cMultiThreadUniverse::tMailbox& inbox = m_universe->mailbox(parity, m_index, src);
+    const char* p = inbox.empty() ? NULL : &inbox[0];
+    const char* end = p + inbox.size();
+    while (p < end) {
+      cMultiThreadUniverse::sMigrant migrant;
+      std::memcpy(&migrant, p, sizeof(migrant));
+      p += sizeof(migrant);
+
+      // the genome is built from the raw bytes, so that it shares nothing with the source world
+      Sequence seq(migrant.seq_len);
+      for (int i = 0; i < migrant.seq_len; i++) seq[i].SetOp(static_cast<unsigned char>(p[migrant.inst_set_len + i]));
+      Genome genome(migrant.hw_type, cString(p, migrant.inst_set_len), seq);
+      p += migrant.inst_set_len + migrant.seq_len;
+
+      int target_cell = -1;
+      if (GetConfig().BIRTH_METHOD.Get() == POSITION_OFFSPRING_RANDOM) {
+        // invert the originating cell
+        const int x = world_x - migrant.x - 1;
+        const int y = world_y - migrant.y - 1;
+        target_cell = world_x * y + x;
+      } else {
+        target_cell = GetRandom().GetInt(GetPopulation().GetSize());
+      }
+
+      GetPopulation().InjectGenome(target_cell, SRC_ORGANISM_RANDOM, genome, ctx, migrant.lineage);
+      cOrganism* org = GetPopulation().GetCell(target_cell).GetOrganism();
+      org->UpdateMerit(migrant.merit);
+      org->GetPhenotype().SetGeneration(migrant.generation);
+      GetStats().IncomingMigrant(org);
+    }
+    inbox.clear();
+  }
+}
+
+
+/*! Returns true if this world allows early exits, i.e., once the whole universe is empty.
+ */
+bool cMultiThreadWorld::AllowsEarlyExit() const
+{
+  return (m_universe_popsize == 0);
+}
+
+
+/*! Calculate the size (in virtual CPU cycles) of the current update.
+
+ Under MP_SCHEDULING_INTEGRATED the update is scaled by this world's share of the
+ universe's merit, using the totals gathered at the end of the previous update.
+ */
+int cMultiThreadWorld::CalculateUpdateSize()
+{
+  switch (GetConfig().MP_SCHEDULING_STYLE.Get()) {
+    case MP_SCHEDULING_NULL:
+      return cWorld::CalculateUpdateSize();
+
+    case MP_SCHEDULING_INTEGRATED:
+      // no totals before the first update completes
+      if (m_universe_popsize < 0 || m_universe_merit <= 0.0) return cWorld::CalculateUpdateSize();
+      return (int)((m_local_merit / m_universe_merit) * GetConfig().AVE_TIME_SLICE.Get() * m_universe_popsize);
+
+    default:
+      GetDriver().RaiseFatalException(-1, "Unrecognized MP_SCHEDULING_STYLE.");
+  }
+  return 0;
+}
+
+
+
+cMultiThreadUniverse::cMultiThreadUniverse(int num_worlds)
+: m_num_worlds(num_worlds)
+, m_dim((int)std::sqrt((double)num_worlds))
+, m_worlds(num_worlds, (cMultiThreadWorld*)NULL)
+, m_drivers(num_worlds, (cDefaultRunDriver*)NULL)
+, m_threads(num_worlds, (cWorldThread*)NULL)
+, m_participants(num_worlds)
+, m_waiting(0)
+, m_generation(0)
+, m_retired(num_worlds, false)
+, m_popsizes(num_worlds, 0)
+, m_merits(num_worlds, 0.0)
+, m_total_popsize(0)
+, m_total_merit(0.0)
+{
+  assert(num_worlds > 0);
+  if (m_dim < 1) m_dim = 1;
+  m_mailboxes[0].resize(num_worlds * num_worlds);
+  m_mailboxes[1].resize(num_worlds * num_worlds);
+}
+
+
+cMultiThreadUniverse::~cMultiThreadUniverse()
+{
+  for (int i = 0; i < m_num_worlds; i++) {
+    delete m_threads[i];
+    delete m_drivers[i];
+  }
+}
+
+
+void cMultiThreadUniverse::SetWorld(int index, cMultiThreadWorld* world, cDefaultRunDriver* driver)
+{
+  assert(index >= 0 && index < m_num_worlds);
+  m_worlds[index] = world;
+  m_drivers[index] = driver;
+}
+
+
+void cMultiThreadUniverse::Run()
+{
+  for (int i = 0; i < m_num_worlds; i++) {
+    assert(m_drivers[i] != NULL);
+    m_threads[i] = new cWorldThread(this, i);
+    m_threads[i]->Start();
+  }
+  for (int i = 0; i < m_num_worlds; i++) m_threads[i]->Join();
+}
+
+
+void cMultiThreadUniverse::cWorldThread::Run()
+{
+  m_universe->m_drivers[m_index]->Run();
+  m_universe->retireWorld(m_index);
+}
+
+
+/*! End-of-update barrier.
+
+ Publishes the calling world's totals and blocks until every world still running has
+ arrived.  The universe totals and the set of retired worlds are returned to each
+ caller as they were when the barrier opened, so all worlds see identical values.
+ */
+void cMultiThreadUniverse::syncWorlds(int index, int popsize, double merit, int& total_popsize, double& total_merit,
+                                      std::vector<bool>& retired)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+
+  m_popsizes[index] = popsize;
+  m_merits[index] = merit;
+
+  const int generation = m_generation;
+  if (++m_waiting == m_participants) {
+    releaseWaiting();
+  } else {
+    while (generation == m_generation) m_cond.Wait(m_mutex);
+  }
+
+  total_popsize = m_total_popsize;
+  total_merit = m_total_merit;
+  retired = m_retired;
+}
+
+
+/*! Remove a world that has finished running from the barrier.
+ */
+void cMultiThreadUniverse::retireWorld(int index)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+
+  m_retired[index] = true;
+  m_popsizes[index] = 0;
+  m_merits[index] = 0.0;
+  m_participants--;
+
+  // the remaining worlds may all be waiting on this one
+  if (m_participants > 0 && m_waiting == m_participants) releaseWaiting();
+}
+
+
+// Must be called with m_mutex held
+void cMultiThreadUniverse::releaseWaiting()
+{
+  m_total_popsize = 0;
+  m_total_merit = 0.0;
+  for (int i = 0; i < m_num_worlds; i++) {
+    if (m_retired[i]) continue;
+    m_total_popsize += m_popsizes[i];
+    m_total_merit += m_merits[i];
+  }
+
+  m_waiting = 0;
+  m_generation++;
+  m_cond.Broadcast();
+}
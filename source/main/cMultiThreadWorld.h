@@ -0,0 +1,180 @@
+/*
+ *  cMultiThreadWorld.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cMultiThreadWorld_h
+#define cMultiThreadWorld_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+#include "cWorld.h"
+
+#include <vector>
+
+class cDefaultRunDriver;
+class cMultiThreadUniverse;
+class cUserFeedback;
+
+
+/*! Multi-threaded Avida world.
+
+ This is the shared-memory counterpart of cMultiProcessWorld: a universe of worlds,
+ each run by its own thread within a single process, connected through the same
+ "cross-world migration" model.  Migrants are handed off through per-world mailboxes
+ owned by the cMultiThreadUniverse and injected at the end of each update.
+ */
+class cMultiThreadWorld : public cWorld
+{
+private:
+  cMultiThreadUniverse* m_universe; //!< Universe that this world belongs to.
+  int m_index;                      //!< Index of this world in the universe.
+  int m_universe_x;                 //!< X coordinate of this world.
+  int m_universe_y;                 //!< Y coordinate of this world.
+  int m_universe_popsize;           //!< Total size of the universe as of the last update.
+  double m_universe_merit;          //!< Total merit of the universe as of the last update.
+  double m_local_merit;             //!< Total merit of this world as of the last update.
+  int m_sent;                       //!< Number of migrants sent during the current update.
+  int m_parity;                     //!< Mailbox buffer that migrants are currently sent to.
+  std::vector<bool> m_retired;      //!< Worlds that had finished running as of the last update.
+
+
+  cMultiThreadWorld(); // @not_implemented
+  cMultiThreadWorld(const cMultiThreadWorld&); // @not_implemented
+  cMultiThreadWorld& operator=(const cMultiThreadWorld&); // @not_implemented
+
+  cMultiThreadWorld(cAvidaConfig* cfg, const cString& cwd, cMultiThreadUniverse* universe, int index);
+
+public:
+  //! Create and initialize a cMultiThreadWorld as world index of the universe.
+  static cMultiThreadWorld* Initialize(cAvidaConfig* cfg, const cString& cwd, cMultiThreadUniverse* universe, int index,
+                                       cUserFeedback* feedback = NULL);
+
+  virtual ~cMultiThreadWorld() { ; }
+
+  int GetUniverseIndex() const { return m_index; }
+
+  //! Migrate this organism to a different world.
+  virtual void MigrateOrganism(cOrganism* org, const cPopulationCell& cell, const cMerit& merit, int lineage);
+
+  //! Returns true if an organism should be migrated to a different world, false otherwise.
+  virtual bool TestForMigration();
+
+  //! Returns true if the given cell is on the boundary of the world, false otherwise.
+  virtual bool IsWorldBoundary(const cPopulationCell& cell);
+
+  //! Process post-update events.
+  virtual void ProcessPostUpdate(cAvidaContext& ctx);
+
+  //! Returns true if this world allows early exits, e.g., when the population reaches 0.
+  virtual bool AllowsEarlyExit() const;
+
+  //! Calculate the size (in virtual CPU cycles) of the current update.
+  virtual int CalculateUpdateSize();
+};
+
+
+/*! A universe of cMultiThreadWorlds hosted in one process.
+
+ Every (source, destination) pair of worlds has its own mailbox, written only by the
+ source world's thread and read only by the destination's, so no locking is needed to
+ hand off migrants.  Mailboxes are double buffered on update parity: migrants sent
+ during an update are drained after the update barrier, while senders have already
+ moved on to the other buffer.  Migrants are packed into the mailboxes as plain bytes,
+ as in the Avida-MP message buffers, and their genomes are rebuilt by the destination
+ thread; string reference counts are not atomic, so no reference counted object may
+ be handed from one world to another.  The single barrier per update is the only point
+ where worlds synchronize; the last world to arrive also totals the population sizes
+ and merits published by every world, replacing the all_reduce calls of Avida-MP.
+ */
+class cMultiThreadUniverse
+{
+  friend class cMultiThreadWorld;
+private:
+  // Fixed-size portion of a migrant, followed in the mailbox by the instruction set name and one byte per instruction
+  struct sMigrant
+  {
+    double merit;
+    int hw_type;
+    int inst_set_len;
+    int seq_len;
+    int lineage;
+    int x;
+    int y;
+    int generation;
+  };
+  typedef std::vector<char> tMailbox;
+
+  class cWorldThread : public Apto::Thread
+  {
+  private:
+    cMultiThreadUniverse* m_universe;
+    int m_index;
+
+    void Run();
+
+  public:
+    cWorldThread(cMultiThreadUniverse* universe, int index) : m_universe(universe), m_index(index) { ; }
+  };
+
+  int m_num_worlds;
+  int m_dim;
+  std::vector<cMultiThreadWorld*> m_worlds;
+  std::vector<cDefaultRunDriver*> m_drivers;
+  std::vector<cWorldThread*> m_threads;
+
+  std::vector<tMailbox> m_mailboxes[2];  // [parity][dst * m_num_worlds + src]
+
+  // Barrier state, protected by m_mutex
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_cond;
+  int m_participants;
+  int m_waiting;
+  int m_generation;
+  std::vector<bool> m_retired;
+  std::vector<int> m_popsizes;
+  std::vector<double> m_merits;
+  int m_total_popsize;
+  double m_total_merit;
+
+
+  cMultiThreadUniverse(); // @not_implemented
+  cMultiThreadUniverse(const cMultiThreadUniverse&); // @not_implemented
+  cMultiThreadUniverse& operator=(const cMultiThreadUniverse&); // @not_implemented
+
+  tMailbox& mailbox(int parity, int dst, int src) { return m_mailboxes[parity][dst * m_num_worlds + src]; }
+  void syncWorlds(int index, int popsize, double merit, int& total_popsize, double& total_merit, std::vector<bool>& retired);
+  void retireWorld(int index);
+  void releaseWaiting();
+
+public:
+  cMultiThreadUniverse(int num_worlds);
+  ~cMultiThreadUniverse();
+
+  int GetNumWorlds() const { return m_num_worlds; }
+  int GetDimension() const { return m_dim; }
+
+  //! Set the world with the given index; the universe takes ownership of the driver, which owns the world.
+  void SetWorld(int index, cMultiThreadWorld* world, cDefaultRunDriver* driver);
+
+  //! Run every world in its own thread, returning once all have finished.
+  void Run();
+};
+
+#endif
@@ -133,3 +133,25 @@ void cMutationRates::Copy(const cMutationRates& in_muts)
   meta = in_muts.meta;
   update = in_muts.update;
 }
+
+// Returns true if any copy or divide mutation rate is non-zero, i.e. if a gestation cycle could be stochastic
+bool cMutationRates::HasGestationMutations() const
+{
+  if (copy.mut_prob > 0.0 || copy.ins_prob > 0.0 || copy.del_prob > 0.0 || copy.uniform_prob > 0.0 ||
+      copy.slip_prob > 0.0) return true;
+  
+  if (divide.ins_prob > 0.0 || divide.del_prob > 0.0 || divide.mut_prob > 0.0 || divide.uniform_prob > 0.0 ||
+      divide.slip_prob > 0.0 || divide.trans_prob > 0.0 || divide.lgt_prob > 0.0) return true;
+  
+  if (divide.divide_mut_prob > 0.0 || divide.divide_ins_prob > 0.0 || divide.divide_del_prob > 0.0 ||
+      divide.divide_uniform_prob > 0.0 || divide.divide_slip_prob > 0.0 || divide.divide_trans_prob > 0.0 ||
+      divide.divide_lgt_prob > 0.0) return true;
+  
+  if (divide.divide_poisson_mut_mean > 0.0 || divide.divide_poisson_ins_mean > 0.0 ||
+      divide.divide_poisson_del_mean > 0.0 || divide.divide_poisson_slip_mean > 0.0 ||
+      divide.divide_poisson_trans_mean > 0.0 || divide.divide_poisson_lgt_mean > 0.0) return true;
+  
+  if (divide.parent_mut_prob > 0.0 || divide.parent_ins_prob > 0.0 || divide.parent_del_prob > 0.0) return true;
+  
+  return (meta.copy_mut_prob > 0.0);
+}
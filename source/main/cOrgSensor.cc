@@ -24,6 +24,8 @@
 #include "cOrgSensor.h"
 
 #include "cEnvironment.h"
+#include "cOrgSpatialIndex.h"
+#include "cPopulation.h"
 #include "cResource.h"
 #include "cPopulationCell.h"  
 
@@ -276,10 +278,8 @@ cOrgSensor::sLookOut cOrgSensor::GlobalVal(cAvidaContext& ctx, const int habitat
 {
   double val = 0;
   if (id_sought != -1) {
-    tArray<double> res_count;
-    if (!m_use_avatar) res_count = m_organism->GetOrgInterface().GetResources(ctx);
-    else if (m_use_avatar) res_count = m_organism->GetOrgInterface().GetAVResources(ctx); 
-    val = res_count[id_sought];
+    if (!m_use_avatar) val = m_organism->GetOrgInterface().GetResources(ctx)[id_sought];
+    else if (m_use_avatar) val = m_organism->GetOrgInterface().GetAVResources(ctx)[id_sought];
   }
   
   sLookOut stuff_seen;
@@ -411,11 +411,20 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
       right.Set(1, 0);
       break;
   }  
-  tSmartArray<int> val_res;                                                     // resource ids of this habitat type
-  val_res.Resize(0);
+  // resource ids of this habitat type, built in the sensor's reusable list
+  int num_val_res = 0;
+  if (habitat_used != -2) num_val_res = BuildResArray(habitat_used, id_sought, resource_lib, single_bound);
+  tArray<int>& val_res = m_val_res;
+  
+  // when looking for orgs, skip the whole walk if the occupancy index shows nothing anywhere in the sight cone
+  const bool use_org_index = (habitat_used == -2);
+  if (use_org_index) {
+    const int max_side = (distance_sought % 2) ? (int) ((distance_sought - 1) * 0.5) : (int) (distance_sought * 0.5);
+    const cCoords far_cell = center_cell + ahead_dir * distance_sought;
+    if (!TestOrgIndex(search_type, center_cell, far_cell + left * max_side, far_cell + right * max_side)) return stuff_seen;
+  }
   // END definitions
-  
-  if (habitat_used != -2) val_res = BuildResArray(habitat_used, id_sought, resource_lib, single_bound); 
+
   
   // set geometric bounds, and fast-forward, if possible (doesn't work for hills and walls as they can have multiple instances)
   sBounds tot_bounds;
@@ -425,15 +434,15 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
   tot_bounds.max_y = -1 * worldy;
   if (habitat_used == 0 || habitat_used >= 4) { 
     int temp_start_dist = distance_sought;
-    for (int i = 0; i < val_res.GetSize(); i++) {
+    for (int i = 0; i < num_val_res; i++) {
       if (resource_lib.GetResource(val_res[i])->GetGradient()) {
         int this_start_dist = 0;
         sBounds res_bounds = GetBounds(ctx, resource_lib, val_res[i], search_type);          
         this_start_dist = GetMinDist(ctx, worldx, res_bounds, cell, distance_sought, facing);
         // drop any out of range...
         if (this_start_dist == -1) {
-          val_res.Swap(i, val_res.GetSize() - 1);
-          val_res.Pop();
+          val_res.Swap(i, num_val_res - 1);
+          num_val_res--;
           i--;
         }
         else {
@@ -451,7 +460,7 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
       }
     }
     start_dist = temp_start_dist;
-    if (val_res.GetSize() == 0) {     // nothing in range
+    if (num_val_res == 0) {     // nothing in range
       stuff_seen.report_type = 0;
       return stuff_seen;      
     }
@@ -470,6 +479,11 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
     // work on SIDE of center cells for this distance
     int num_cells_either_side = 0;
     if (dist > 0) num_cells_either_side = (dist % 2) ? (int) ((dist - 1) * 0.5) : (int) (dist * 0.5);
+    // cells at this distance that the occupancy index shows to be empty are walked (for bounds), but not tested
+    bool skip_dist = false;
+    if (use_org_index) {
+      skip_dist = !TestOrgIndex(search_type, center_cell, center_cell + left * num_cells_either_side, center_cell + right * num_cells_either_side);
+    }
     // look left then right
     cCoords direction = left;
     for (int do_lr = 0; do_lr <= 1; do_lr++) {
@@ -509,8 +523,8 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
         else any_valid_side_cells = true;
         
         // Now we can look at the current side cell because we know it's in the world.
-        if (valid_cell) {
-          cellResultInfo = TestCell(ctx, resource_lib, habitat_used, search_type, this_cell, val_res, first_step);
+        if (valid_cell && !skip_dist) {
+          cellResultInfo = TestCell(ctx, resource_lib, habitat_used, search_type, this_cell, val_res, num_val_res, first_step);
           first_step = false;
           if (cellResultInfo.amountFound > 0) {
             found = true;
@@ -533,8 +547,8 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
     if (stop_at_first_found && found_edible) break;                             // end side and center searches (found on side)
     
     // work on CENTER cell for this dist
-    if (count_center) {
-      cellResultInfo = TestCell(ctx, resource_lib, habitat_used, search_type, center_cell, val_res, first_step);
+    if (count_center && !skip_dist) {
+      cellResultInfo = TestCell(ctx, resource_lib, habitat_used, search_type, center_cell, val_res, num_val_res, first_step);
       first_step = false;
       if (cellResultInfo.amountFound > 0) {
         found = true;
@@ -617,7 +631,8 @@ cOrgSensor::sLookOut cOrgSensor::WalkCells(cAvidaContext& ctx, const cResourceLi
  *    
  */
 cOrgSensor::sSearchInfo cOrgSensor::TestCell(cAvidaContext& ctx, const cResourceLib& resource_lib, const int habitat_used, const int search_type,
-                                                                const cCoords target_cell_coords, const tSmartArray<int>& val_res, bool first_step)
+                                             const cCoords target_cell_coords, const tArray<int>& val_res, const int num_val_res,
+                                             bool first_step)
 {
   const int worldx = m_world->GetConfig().WORLD_X.Get();
   int target_cell_num = target_cell_coords.GetX() + (target_cell_coords.GetY() * worldx);
@@ -628,45 +643,46 @@ cOrgSensor::sSearchInfo cOrgSensor::TestCell(cAvidaContext& ctx, const cResource
   
   // if looking for resources or topological features
   if (habitat_used != -2) {
-    tArray<double> cell_res = m_organism->GetOrgInterface().GetFrozenResources(ctx, target_cell_num);
     // look at every resource ID of this habitat type in the array of resources of interest that we built
     // if counting edible (search_type == 0), return # edible units in each cell, not raw values
-    for (int k = 0; k < val_res.GetSize(); k++) { 
+    for (int k = 0; k < num_val_res; k++) { 
+      // read just this resource's level in place, rather than copying out every resource in the cell
+      const double res_val = m_organism->GetOrgInterface().GetFrozenCellResVal(ctx, target_cell_num, val_res[k]);
       double edible_threshold = resource_lib.GetResource(val_res[k])->GetThreshold();
       if (habitat_used == 0 || habitat_used > 5) {
-        if (search_type == 0 && cell_res[val_res[k]] >= edible_threshold) {
+        if (search_type == 0 && res_val >= edible_threshold) {
           if (!returnInfo.has_edible) returnInfo.resource_id = val_res[k];                                          // get FIRST whole resource id
           returnInfo.has_edible = true;
           if (first_step || resource_lib.GetResource(val_res[k])->GetGeometry() != nGeometry::GLOBAL) {             // avoid counting global res more than once (ever)
-            returnInfo.amountFound += floor(cell_res[val_res[k]] / edible_threshold);                                                         
+            returnInfo.amountFound += floor(res_val / edible_threshold);                                                         
           }
         }
-        else if (search_type == 1 && cell_res[val_res[k]] < edible_threshold && cell_res[val_res[k]] > 0) {         // only get sum amounts when < threshold if search = get counts
+        else if (search_type == 1 && res_val < edible_threshold && res_val > 0) {         // only get sum amounts when < threshold if search = get counts
           if (first_step || resource_lib.GetResource(val_res[k])->GetGeometry() != nGeometry::GLOBAL) {             // avoid counting global res more than once (ever)
-            returnInfo.amountFound += cell_res[val_res[k]];                                                         
+            returnInfo.amountFound += res_val;                                                         
           }
         } 
       }
-      else if ((habitat_used == 1 || habitat_used == 2) && cell_res[val_res[k]] > 0) {                              // hills and walls work with any vals > 0, not the threshold default of 1
+      else if ((habitat_used == 1 || habitat_used == 2) && res_val > 0) {                              // hills and walls work with any vals > 0, not the threshold default of 1
         if (!returnInfo.has_edible) returnInfo.resource_id = val_res[k];   
         returnInfo.has_edible = true;
-        returnInfo.amountFound += cell_res[val_res[k]];
+        returnInfo.amountFound += res_val;
       }
-      else if (habitat_used == 5 && cell_res[val_res[k]] > 0) {                                                   // simulated predators work with any vals > 0 and have chance of detection failing
+      else if (habitat_used == 5 && res_val > 0) {                                                   // simulated predators work with any vals > 0 and have chance of detection failing
         if (ctx.GetRandom().P(resource_lib.GetResource(val_res[k])->GetDetectionProb())) {
           if (!returnInfo.has_edible) returnInfo.resource_id = val_res[k];   
           returnInfo.has_edible = true;
-          returnInfo.amountFound += cell_res[val_res[k]];
+          returnInfo.amountFound += res_val;
         }
       }
       else if (habitat_used == 4) { 
-        if (search_type == 0 && cell_res[val_res[k]] >= edible_threshold) {                                       // dens only work above a config set level, but threshold will override this for OrgSensor
+        if (search_type == 0 && res_val >= edible_threshold) {                                       // dens only work above a config set level, but threshold will override this for OrgSensor
           if (!returnInfo.has_edible) returnInfo.resource_id = val_res[k];   
           returnInfo.has_edible = true;
-          returnInfo.amountFound += floor(cell_res[val_res[k]] / edible_threshold);        
+          returnInfo.amountFound += floor(res_val / edible_threshold);        
         }
-        else if (search_type == 1 && cell_res[val_res[k]] < edible_threshold && cell_res[val_res[k]] > 0) {
-          returnInfo.amountFound += cell_res[val_res[k]];        
+        else if (search_type == 1 && res_val < edible_threshold && res_val > 0) {
+          returnInfo.amountFound += res_val;        
         }
       }
     }
@@ -719,6 +735,23 @@ cOrgSensor::sSearchInfo cOrgSensor::TestCell(cAvidaContext& ctx, const cResource
   return returnInfo;
 }
 
+// Tests the population's occupancy index for anything matching the org search inside the bounding box of three cells
+bool cOrgSensor::TestOrgIndex(const int search_type, const cCoords& cell_a, const cCoords& cell_b, const cCoords& cell_c)
+{
+  const int min_x = min(cell_a.GetX(), min(cell_b.GetX(), cell_c.GetX()));
+  const int min_y = min(cell_a.GetY(), min(cell_b.GetY(), cell_c.GetY()));
+  const int max_x = max(cell_a.GetX(), max(cell_b.GetX(), cell_c.GetX()));
+  const int max_y = max(cell_a.GetY(), max(cell_b.GetY(), cell_c.GetY()));
+  
+  const cOrgSpatialIndex& org_index = m_world->GetPopulation().GetOrgSpatialIndex();
+  if (!m_use_avatar) return org_index.AnyInRect(cOrgSpatialIndex::ORG_CLASS_ORG, min_x, min_y, max_x, max_y);
+  
+  // avatar searches: predators are input avatars, prey are output avatars
+  if (search_type >= 0 && org_index.AnyInRect(cOrgSpatialIndex::ORG_CLASS_PRED_AV, min_x, min_y, max_x, max_y)) return true;
+  if (search_type <= 0 && org_index.AnyInRect(cOrgSpatialIndex::ORG_CLASS_PREY_AV, min_x, min_y, max_x, max_y)) return true;
+  return false;
+}
+
 int cOrgSensor::GetMinDist(cAvidaContext& ctx, const int worldx, sBounds& bounds, const int cell_id, 
                                       const int distance_sought, const int facing)
 {
@@ -853,17 +886,18 @@ bool cOrgSensor::TestBounds(const cCoords cell_id, sBounds& bounds)
   return true;  
 }
 
-tSmartArray<int> cOrgSensor::BuildResArray(const int habitat_used, const int id_sought, const cResourceLib& resource_lib, bool single_bound)
+// Fills m_val_res with the resources of interest and returns how many there are.  The list is reused across looks,
+// only growing when the resource library does, so that looking does not allocate.
+int cOrgSensor::BuildResArray(const int habitat_used, const int id_sought, const cResourceLib& resource_lib, bool single_bound)
 {
-  tSmartArray<int> val_res;
-  val_res.Resize(0);
-  if (single_bound) val_res.Push(id_sought);
-  else if (!single_bound) { 
-    for (int i = 0; i < resource_lib.GetSize(); i++) { 
-      if (resource_lib.GetResource(i)->GetHabitat() == habitat_used) val_res.Push(i); 
-    }
+  if (m_val_res.GetSize() < resource_lib.GetSize()) m_val_res.ResizeClear(resource_lib.GetSize());
+  if (single_bound) {
+    m_val_res[0] = id_sought;
+    return 1;
   }
-  return val_res;
+  const tArray<int>& habitat_res = resource_lib.GetHabitatResources(habitat_used);
+  for (int i = 0; i < habitat_res.GetSize(); i++) m_val_res[i] = habitat_res[i];
+  return habitat_res.GetSize();
 }
 
 int cOrgSensor::ReturnRelativeFacing(cOrganism* sighted_org) {
@@ -50,6 +50,7 @@ class cOrgSensor
   bool m_return_rel_facing; 
   sOrgDisplay m_last_seen_display;
   bool m_has_seen_display;
+  tArray<int> m_val_res;     // Resource ids of interest for the current look, reused between looks
   
   void ResetOrgSensor();
 
@@ -90,7 +91,7 @@ class cOrgSensor
 
   const sLookOut SetLooking(cAvidaContext& ctx, sLookInit& in_defs, int facing, int cell_id, bool use_ft);
   sSearchInfo TestCell(cAvidaContext& ctx, const cResourceLib& resource_lib, const int habitat_used, const int search_type, 
-                      const cCoords target_cell_coords, const tSmartArray<int>& val_res, bool first_step);  
+                      const cCoords target_cell_coords, const tArray<int>& val_res, const int num_val_res, bool first_step);  
   sLookOut WalkCells(cAvidaContext& ctx, const cResourceLib& resource_lib, const int habitat_used, const int search_type, const int distance_sought, const int id_sought, const int facing, const int cell_id);
   sLookOut FindOrg(cOrganism* target_org, const int distance, const int facing);
   sLookOut GlobalVal(cAvidaContext& ctx, const int habitat_used, const int id_sought, const int search_type);
@@ -100,7 +101,8 @@ class cOrgSensor
   int GetMaxDist(const int worldx, const int cell_id, const int distance_sought, sBounds& res_bounds);
   sBounds GetBounds(cAvidaContext& ctx, const cResourceLib& resource_lib, const int res_id, const int search_type);
   bool TestBounds(const cCoords cell_id, sBounds& bounds_set);
-  tSmartArray<int> BuildResArray(const int habitat_used, const int id_sought, const cResourceLib& resource_lib, bool single_bound);
+  bool TestOrgIndex(const int search_type, const cCoords& cell_a, const cCoords& cell_b, const cCoords& cell_c);
+  int BuildResArray(const int habitat_used, const int id_sought, const cResourceLib& resource_lib, bool single_bound);
   
   void SetReturnRelativeFacing(bool do_set) { m_return_rel_facing = do_set; }
   int ReturnRelativeFacing(cOrganism* sighted_org);
@@ -0,0 +1,57 @@
+/*
+ *  cOrgSpatialIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cOrgSpatialIndex.h"
+
+
+void cOrgSpatialIndex::Setup(int world_x, int world_y)
+{
+  m_world_x = world_x;
+  m_world_y = world_y;
+  m_buckets_x = (world_x + (1 << BUCKET_SHIFT) - 1) >> BUCKET_SHIFT;
+  m_buckets_y = (world_y + (1 << BUCKET_SHIFT) - 1) >> BUCKET_SHIFT;
+  for (int i = 0; i < NUM_ORG_CLASSES; i++) {
+    m_counts[i].ResizeClear(m_buckets_x * m_buckets_y);
+    m_counts[i].SetAll(0);
+  }
+}
+
+
+bool cOrgSpatialIndex::AnyInRect(eOrgClass org_class, int min_x, int min_y, int max_x, int max_y) const
+{
+  // Without an index every region must be searched
+  if (!m_world_x) return true;
+
+  if (min_x < 0) min_x = 0;
+  if (min_y < 0) min_y = 0;
+  if (max_x > m_world_x - 1) max_x = m_world_x - 1;
+  if (max_y > m_world_y - 1) max_y = m_world_y - 1;
+  if (min_x > max_x || min_y > max_y) return false;
+
+  const tArray<int>& counts = m_counts[org_class];
+  const int bx_min = min_x >> BUCKET_SHIFT;
+  const int bx_max = max_x >> BUCKET_SHIFT;
+  const int by_max = max_y >> BUCKET_SHIFT;
+  for (int by = min_y >> BUCKET_SHIFT; by <= by_max; by++) {
+    const int row = by * m_buckets_x;
+    for (int bx = bx_min; bx <= bx_max; bx++) if (counts[row + bx]) return true;
+  }
+  return false;
+}
@@ -0,0 +1,74 @@
+/*
+ *  cOrgSpatialIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cOrgSpatialIndex_h
+#define cOrgSpatialIndex_h
+
+#ifndef tArray_h
+#include "tArray.h"
+#endif
+
+
+// Coarse occupancy index over the population grid, used by the sensors to skip empty regions when searching for
+// organisms or avatars.  The grid is divided into square buckets, each holding a count of the occupied cells
+// (ORG_CLASS_ORG) and of the predator and prey avatars it contains.  Counts are maintained by cPopulationCell as
+// organisms are inserted and removed and as avatars enter and leave cells, so a query never has to look at a cell.
+class cOrgSpatialIndex
+{
+public:
+  enum eOrgClass {
+    ORG_CLASS_ORG = 0,    // Occupied cells, regardless of forage target
+    ORG_CLASS_PRED_AV,    // Input (predator) avatars
+    ORG_CLASS_PREY_AV,    // Output (prey) avatars
+    NUM_ORG_CLASSES
+  };
+
+  static const int BUCKET_SHIFT = 3;  // 8x8 cells per bucket
+
+private:
+  int m_world_x;
+  int m_world_y;
+  int m_buckets_x;
+  int m_buckets_y;
+  tArray<int> m_counts[NUM_ORG_CLASSES];
+
+
+  cOrgSpatialIndex(const cOrgSpatialIndex&); // @not_implemented
+  cOrgSpatialIndex& operator=(const cOrgSpatialIndex&); // @not_implemented
+
+  inline int bucketOf(int cell_id) const
+  {
+    return ((cell_id / m_world_x) >> BUCKET_SHIFT) * m_buckets_x + ((cell_id % m_world_x) >> BUCKET_SHIFT);
+  }
+
+public:
+  cOrgSpatialIndex() : m_world_x(0), m_world_y(0), m_buckets_x(0), m_buckets_y(0) { ; }
+
+  void Setup(int world_x, int world_y);
+
+  inline void Add(eOrgClass org_class, int cell_id) { if (m_world_x) m_counts[org_class][bucketOf(cell_id)]++; }
+  inline void Remove(eOrgClass org_class, int cell_id) { if (m_world_x) m_counts[org_class][bucketOf(cell_id)]--; }
+
+  // Returns true if any bucket overlapping the (inclusive) rectangle holds a member of the class.  The rectangle
+  // is clipped to the world; since whole buckets are tested, a true result does not guarantee a hit in the rectangle.
+  bool AnyInRect(eOrgClass org_class, int min_x, int min_y, int max_x, int max_y) const;
+};
+
+#endif
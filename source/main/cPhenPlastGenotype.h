@@ -73,10 +73,12 @@ class cPhenPlastGenotype
     
     
   
-  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx);
+  void Process(cCPUTestInfo& test_info, cWorld* world, cAvidaContext& ctx, cTestCPU* test_cpu);
   
 public:
-  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx);
+  // If test_cpu is given it is used for every trial, otherwise a test CPU is created for the duration of the tests
+  cPhenPlastGenotype(const Genome& in_genome, int num_trails, cCPUTestInfo& test_info,  cWorld* world, cAvidaContext& ctx,
+                     cTestCPU* test_cpu = NULL);
   ~cPhenPlastGenotype();
     
   // Accessors
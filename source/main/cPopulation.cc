@@ -100,6 +100,7 @@ cPopulation::cPopulation(cWorld* world)
 , m_has_predatory_res(false)
 , sync_events(false)
 , m_hgt_resid(-1)
+, m_death_index_dirty(true)
 {
   // Avida specific information.
   world_x = world->GetConfig().WORLD_X.Get();
@@ -173,6 +174,7 @@ cPopulation::cPopulation(cWorld* world)
     empty_cell_id_array[i] = i;
   }
   market.Resize(MARKET_SIZE);
+  m_org_spatial_index.Setup(world_x, world_y);
   
   // Setup the cells.  Do things that are not dependent upon topology here.
   for(int i=0; i<num_cells; ++i) {
@@ -1716,14 +1718,14 @@ void cPopulation::AttackFacedOrg(cAvidaContext& ctx, int loser)
   KillOrganism(loser_cell, ctx); 
 }
 
-void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx) 
+void cPopulation::KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx, bool record_death) 
 {
   // do we actually have something to kill?
   if (in_cell.IsOccupied() == false) return;
   
   // Statistics...
   cOrganism* organism = in_cell.GetOrganism();
-  m_world->GetStats().RecordDeath();
+  if (record_death) m_world->GetStats().RecordDeath();
 
   // orgs killed during birth wont have avatars
   if (m_world->GetConfig().USE_AVATARS.Get() && organism->GetOrgInterface().GetAVCellID() != -1) {
@@ -5617,9 +5619,62 @@ void cPopulation::ProcessPostUpdate(cAvidaContext& ctx)
 
 void cPopulation::ProcessUpdateCellActions(cAvidaContext& ctx)
 {
+  if (m_death_index_dirty) BuildDeathIndex();
+  
+  cRandom& rng = ctx.GetRandom();
+  for (int g = 0; g < m_death_groups.GetSize(); g++) {
+    const tSmartArray<int>& cells = m_death_groups[g].cells;
+    const double prob = m_death_groups[g].prob;
+    
+    if (prob >= 1.0) {
+      for (int i = 0; i < cells.GetSize(); i++) KillOrganism(cell_array[cells[i]], ctx);
+      continue;
+    }
+    
+    // Geometric skipping: the gap to the next dying cell in this group is distributed as floor(ln(U) / ln(1 - p))
+    const double log_q = log(1.0 - prob);
+    int i = -1;
+    while (true) {
+      const double skip = floor(log(1.0 - rng.GetDouble()) / log_q);
+      if (skip >= cells.GetSize() - i - 1) break;
+      i += static_cast<int>(skip) + 1;
+      KillOrganism(cell_array[cells[i]], ctx);
+    }
+  }
+  
+  for (int i = 0; i < m_death_mixed_cells.GetSize(); i++) {
+    cPopulationCell& cell = cell_array[m_death_mixed_cells[i]];
+    if (cell.MutationRates().TestDeath(ctx)) KillOrganism(cell, ctx);
+  }
+}
+
+void cPopulation::BuildDeathIndex()
+{
+  // Distinct probabilities beyond this are not worth grouping; those cells are tested individually
+  const int MAX_DEATH_GROUPS = 16;
+  
+  m_death_groups.Resize(0);
+  m_death_mixed_cells.Resize(0);
+  
   for (int i = 0; i < cell_array.GetSize(); i++) {
-    if (cell_array[i].MutationRates().TestDeath(ctx)) KillOrganism(cell_array[i], ctx); 
+    const double prob = cell_array[i].MutationRates().GetDeathProb();
+    if (prob <= 0.0) continue;
+    
+    int group = 0;
+    while (group < m_death_groups.GetSize() && m_death_groups[group].prob != prob) group++;
+    if (group == m_death_groups.GetSize()) {
+      if (group == MAX_DEATH_GROUPS) {
+        m_death_mixed_cells.Push(i);
+        continue;
+      }
+      m_death_groups.Resize(group + 1);
+      m_death_groups[group].prob = prob;
+      m_death_groups[group].cells.Resize(0);
+    }
+    m_death_groups[group].cells.Push(i);
   }
+  
+  m_death_index_dirty = false;
 }
 
 
@@ -26,6 +26,7 @@
 #include "cBirthChamber.h"
 #include "cDeme.h"
 #include "cOrgInterface.h"
+#include "cOrgSpatialIndex.h"
 #include "cPopulationInterface.h"
 #include "cResourceCount.h"
 #include "cString.h"
@@ -63,6 +64,7 @@ private:
   cSchedule* schedule;                // Handles allocation of CPU cycles
   tArray<cPopulationCell> cell_array;  // Local cells composing the population
   tArray<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
+  cOrgSpatialIndex m_org_spatial_index; // Coarse occupancy of cells and avatars, maintained by the cells
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
   tArray<tList<cSaleItem> > market;   // list of lists of items for sale, each list goes with 1 label
@@ -116,6 +118,16 @@ private:
 
   int m_hgt_resid; //!< HGT resource ID.
   
+  // Per-update death testing: cells with a nonzero death probability, grouped by probability so that
+  // the dying cells in each group can be selected directly by geometric skipping.
+  struct sDeathGroup {
+    double prob;
+    tSmartArray<int> cells;
+  };
+  tArray<sDeathGroup> m_death_groups;
+  tSmartArray<int> m_death_mixed_cells;  // cells beyond MAX_DEATH_GROUPS distinct probabilities, tested one by one
+  bool m_death_index_dirty;
+  
 
   cPopulation(); // @not_implemented
   cPopulation(const cPopulation&); // @not_implemented
@@ -145,7 +157,11 @@ public:
   void InjectParasite(const cString& label, const Sequence& injected_code, int cell_id);
   
   // Deactivate an organism in the population (required for deactivations)
-  void KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx); 
+  // Organisms that leave the population without dying (e.g. migrants) pass record_death = false
+  void KillOrganism(cPopulationCell& in_cell, cAvidaContext& ctx, bool record_death = true); 
+  
+  // Returns a random empty cell, or -1 if there is none
+  int FindRandEmptyCell();
   
   void SetPopCapEnforcement(int rate) { pop_enforce = rate; }
   
@@ -242,6 +258,9 @@ public:
   void ProcessPreUpdate();
   void UpdateResStats(cAvidaContext& ctx);
   void ProcessUpdateCellActions(cAvidaContext& ctx);
+  
+  // Must be called whenever cell death probabilities are modified so that the death index gets rebuilt
+  void DeathProbsChanged() { m_death_index_dirty = true; }
 
   // Clear all but a subset of cells...
   void SerialTransfer(int transfer_size, bool ignore_deads, cAvidaContext& ctx); 
@@ -275,9 +294,11 @@ public:
   cDeme& GetDeme(int i) { return deme_array[i]; }
 
   cPopulationCell& GetCell(int in_num) { return cell_array[in_num]; }
+  cOrgSpatialIndex& GetOrgSpatialIndex() { return m_org_spatial_index; }
   const tArray<double>& GetResources(cAvidaContext& ctx) const { return resource_count.GetResources(ctx); } 
   const tArray<double>& GetCellResources(int cell_id, cAvidaContext& ctx) const { return resource_count.GetCellResources(cell_id, ctx); } 
   const tArray<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id) const { return resource_count.GetFrozenResources(ctx, cell_id); }
+  double GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const { return resource_count.GetFrozenCellResVal(ctx, cell_id, res_id); }
   const tArray<double>& GetDemeResources(int deme_id, cAvidaContext& ctx) { return GetDeme(deme_id).GetDemeResourceCount().GetResources(ctx); }  
   const tArray<double>& GetDemeCellResources(int deme_id, int cell_id, cAvidaContext& ctx) { return GetDeme(deme_id).GetDemeResourceCount().GetCellResources( GetDeme(deme_id).GetRelativeCellID(cell_id), ctx ); } 
   void TriggerDoUpdates(cAvidaContext& ctx) { resource_count.UpdateResources(ctx); }
@@ -423,7 +444,6 @@ private:
   int UpdateEmptyCellIDArray(int deme_id = -1);
   tArray<int>& GetEmptyCellIDArray() { return empty_cell_id_array; }
   void FindEmptyCell(tList<cPopulationCell>& cell_list, tList<cPopulationCell>& found_list);
-  int FindRandEmptyCell();
   
   // Update statistics collecting...
   void UpdateDemeStats(cAvidaContext& ctx); 
@@ -431,6 +451,8 @@ private:
   void UpdateFTOrgStats(cAvidaContext& ctx); 
   void UpdateMaleFemaleOrgStats(cAvidaContext& ctx);
   
+  void BuildDeathIndex();
+  
   void InjectClone(int cell_id, cOrganism& orig_org, eBioUnitSource src);
   void CompeteOrganisms_ConstructOffspring(int cell_id, cOrganism& parent);
   
@@ -266,6 +266,7 @@ void cPopulationCell::InsertOrganism(cOrganism* new_org, cAvidaContext& ctx)
   // Adjust this cell's attributes to account for the new organism.
   m_organism = new_org;
   m_hardware = &new_org->GetHardware();
+  m_world->GetPopulation().GetOrgSpatialIndex().Add(cOrgSpatialIndex::ORG_CLASS_ORG, m_cell_id);
   m_world->GetStats().AddSpeculativeWaste(m_spec_state);
   m_spec_state = 0;
 	
@@ -302,6 +303,7 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
   }
   m_organism = NULL;
   m_hardware = NULL;
+  m_world->GetPopulation().GetOrgSpatialIndex().Remove(cOrgSpatialIndex::ORG_CLASS_ORG, m_cell_id);
   return out_organism;
 }
 
@@ -335,6 +337,7 @@ void cPopulationCell::AddInputAV(cOrganism* org)
   m_av_inputs.Swap(loc, m_av_inputs.GetSize() - 1);
   exist_org->SetAVInIndex(m_av_inputs.GetSize() - 1);
   org->SetAVInIndex(loc);
+  m_world->GetPopulation().GetOrgSpatialIndex().Add(cOrgSpatialIndex::ORG_CLASS_PRED_AV, m_cell_id);
 }
 
 // Adds an organism to the cell's output avatars, then keeps the list mixed by swapping the new avatar into a random position in the array
@@ -347,6 +350,7 @@ void cPopulationCell::AddOutputAV(cOrganism* org)
   m_av_outputs.Swap(loc, m_av_outputs.GetSize() - 1);
   exist_org->SetAVOutIndex(m_av_outputs.GetSize() - 1);
   org->SetAVOutIndex(loc);
+  m_world->GetPopulation().GetOrgSpatialIndex().Add(cOrgSpatialIndex::ORG_CLASS_PREY_AV, m_cell_id);
 }
 
 // Removes the organism from the cell's input avatars (predator)
@@ -359,6 +363,7 @@ void cPopulationCell::RemoveInputAV(cOrganism* org)
   exist_org->SetAVInIndex(org->GetAVInIndex());
   m_av_inputs.Swap(org->GetAVInIndex(), last);
   m_av_inputs.Pop();
+  m_world->GetPopulation().GetOrgSpatialIndex().Remove(cOrgSpatialIndex::ORG_CLASS_PRED_AV, m_cell_id);
 }
 
 // Removes the organism from the cell's output avatars (prey)
@@ -371,6 +376,7 @@ void cPopulationCell::RemoveOutputAV(cOrganism* org)
   exist_org->SetAVOutIndex(org->GetAVOutIndex());
   m_av_outputs.Swap(org->GetAVOutIndex(), last);
   m_av_outputs.Pop();
+  m_world->GetPopulation().GetOrgSpatialIndex().Remove(cOrgSpatialIndex::ORG_CLASS_PREY_AV, m_cell_id);
 }
 
 // Returns whether a cell has an output AV that the org will be able to receive messages from.
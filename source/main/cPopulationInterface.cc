@@ -354,6 +354,11 @@ const tArray<double>& cPopulationInterface::GetFrozenResources(cAvidaContext& ct
   return m_world->GetPopulation().GetFrozenResources(ctx, cell_id); 
 }
 
+double cPopulationInterface::GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id)
+{
+  return m_world->GetPopulation().GetFrozenCellResVal(ctx, cell_id, res_id);
+}
+
 const tArray<double>& cPopulationInterface::GetDemeResources(int deme_id, cAvidaContext& ctx) 
 {
   return m_world->GetPopulation().GetDemeCellResources(deme_id, m_cell_id, ctx); 
@@ -581,6 +581,13 @@ const tArray<double> & cResourceCount::GetFrozenResources(cAvidaContext& ctx, in
   return curr_grid_res_cnt;
 }
 
+double cResourceCount::GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const
+// Single resource version of GetFrozenResources, reading the level in place rather than filling the whole array.
+{
+  if (geometry[res_id] == nGeometry::GLOBAL || geometry[res_id]==nGeometry::PARTIAL) return resource_count[res_id];
+  return spatial_resource_count[res_id]->GetAmount(cell_id);
+}
+
 const tArray<int> & cResourceCount::GetResourcesGeometry() const
 {
   return geometry;
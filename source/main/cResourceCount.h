@@ -136,6 +136,7 @@ public:
   const tArray<double>& GetResources(cAvidaContext& ctx) const; 
   const tArray<double>& GetCellResources(int cell_id, cAvidaContext& ctx) const;
   const tArray<double>& GetFrozenResources(cAvidaContext& ctx, int cell_id) const;
+  double GetFrozenCellResVal(cAvidaContext& ctx, int cell_id, int res_id) const;
   const tArray<int>& GetResourcesGeometry() const;
   int GetResourceGeometry(int res_id) const { return geometry[res_id]; }
   const tArray<tArray<double> >& GetSpatialRes(cAvidaContext& ctx); 
@@ -75,6 +75,20 @@ bool cResourceLib::DoesResourceExist(const cString& res_name)
   return false;
 }
 
+void cResourceLib::UpdateHabitatIndex()
+{
+  int num_habitats = 0;
+  for (int i = 0; i < m_resource_array.GetSize(); i++) {
+    if (m_resource_array[i]->GetHabitat() >= num_habitats) num_habitats = m_resource_array[i]->GetHabitat() + 1;
+  }
+  
+  m_habitat_resources.ResizeClear(num_habitats);
+  for (int i = 0; i < m_resource_array.GetSize(); i++) {
+    const int habitat = m_resource_array[i]->GetHabitat();
+    if (habitat >= 0) m_habitat_resources[habitat].Push(i);
+  }
+}
+
 /* This assigns an index to a resource within its own type (deme vs. non-deme)
  * If the resource already has a positive id nothing will be assigned.
  * (Enforced by cResource::SetIndex())
@@ -37,6 +37,8 @@ private:
   tArray<cResource*> m_resource_array;
   mutable cResourceHistory* m_initial_levels;
   int m_num_deme_resources;
+  tArray<tArray<int> > m_habitat_resources;  // Resource ids of each habitat, in id order
+  tArray<int> m_no_resources;
   
   cResourceLib(const cResourceLib&); // @not_implemented
   cResourceLib& operator=(const cResourceLib&); // @not_implemented
@@ -53,6 +55,13 @@ public:
   const cResourceHistory& GetInitialResourceLevels() const;
   bool DoesResourceExist(const cString& res_name);
   void SetResourceIndex(cResource* res);
+  
+  // Habitat index, must be updated whenever resources are added or change habitat
+  void UpdateHabitatIndex();
+  const tArray<int>& GetHabitatResources(int habitat) const
+  {
+    return (habitat >= 0 && habitat < m_habitat_resources.GetSize()) ? m_habitat_resources[habitat] : m_no_resources;
+  }
 };
 
 #endif
@@ -120,6 +120,8 @@ cStats::cStats(cWorld* world)
   , tot_threshold(0)
   , tot_lineages(0)
   , tot_executed(0)
+  , m_divide_tests_run(0)
+  , m_divide_tests_avoided(0)
   , num_resamplings(0)
   , num_failedResamplings(0)
   , last_update(0)
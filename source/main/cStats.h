@@ -243,6 +243,10 @@ private:
   int tot_lineages;
   int tot_executed;
 
+  // Divide-time fitness tests (revert/sterilize), cumulative
+  int m_divide_tests_run;
+  int m_divide_tests_avoided;
+
   // --------  Parasite Task Stats  ---------
   tArray<int> tasks_host_current;
   tArray<int> tasks_host_last;
@@ -696,6 +700,11 @@ public:
 
   void IncExecuted() { num_executed++; }
 
+  void IncDivideTestsRun() { m_divide_tests_run++; }
+  void IncDivideTestsAvoided() { m_divide_tests_avoided++; }
+  int GetDivideTestsRun() const { return m_divide_tests_run; }
+  int GetDivideTestsAvoided() const { return m_divide_tests_avoided; }
+
   void AddNumOrgsKilled(long num) { sum_orgs_killed.Add(num); }
 	void AddNumUnoccupiedCellAttemptedToKill(long num) { sum_unoccupied_cell_kill_attempts.Add(num); }
   void AddNumCellsScannedAtKill(long num) { sum_cells_scanned_at_kill.Add(num); }
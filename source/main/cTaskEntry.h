@@ -30,6 +30,8 @@
 #include "cString.h"
 #endif
 
+#include <cassert>
+
 class cTaskLib;
 class cTaskContext;
 
@@ -44,11 +46,16 @@ private:
   int m_id;
   tTaskTest m_test_fun;
   cArgContainer* m_args;
+  
+  // Tasks whose outcome depends only on the logic ID of the output record the IDs that pass, one bit each
+  bool m_logic_only;
+  unsigned int m_logic_ids[8];
 
 public:
   cTaskEntry(const cString& name, const cString& desc, int in_id, tTaskTest fun, cArgContainer* args)
-    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args)
+    : m_name(name), m_desc(desc), m_id(in_id), m_test_fun(fun), m_args(args), m_logic_only(false)
   {
+    for (int i = 0; i < 8; i++) m_logic_ids[i] = 0;
   }
   ~cTaskEntry()
   {
@@ -62,6 +69,14 @@ public:
   
   bool HasArguments() const { return (m_args != NULL); }
   cArgContainer& GetArguments() const { return *m_args; }
+  
+  bool IsLogicOnly() const { return m_logic_only; }
+  bool TestLogicId(int logic_id) const
+  {
+    return (logic_id >= 0 && logic_id < 256 && ((m_logic_ids[logic_id >> 5] >> (logic_id & 31)) & 1));
+  }
+  void SetLogicOnly() { m_logic_only = true; }
+  void AddLogicId(int logic_id) { assert(logic_id >= 0 && logic_id < 256); m_logic_ids[logic_id >> 5] |= (1u << (logic_id & 31)); }
 };
 
 #endif
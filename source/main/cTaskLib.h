@@ -98,6 +98,7 @@ private:
 private:
   
   void NewTask(const cString& name, const cString& desc, tTaskTest task_fun, int reqs = 0, cArgContainer* args = NULL);
+  void NewLogicTask(const cString& name, const cString& desc, tTaskTest task_fun);
 
   inline double FractionalReward(unsigned int supplied, unsigned int correct);  
 
@@ -21,6 +21,7 @@
 
 #include "ASTree.h"
 
+#include "cASBytecode.h"
 #include "cASTVisitor.h"
 
 
@@ -64,6 +65,13 @@ cASTStatementList::~cASTStatementList()
   while ((node = it.Next())) delete node;
 }
 
+cASTWhileBlock::~cASTWhileBlock()
+{
+  delete m_expr;
+  delete m_code;
+  delete m_bytecode;
+}
+
 cASTFunctionDefinition::~cASTFunctionDefinition()
 {
   delete m_args;
@@ -100,4 +108,15 @@ cASTBuiltInCall::cASTBuiltInCall(const cASFilePosition& fp, const cString& name,
 }
 
 
-
+cASTLiteral::cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v)
+  : cASTNode(fp), m_type(t), m_value(v)
+{
+  m_parsed.as_float = 0.0;
+  switch (m_type.type) {
+    case AS_TYPE_BOOL:  m_parsed.as_bool = (m_value == "true"); break;
+    case AS_TYPE_CHAR:  m_parsed.as_char = m_value[0]; break;
+    case AS_TYPE_INT:   m_parsed.as_int = m_value.AsInt(); break;
+    case AS_TYPE_FLOAT: m_parsed.as_float = m_value.AsDouble(); break;
+    default: break;
+  }
+}
@@ -31,6 +31,7 @@
 #include "tManagedPointerArray.h"
 
 
+class cASBytecode;
 class cASFunction;
 class cASTVisitor;
 
@@ -306,14 +307,20 @@ class cASTWhileBlock : public cASTNode
 private:
   cASTNode* m_expr;
   cASTNode* m_code;
+  cASBytecode* m_bytecode;
   
 public:
-  cASTWhileBlock(const cASFilePosition& fp, cASTNode* expr, cASTNode* code) : cASTNode(fp), m_expr(expr), m_code(code) { ; }
-  ~cASTWhileBlock() { delete m_expr; delete m_code; }
+  cASTWhileBlock(const cASFilePosition& fp, cASTNode* expr, cASTNode* code)
+    : cASTNode(fp), m_expr(expr), m_code(code), m_bytecode(NULL) { ; }
+  ~cASTWhileBlock();
   
   inline cASTNode* GetCondition() { return m_expr; }
   inline cASTNode* GetCode() { return m_code; }
   
+  // Compiled form of the whole loop, set by cCompileASTVisitor when every node in it is supported
+  inline void SetBytecode(cASBytecode* bytecode) { m_bytecode = bytecode; }
+  inline cASBytecode* GetBytecode() { return m_bytecode; }
+  
   void Accept(cASTVisitor& visitor);
 };
 
@@ -526,13 +533,25 @@ class cASTLiteral : public cASTNode
 private:
   sASTypeInfo m_type;
   cString m_value;
+  union {
+    bool as_bool;
+    char as_char;
+    int as_int;
+    double as_float;
+  } m_parsed;
   
 public:
-  cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v) : cASTNode(fp), m_type(t), m_value(v) { ; }
+  cASTLiteral(const cASFilePosition& fp, const sASTypeInfo& t, const cString& v);
   
   const sASTypeInfo& GetType() const { return m_type; }
   inline const cString& GetValue() { return m_value; }
   
+  // Values of bool, char, int and float literals, parsed once when the node is built
+  inline bool GetBoolValue() const { return m_parsed.as_bool; }
+  inline char GetCharValue() const { return m_parsed.as_char; }
+  inline int GetIntValue() const { return m_parsed.as_int; }
+  inline double GetFloatValue() const { return m_parsed.as_float; }
+  
   void Accept(cASTVisitor& visitor);
 };
 
@@ -199,6 +199,64 @@ typedef enum eASBuiltInFunction {
   AS_BUILTIN_UNKNOWN
 } ASBuiltIn_t;
 
+typedef enum eASOpcodes {
+  AS_OP_PUSH_BOOL,
+  AS_OP_PUSH_INT,
+  AS_OP_PUSH_FLOAT,
+  AS_OP_LOAD_BOOL,
+  AS_OP_LOAD_INT,
+  AS_OP_LOAD_FLOAT,
+  AS_OP_STORE_BOOL,
+  AS_OP_STORE_INT,
+  AS_OP_STORE_FLOAT,
+  AS_OP_POP,
+
+  AS_OP_BOOL_TO_INT,
+  AS_OP_BOOL_TO_FLOAT,
+  AS_OP_INT_TO_BOOL,
+  AS_OP_INT_TO_FLOAT,
+  AS_OP_FLOAT_TO_BOOL,
+  AS_OP_FLOAT_TO_INT,
+
+  AS_OP_INT_ADD,
+  AS_OP_INT_SUB,
+  AS_OP_INT_MUL,
+  AS_OP_INT_DIV,
+  AS_OP_INT_MOD,
+  AS_OP_INT_BIT_AND,
+  AS_OP_INT_BIT_OR,
+  AS_OP_INT_BIT_NOT,
+  AS_OP_INT_NEG,
+  AS_OP_FLOAT_ADD,
+  AS_OP_FLOAT_SUB,
+  AS_OP_FLOAT_MUL,
+  AS_OP_FLOAT_DIV,
+  AS_OP_FLOAT_MOD,
+  AS_OP_FLOAT_NEG,
+
+  AS_OP_LOGIC_AND,
+  AS_OP_LOGIC_OR,
+  AS_OP_LOGIC_NOT,
+  AS_OP_BOOL_EQ,
+  AS_OP_BOOL_NEQ,
+  AS_OP_INT_EQ,
+  AS_OP_INT_NEQ,
+  AS_OP_INT_LT,
+  AS_OP_INT_LE,
+  AS_OP_INT_GT,
+  AS_OP_INT_GE,
+  AS_OP_FLOAT_EQ,
+  AS_OP_FLOAT_NEQ,
+  AS_OP_FLOAT_LT,
+  AS_OP_FLOAT_LE,
+  AS_OP_FLOAT_GT,
+  AS_OP_FLOAT_GE,
+
+  AS_OP_JUMP,
+  AS_OP_JUMP_FALSE,
+  AS_OP_END
+} ASOpcode_t;
+
 enum eASExitCodes {
   AS_EXIT_OK = 0,
   AS_EXIT_FILE_NOT_FOUND = 200,
@@ -0,0 +1,75 @@
+/*
+ *  cASBytecode.cc
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cASBytecode.h"
+
+
+int cASBytecode::Emit(ASOpcode_t op, cASTNode* node, int arg, bool global, double fval)
+{
+  sInstruction inst;
+  inst.op = op;
+  inst.arg = arg;
+  inst.global = global;
+  inst.fval = fval;
+  inst.node = node;
+  m_code.Push(inst);
+  
+  // Track the value stack depth so that the interpreter can size its stack once per loop
+  switch (op) {
+    case AS_OP_PUSH_BOOL:
+    case AS_OP_PUSH_INT:
+    case AS_OP_PUSH_FLOAT:
+    case AS_OP_LOAD_BOOL:
+    case AS_OP_LOAD_INT:
+    case AS_OP_LOAD_FLOAT:
+      m_depth++;
+      break;
+      
+    case AS_OP_STORE_BOOL:
+    case AS_OP_STORE_INT:
+    case AS_OP_STORE_FLOAT:
+    case AS_OP_POP:
+    case AS_OP_JUMP_FALSE:
+      m_depth--;
+      break;
+
+    case AS_OP_BOOL_TO_INT:
+    case AS_OP_BOOL_TO_FLOAT:
+    case AS_OP_INT_TO_BOOL:
+    case AS_OP_INT_TO_FLOAT:
+    case AS_OP_FLOAT_TO_BOOL:
+    case AS_OP_FLOAT_TO_INT:
+    case AS_OP_INT_BIT_NOT:
+    case AS_OP_INT_NEG:
+    case AS_OP_FLOAT_NEG:
+    case AS_OP_LOGIC_NOT:
+    case AS_OP_JUMP:
+    case AS_OP_END:
+      break;
+      
+    default:
+      // All remaining operators are binary
+      m_depth--;
+      break;
+  }
+  if (m_depth > m_max_depth) m_max_depth = m_depth;
+  
+  return m_code.GetSize() - 1;
+}
@@ -0,0 +1,69 @@
+/*
+ *  cASBytecode.h
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cASBytecode_h
+#define cASBytecode_h
+
+#include "AvidaScript.h"
+
+#include "tSmartArray.h"
+
+class cASTNode;
+
+
+// Stack machine code for a single while loop that uses only bool, int and float values.  Built by cCompileASTVisitor
+// and run by cDirectInterpretASTVisitor in place of walking the loop's subtree.
+class cASBytecode
+{
+public:
+  struct sInstruction
+  {
+    ASOpcode_t op;
+    int arg;          // constant for PUSH_BOOL/PUSH_INT, variable id for LOAD/STORE, target for JUMP/JUMP_FALSE
+    bool global;      // LOAD/STORE address the global frame rather than the current one
+    double fval;      // constant for PUSH_FLOAT
+    cASTNode* node;   // source node, used for error reporting
+
+    sInstruction() : op(AS_OP_END), arg(0), global(false), fval(0.0), node(NULL) { ; }
+  };
+
+private:
+  tSmartArray<sInstruction> m_code;
+  int m_depth;
+  int m_max_depth;
+
+
+  cASBytecode(const cASBytecode&); // @not_implemented
+  cASBytecode& operator=(const cASBytecode&); // @not_implemented
+
+
+public:
+  cASBytecode() : m_depth(0), m_max_depth(0) { ; }
+
+  int Emit(ASOpcode_t op, cASTNode* node, int arg = 0, bool global = false, double fval = 0.0);
+  inline void PatchTarget(int idx, int target) { m_code[idx].arg = target; }
+
+  inline int GetSize() const { return m_code.GetSize(); }
+  inline const sInstruction& operator[](int idx) const { return m_code[idx]; }
+
+  inline int GetMaxStackDepth() const { return m_max_depth; }
+};
+
+#endif
@@ -0,0 +1,537 @@
+/*
+ *  cCompileASTVisitor.cc
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cCompileASTVisitor.h"
+
+#include "cASBytecode.h"
+#include "cSymbolTable.h"
+
+#include "tSmartArray.h"
+
+
+#define TOKEN(x) AS_TOKEN_ ## x
+#define TYPE(x) AS_TYPE_ ## x
+#define OP(x) AS_OP_ ## x
+
+
+cCompileASTVisitor::cCompileASTVisitor(cSymbolTable* global_symtbl)
+  : m_global_symtbl(global_symtbl), m_cur_symtbl(global_symtbl), m_code(NULL), m_rtype(TYPE(INVALID)), m_failed(false)
+  , m_num_compiled(0)
+{
+}
+
+
+void cCompileASTVisitor::Compile(cASTNode* tree)
+{
+  m_cur_symtbl = m_global_symtbl;
+  tree->Accept(*this);
+
+  // Function bodies are moved out of the tree and into the symbol tables by the semantic check
+  compileFunctions(m_global_symtbl);
+  m_cur_symtbl = m_global_symtbl;
+}
+
+
+void cCompileASTVisitor::compileFunctions(cSymbolTable* symtbl)
+{
+  for (int i = 0; i < symtbl->GetNumFunctions(); i++) {
+    cASTNode* code = symtbl->GetFunctionDefinition(i);
+    cSymbolTable* fun_symtbl = symtbl->GetFunctionSymbolTable(i);
+    if (!code || !fun_symtbl) continue;
+
+    m_cur_symtbl = fun_symtbl;
+    code->Accept(*this);
+    compileFunctions(fun_symtbl);
+  }
+}
+
+
+
+void cCompileASTVisitor::VisitAssignment(cASTAssignment& node)
+{
+  if (!m_code) return;
+
+  int var_id = node.GetVarID();
+  bool global = node.IsVarGlobal();
+  ASType_t type = (global ? m_global_symtbl : m_cur_symtbl)->GetVariableType(var_id).type;
+  if (!isNumeric(type) || !emitOperand(node.GetExpression(), type, node)) {
+    unsupported();
+    return;
+  }
+
+  switch (type) {
+    case TYPE(BOOL):  m_code->Emit(OP(STORE_BOOL), &node, var_id, global); break;
+    case TYPE(INT):   m_code->Emit(OP(STORE_INT), &node, var_id, global); break;
+    case TYPE(FLOAT): m_code->Emit(OP(STORE_FLOAT), &node, var_id, global); break;
+    default: break;
+  }
+  m_rtype = TYPE(INVALID);
+}
+
+
+void cCompileASTVisitor::VisitArgumentList(cASTArgumentList& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitObjectAssignment(cASTObjectAssignment& node)
+{
+  unsupported();
+}
+
+
+
+void cCompileASTVisitor::VisitReturnStatement(cASTReturnStatement& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitStatementList(cASTStatementList& node)
+{
+  tListIterator<cASTNode> it = node.Iterator();
+
+  cASTNode* stmt = NULL;
+  while ((stmt = it.Next()) && !m_failed) {
+    if (m_code) emitStatement(stmt);
+    else stmt->Accept(*this);
+  }
+}
+
+
+
+void cCompileASTVisitor::VisitForeachBlock(cASTForeachBlock& node)
+{
+  if (m_code) {
+    unsupported();
+    return;
+  }
+
+  // Not compiled itself, but its body may hold loops that can be
+  node.GetCode()->Accept(*this);
+}
+
+
+void cCompileASTVisitor::VisitIfBlock(cASTIfBlock& node)
+{
+  if (!m_code) {
+    node.GetCode()->Accept(*this);
+    tListIterator<cASTIfBlock::cElseIf> it = node.ElseIfIterator();
+    cASTIfBlock::cElseIf* ei = NULL;
+    while ((ei = it.Next())) ei->GetCode()->Accept(*this);
+    if (node.HasElse()) node.GetElseCode()->Accept(*this);
+    return;
+  }
+
+  tSmartArray<int> end_jumps;
+
+  if (!emitOperand(node.GetCondition(), TYPE(BOOL), node)) return;
+  int next_jump = m_code->Emit(OP(JUMP_FALSE), &node);
+  emitStatement(node.GetCode());
+  if (m_failed) return;
+
+  tListIterator<cASTIfBlock::cElseIf> it = node.ElseIfIterator();
+  cASTIfBlock::cElseIf* ei = NULL;
+  while ((ei = it.Next())) {
+    end_jumps.Push(m_code->Emit(OP(JUMP), &node));
+    m_code->PatchTarget(next_jump, m_code->GetSize());
+
+    if (!emitOperand(ei->GetCondition(), TYPE(BOOL), node)) return;
+    next_jump = m_code->Emit(OP(JUMP_FALSE), &node);
+    emitStatement(ei->GetCode());
+    if (m_failed) return;
+  }
+
+  if (node.HasElse()) {
+    end_jumps.Push(m_code->Emit(OP(JUMP), &node));
+    m_code->PatchTarget(next_jump, m_code->GetSize());
+    emitStatement(node.GetElseCode());
+    if (m_failed) return;
+  } else {
+    m_code->PatchTarget(next_jump, m_code->GetSize());
+  }
+
+  for (int i = 0; i < end_jumps.GetSize(); i++) m_code->PatchTarget(end_jumps[i], m_code->GetSize());
+  m_rtype = TYPE(INVALID);
+}
+
+
+void cCompileASTVisitor::VisitWhileBlock(cASTWhileBlock& node)
+{
+  // Loops nested in a loop being compiled become part of the enclosing loop's code
+  if (m_code) {
+    emitLoop(node);
+    return;
+  }
+
+  m_code = new cASBytecode;
+  m_failed = false;
+  emitLoop(node);
+
+  if (m_failed) {
+    delete m_code;
+    m_code = NULL;
+    m_failed = false;
+
+    // Leave this loop to the interpreter, but look for loops inside of it that can still be compiled
+    node.GetCode()->Accept(*this);
+  } else {
+    m_code->Emit(OP(END), &node);
+    node.SetBytecode(m_code);
+    m_code = NULL;
+    m_num_compiled++;
+  }
+}
+
+
+
+void cCompileASTVisitor::VisitFunctionDefinition(cASTFunctionDefinition& node)
+{
+  // Function bodies are compiled from the symbol table (see compileFunctions)
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitVariableDefinition(cASTVariableDefinition& node)
+{
+  if (!m_code) return;
+
+  ASType_t type = node.GetType().type;
+  if (!isNumeric(type) || node.GetDimensions()) {
+    unsupported();
+    return;
+  }
+
+  // Without an initializer the interpreter leaves the slot untouched, so there is nothing to emit
+  if (node.GetAssignmentExpression()) {
+    if (!emitOperand(node.GetAssignmentExpression(), type, node)) return;
+
+    switch (type) {
+      case TYPE(BOOL):  m_code->Emit(OP(STORE_BOOL), &node, node.GetVarID()); break;
+      case TYPE(INT):   m_code->Emit(OP(STORE_INT), &node, node.GetVarID()); break;
+      case TYPE(FLOAT): m_code->Emit(OP(STORE_FLOAT), &node, node.GetVarID()); break;
+      default: break;
+    }
+  }
+  m_rtype = TYPE(INVALID);
+}
+
+
+void cCompileASTVisitor::VisitVariableDefinitionList(cASTVariableDefinitionList& node)
+{
+  unsupported();
+}
+
+
+
+void cCompileASTVisitor::VisitExpressionBinary(cASTExpressionBinary& node)
+{
+  if (!m_code) return;
+
+  ASType_t type = TYPE(INVALID);
+  ASOpcode_t op = OP(END);
+
+  switch (node.GetOperator()) {
+    case TOKEN(OP_LOGIC_AND):
+    case TOKEN(OP_LOGIC_OR):
+      // Both sides are always evaluated, matching the interpreter
+      type = TYPE(BOOL);
+      op = (node.GetOperator() == TOKEN(OP_LOGIC_AND)) ? OP(LOGIC_AND) : OP(LOGIC_OR);
+      break;
+
+    case TOKEN(OP_BIT_AND):
+    case TOKEN(OP_BIT_OR):
+      if (node.GetType().type == TYPE(INT)) {
+        type = TYPE(INT);
+        op = (node.GetOperator() == TOKEN(OP_BIT_AND)) ? OP(INT_BIT_AND) : OP(INT_BIT_OR);
+      }
+      break;
+
+    case TOKEN(OP_EQ):
+    case TOKEN(OP_NEQ):
+      {
+        bool eq = (node.GetOperator() == TOKEN(OP_EQ));
+        type = node.GetCompareType().type;
+        switch (type) {
+          case TYPE(BOOL):  op = eq ? OP(BOOL_EQ) : OP(BOOL_NEQ); break;
+          case TYPE(INT):   op = eq ? OP(INT_EQ) : OP(INT_NEQ); break;
+          case TYPE(FLOAT): op = eq ? OP(FLOAT_EQ) : OP(FLOAT_NEQ); break;
+          default: break;
+        }
+      }
+      break;
+
+    case TOKEN(OP_LE):
+    case TOKEN(OP_GE):
+    case TOKEN(OP_LT):
+    case TOKEN(OP_GT):
+      type = node.GetCompareType().type;
+      if (type == TYPE(INT)) {
+        switch (node.GetOperator()) {
+          case TOKEN(OP_LE): op = OP(INT_LE); break;
+          case TOKEN(OP_GE): op = OP(INT_GE); break;
+          case TOKEN(OP_LT): op = OP(INT_LT); break;
+          default:           op = OP(INT_GT); break;
+        }
+      } else if (type == TYPE(FLOAT)) {
+        switch (node.GetOperator()) {
+          case TOKEN(OP_LE): op = OP(FLOAT_LE); break;
+          case TOKEN(OP_GE): op = OP(FLOAT_GE); break;
+          case TOKEN(OP_LT): op = OP(FLOAT_LT); break;
+          default:           op = OP(FLOAT_GT); break;
+        }
+      }
+      break;
+
+    case TOKEN(OP_ADD):
+    case TOKEN(OP_SUB):
+    case TOKEN(OP_MUL):
+    case TOKEN(OP_DIV):
+    case TOKEN(OP_MOD):
+      type = node.GetType().type;
+      if (type == TYPE(INT)) {
+        switch (node.GetOperator()) {
+          case TOKEN(OP_ADD): op = OP(INT_ADD); break;
+          case TOKEN(OP_SUB): op = OP(INT_SUB); break;
+          case TOKEN(OP_MUL): op = OP(INT_MUL); break;
+          case TOKEN(OP_DIV): op = OP(INT_DIV); break;
+          default:            op = OP(INT_MOD); break;
+        }
+      } else if (type == TYPE(FLOAT)) {
+        switch (node.GetOperator()) {
+          case TOKEN(OP_ADD): op = OP(FLOAT_ADD); break;
+          case TOKEN(OP_SUB): op = OP(FLOAT_SUB); break;
+          case TOKEN(OP_MUL): op = OP(FLOAT_MUL); break;
+          case TOKEN(OP_DIV): op = OP(FLOAT_DIV); break;
+          default:            op = OP(FLOAT_MOD); break;
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  // Char, string, container and runtime typed operations are left to the interpreter
+  if (op == OP(END)) {
+    unsupported();
+    return;
+  }
+
+  if (!emitOperand(node.GetLeft(), type, node)) return;
+  if (!emitOperand(node.GetRight(), type, node)) return;
+  m_code->Emit(op, &node);
+
+  switch (op) {
+    case OP(INT_BIT_AND): case OP(INT_BIT_OR):
+    case OP(INT_ADD): case OP(INT_SUB): case OP(INT_MUL): case OP(INT_DIV): case OP(INT_MOD):
+      m_rtype = TYPE(INT);
+      break;
+    case OP(FLOAT_ADD): case OP(FLOAT_SUB): case OP(FLOAT_MUL): case OP(FLOAT_DIV): case OP(FLOAT_MOD):
+      m_rtype = TYPE(FLOAT);
+      break;
+    default:
+      m_rtype = TYPE(BOOL);
+      break;
+  }
+}
+
+
+void cCompileASTVisitor::VisitExpressionUnary(cASTExpressionUnary& node)
+{
+  if (!m_code) return;
+
+  node.GetExpression()->Accept(*this);
+  if (m_failed) return;
+
+  switch (node.GetOperator()) {
+    case TOKEN(OP_BIT_NOT):
+      if (m_rtype == TYPE(INT)) m_code->Emit(OP(INT_BIT_NOT), &node);
+      else unsupported();
+      break;
+
+    case TOKEN(OP_LOGIC_NOT):
+      if (emitCast(m_rtype, TYPE(BOOL), node)) {
+        m_code->Emit(OP(LOGIC_NOT), &node);
+        m_rtype = TYPE(BOOL);
+      }
+      break;
+
+    case TOKEN(OP_SUB):
+      if (m_rtype == TYPE(INT)) m_code->Emit(OP(INT_NEG), &node);
+      else if (m_rtype == TYPE(FLOAT)) m_code->Emit(OP(FLOAT_NEG), &node);
+      else unsupported();
+      break;
+
+    default:
+      unsupported();
+      break;
+  }
+}
+
+
+
+void cCompileASTVisitor::VisitBuiltInCall(cASTBuiltInCall& node)
+{
+  if (!m_code) return;
+
+  ASType_t type = TYPE(INVALID);
+  switch (node.GetBuiltIn()) {
+    case AS_BUILTIN_CAST_BOOL:  type = TYPE(BOOL); break;
+    case AS_BUILTIN_CAST_INT:   type = TYPE(INT); break;
+    case AS_BUILTIN_CAST_FLOAT: type = TYPE(FLOAT); break;
+    default: break;
+  }
+
+  if (type == TYPE(INVALID) || node.GetTarget() || !node.HasArguments() || node.GetArguments()->GetSize() != 1) {
+    unsupported();
+    return;
+  }
+
+  if (emitOperand(node.GetArguments()->Iterator().Next(), type, node)) m_rtype = type;
+}
+
+
+void cCompileASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitLiteral(cASTLiteral& node)
+{
+  if (!m_code) return;
+
+  switch (node.GetType().type) {
+    case TYPE(BOOL):  m_code->Emit(OP(PUSH_BOOL), &node, node.GetBoolValue() ? 1 : 0); break;
+    case TYPE(INT):   m_code->Emit(OP(PUSH_INT), &node, node.GetIntValue()); break;
+    case TYPE(FLOAT): m_code->Emit(OP(PUSH_FLOAT), &node, 0, false, node.GetFloatValue()); break;
+    default:
+      unsupported();
+      return;
+  }
+  m_rtype = node.GetType().type;
+}
+
+
+void cCompileASTVisitor::VisitLiteralArray(cASTLiteralArray& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitLiteralDict(cASTLiteralDict& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitObjectCall(cASTObjectCall& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitObjectReference(cASTObjectReference& node)
+{
+  unsupported();
+}
+
+
+void cCompileASTVisitor::VisitVariableReference(cASTVariableReference& node)
+{
+  if (!m_code) return;
+
+  // Use the node's type, as the interpreter does, rather than looking the variable up again
+  switch (node.GetType().type) {
+    case TYPE(BOOL):  m_code->Emit(OP(LOAD_BOOL), &node, node.GetVarID(), node.IsVarGlobal()); break;
+    case TYPE(INT):   m_code->Emit(OP(LOAD_INT), &node, node.GetVarID(), node.IsVarGlobal()); break;
+    case TYPE(FLOAT): m_code->Emit(OP(LOAD_FLOAT), &node, node.GetVarID(), node.IsVarGlobal()); break;
+    default:
+      unsupported();
+      return;
+  }
+  m_rtype = node.GetType().type;
+}
+
+
+void cCompileASTVisitor::VisitUnpackTarget(cASTUnpackTarget& node)
+{
+  unsupported();
+}
+
+
+
+void cCompileASTVisitor::emitStatement(cASTNode* node)
+{
+  m_rtype = TYPE(INVALID);
+  node->Accept(*this);
+
+  // Expression statements leave their value on the stack
+  if (!m_failed && m_rtype != TYPE(INVALID)) m_code->Emit(OP(POP), node);
+  m_rtype = TYPE(INVALID);
+}
+
+
+void cCompileASTVisitor::emitLoop(cASTWhileBlock& node)
+{
+  int top = m_code->GetSize();
+  if (!emitOperand(node.GetCondition(), TYPE(BOOL), node)) return;
+  int exit_jump = m_code->Emit(OP(JUMP_FALSE), &node);
+
+  emitStatement(node.GetCode());
+  if (m_failed) return;
+
+  m_code->Emit(OP(JUMP), &node, top);
+  m_code->PatchTarget(exit_jump, m_code->GetSize());
+  m_rtype = TYPE(INVALID);
+}
+
+
+bool cCompileASTVisitor::emitOperand(cASTNode* expr, ASType_t type, cASTNode& node)
+{
+  m_rtype = TYPE(INVALID);
+  expr->Accept(*this);
+  if (m_failed) return false;
+
+  return emitCast(m_rtype, type, node);
+}
+
+
+bool cCompileASTVisitor::emitCast(ASType_t from, ASType_t to, cASTNode& node)
+{
+  if (!isNumeric(from) || !isNumeric(to)) {
+    unsupported();
+    return false;
+  }
+
+  if (from != to) {
+    switch (from) {
+      case TYPE(BOOL):  m_code->Emit((to == TYPE(INT)) ? OP(BOOL_TO_INT) : OP(BOOL_TO_FLOAT), &node); break;
+      case TYPE(INT):   m_code->Emit((to == TYPE(BOOL)) ? OP(INT_TO_BOOL) : OP(INT_TO_FLOAT), &node); break;
+      case TYPE(FLOAT): m_code->Emit((to == TYPE(BOOL)) ? OP(FLOAT_TO_BOOL) : OP(FLOAT_TO_INT), &node); break;
+      default: break;
+    }
+  }
+  m_rtype = to;
+
+  return true;
+}
@@ -0,0 +1,101 @@
+/*
+ *  cCompileASTVisitor.h
+ *  Avida
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cCompileASTVisitor_h
+#define cCompileASTVisitor_h
+
+#include "cASTVisitor.h"
+
+class cASBytecode;
+class cSymbolTable;
+
+
+// Compiles while loops that only touch bool, int and float values into cASBytecode.  Must run after the semantic
+// check, since it relies on the resolved variable ids and expression types.  Loops containing anything else (function
+// calls, returns, strings, chars, containers, runtime typed values) are left for the AST interpreter, though any
+// qualifying loops nested inside them are still compiled.
+class cCompileASTVisitor : public cASTVisitor
+{
+private:
+  cSymbolTable* m_global_symtbl;
+  cSymbolTable* m_cur_symtbl;
+
+  cASBytecode* m_code;  // Loop currently being compiled, NULL while searching for loops
+  ASType_t m_rtype;     // Type of the value left on the stack by the last expression, AS_TYPE_INVALID for statements
+  bool m_failed;
+
+  int m_num_compiled;
+
+
+  cCompileASTVisitor(); // @not_implemented
+  cCompileASTVisitor(const cCompileASTVisitor&); // @not_implemented
+  cCompileASTVisitor& operator=(const cCompileASTVisitor&); // @not_implemented
+
+
+public:
+  cCompileASTVisitor(cSymbolTable* global_symtbl);
+
+  void Compile(cASTNode* tree);
+  inline int GetNumCompiled() const { return m_num_compiled; }
+
+  void VisitAssignment(cASTAssignment&);
+  void VisitArgumentList(cASTArgumentList&);
+  void VisitObjectAssignment(cASTObjectAssignment&);
+
+  void VisitReturnStatement(cASTReturnStatement&);
+  void VisitStatementList(cASTStatementList&);
+
+  void VisitForeachBlock(cASTForeachBlock&);
+  void VisitIfBlock(cASTIfBlock&);
+  void VisitWhileBlock(cASTWhileBlock&);
+
+  void VisitFunctionDefinition(cASTFunctionDefinition&);
+  void VisitVariableDefinition(cASTVariableDefinition&);
+  void VisitVariableDefinitionList(cASTVariableDefinitionList&);
+
+  void VisitExpressionBinary(cASTExpressionBinary&);
+  void VisitExpressionUnary(cASTExpressionUnary&);
+
+  void VisitBuiltInCall(cASTBuiltInCall&);
+  void VisitFunctionCall(cASTFunctionCall&);
+  void VisitLiteral(cASTLiteral&);
+  void VisitLiteralArray(cASTLiteralArray&);
+  void VisitLiteralDict(cASTLiteralDict&);
+  void VisitObjectCall(cASTObjectCall&);
+  void VisitObjectReference(cASTObjectReference&);
+  void VisitVariableReference(cASTVariableReference&);
+  void VisitUnpackTarget(cASTUnpackTarget&);
+
+private:
+  void compileFunctions(cSymbolTable* symtbl);
+
+  void emitStatement(cASTNode* node);
+  void emitLoop(cASTWhileBlock& node);
+  bool emitOperand(cASTNode* expr, ASType_t type, cASTNode& node);
+  bool emitCast(ASType_t from, ASType_t to, cASTNode& node);
+
+  inline void unsupported() { if (m_code) m_failed = true; }
+  inline bool isNumeric(ASType_t type) const
+  {
+    return (type == AS_TYPE_BOOL || type == AS_TYPE_INT || type == AS_TYPE_FLOAT);
+  }
+};
+
+#endif
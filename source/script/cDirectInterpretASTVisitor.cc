@@ -27,6 +27,7 @@
 #include "avida/Avida.h"
 #include "AvidaScript.h"
 
+#include "cASBytecode.h"
 #include "cASFunction.h"
 #include "cStringUtil.h"
 #include "cSymbolTable.h"
@@ -44,6 +45,7 @@ using namespace AvidaScript;
 
 #define TOKEN(x) AS_TOKEN_ ## x
 #define TYPE(x) AS_TYPE_ ## x
+#define OP(x) AS_OP_ ## x
 
 
 cDirectInterpretASTVisitor::cDirectInterpretASTVisitor(cSymbolTable* global_symtbl)
@@ -212,39 +214,66 @@ void cDirectInterpretASTVisitor::VisitForeachBlock(cASTForeachBlock& node)
   for (int i = 0; i < arr->GetSize(); i++) {
     // Set the variable value for this iteration
     const sAggregateValue& val = arr->Get(i);
+    
+    // String elements are copied into the loop variable's existing string, rather than reallocating it every iteration
+    if (var_type.type == TYPE(STRING) && val.type.type == TYPE(STRING)) {
+      if (m_call_stack[var_idx].value.as_string) *m_call_stack[var_idx].value.as_string = *val.value.as_string;
+      else m_call_stack[var_idx].value.as_string = new cString(*val.value.as_string);
+      
+      node.GetCode()->Accept(*this);
+      continue;
+    }
+    
+    // The element is still owned by the array, so take a reference for the loop variable (the conversions below
+    // consume their argument)
+    uAnyType elem = val.value;
+    switch (val.type.type) {
+      case TYPE(ARRAY):       elem.as_array->GetReference(); break;
+      case TYPE(DICT):        elem.as_dict->GetReference(); break;
+      case TYPE(MATRIX):      elem.as_matrix->GetReference(); break;
+      case TYPE(OBJECT_REF):  elem.as_nobj->GetReference(); break;
+      case TYPE(STRING):      elem.as_string = new cString(*val.value.as_string); break;
+      default: break;
+    }
+    
     switch (var_type.type) {
-      case TYPE(BOOL):        m_call_stack[var_idx].value.as_bool = asBool(val.type, val.value, node); break;
-      case TYPE(CHAR):        m_call_stack[var_idx].value.as_char = asChar(val.type, val.value, node); break;
-      case TYPE(FLOAT):       m_call_stack[var_idx].value.as_float = asFloat(val.type, val.value, node); break;
-      case TYPE(INT):         m_call_stack[var_idx].value.as_int = asInt(val.type, val.value, node); break;
+      case TYPE(BOOL):        m_call_stack[var_idx].value.as_bool = asBool(val.type, elem, node); break;
+      case TYPE(CHAR):        m_call_stack[var_idx].value.as_char = asChar(val.type, elem, node); break;
+      case TYPE(FLOAT):       m_call_stack[var_idx].value.as_float = asFloat(val.type, elem, node); break;
+      case TYPE(INT):         m_call_stack[var_idx].value.as_int = asInt(val.type, elem, node); break;
       case TYPE(OBJECT_REF):
-        m_call_stack[var_idx].value.as_nobj->RemoveReference();
-        m_call_stack[var_idx].value.as_nobj = asNativeObject(var_type.info, val.type, val.value, node);
+        if (m_call_stack[var_idx].value.as_nobj) m_call_stack[var_idx].value.as_nobj->RemoveReference();
+        m_call_stack[var_idx].value.as_nobj = asNativeObject(var_type.info, val.type, elem, node);
         break;
         
       case TYPE(ARRAY):
-        m_call_stack[var_idx].value.as_array->RemoveReference();
-        m_call_stack[var_idx].value.as_array = asArray(val.type, val.value, node);
+        if (m_call_stack[var_idx].value.as_array) m_call_stack[var_idx].value.as_array->RemoveReference();
+        m_call_stack[var_idx].value.as_array = asArray(val.type, elem, node);
         break;
         
       case TYPE(DICT):
-        m_call_stack[var_idx].value.as_dict->RemoveReference();
-        m_call_stack[var_idx].value.as_dict = asDict(val.type, val.value, node);
+        if (m_call_stack[var_idx].value.as_dict) m_call_stack[var_idx].value.as_dict->RemoveReference();
+        m_call_stack[var_idx].value.as_dict = asDict(val.type, elem, node);
         break;
         
       case TYPE(VAR):
-        m_call_stack[var_idx].value = val.value;
+        m_call_stack[var_idx].Cleanup();
+        m_call_stack[var_idx].value = elem;
         m_call_stack[var_idx].type = val.type;
         break;
         
       case TYPE(MATRIX):
-        m_call_stack[var_idx].value.as_matrix->RemoveReference();
-        m_call_stack[var_idx].value.as_matrix = asMatrix(val.type, val.value, node);
+        if (m_call_stack[var_idx].value.as_matrix) m_call_stack[var_idx].value.as_matrix->RemoveReference();
+        m_call_stack[var_idx].value.as_matrix = asMatrix(val.type, elem, node);
         break;
         
       case TYPE(STRING):
         delete m_call_stack[var_idx].value.as_string;
-        m_call_stack[var_idx].value.as_string = asString(val.type, val.value, node);
+        m_call_stack[var_idx].value.as_string = asString(val.type, elem, node);
+        
+        // asString only describes matrices and objects, so release the reference taken above
+        if (val.type.type == TYPE(MATRIX)) elem.as_matrix->RemoveReference();
+        else if (val.type.type == TYPE(OBJECT_REF)) elem.as_nobj->RemoveReference();
         break;
         
       default:
@@ -285,6 +314,11 @@ void cDirectInterpretASTVisitor::VisitIfBlock(cASTIfBlock& node)
 
 void cDirectInterpretASTVisitor::VisitWhileBlock(cASTWhileBlock& node)
 {
+  if (node.GetBytecode()) {
+    runBytecode(*node.GetBytecode());
+    return;
+  }
+  
   node.GetCondition()->Accept(*this);
   while (asBool(m_rtype, m_rvalue, node)) {
     node.GetCode()->Accept(*this);
@@ -1227,10 +1261,10 @@ void cDirectInterpretASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
     m_call_stack.Resize(m_call_stack.GetSize() + func_symtbl->GetNumVariables());
     for (int i = 0; i < func_symtbl->GetNumVariables(); i++) {
       switch (func_symtbl->GetVariableType(i).type) {
-        case TYPE(ARRAY):       m_call_stack[sp + i].value.as_array = new cLocalArray; break;
+        case TYPE(ARRAY):       m_call_stack[sp + i].value.as_array = NULL; break;
         case TYPE(BOOL):        m_call_stack[sp + i].value.as_bool = false; break;
         case TYPE(CHAR):        m_call_stack[sp + i].value.as_char = 0; break;
-        case TYPE(DICT):        m_call_stack[sp + i].value.as_dict = new cLocalDict; break;
+        case TYPE(DICT):        m_call_stack[sp + i].value.as_dict = NULL; break;
         case TYPE(INT):         m_call_stack[sp + i].value.as_int = 0; break;
         case TYPE(FLOAT):       m_call_stack[sp + i].value.as_float = 0.0; break;
         case TYPE(MATRIX):      m_call_stack[sp + i].value.as_matrix = NULL; break;
@@ -1277,6 +1311,19 @@ void cDirectInterpretASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
       }
     }
     
+    // Allocate the remaining array and dict locals, now that the arguments have claimed theirs
+    for (int i = 0; i < func_symtbl->GetNumVariables(); i++) {
+      switch (func_symtbl->GetVariableType(i).type) {
+        case TYPE(ARRAY):
+          if (!m_call_stack[sp + i].value.as_array) m_call_stack[sp + i].value.as_array = new cLocalArray;
+          break;
+        case TYPE(DICT):
+          if (!m_call_stack[sp + i].value.as_dict) m_call_stack[sp + i].value.as_dict = new cLocalDict;
+          break;
+        default: break;
+      }
+    }
+    
     
     // Execute the function
     m_cur_symtbl = func_symtbl;
@@ -1330,20 +1377,19 @@ void cDirectInterpretASTVisitor::VisitLiteral(cASTLiteral& node)
 {
   switch (node.GetType().type) {
     case TYPE(BOOL):
-      if (node.GetValue() == "true") m_rvalue.as_bool = true;
-      else m_rvalue.as_bool = false;
+      m_rvalue.as_bool = node.GetBoolValue();
       m_rtype = TYPE(BOOL);
       break;
     case TYPE(CHAR):
-      m_rvalue.as_char = node.GetValue()[0];
+      m_rvalue.as_char = node.GetCharValue();
       m_rtype = TYPE(CHAR);
       break;
-      case TYPE(INT):
-      m_rvalue.as_int = node.GetValue().AsInt();
+    case TYPE(INT):
+      m_rvalue.as_int = node.GetIntValue();
       m_rtype = TYPE(INT);
       break;
     case TYPE(FLOAT):
-      m_rvalue.as_float = node.GetValue().AsDouble();
+      m_rvalue.as_float = node.GetFloatValue();
       m_rtype = TYPE(FLOAT);
       break;
     case TYPE(STRING):
@@ -2198,13 +2244,24 @@ void cDirectInterpretASTVisitor::matrixMultiply_FullInt(cLocalMatrix* m1, cLocal
   cLocalMatrix* mat = new cLocalMatrix();
   mat->Resize(sz_x, sz_y);
   
+  // Accumulate each result row across the rows of op2, so that the inner loop walks contiguous memory and can be
+  // vectorized; each element is still summed over k in ascending order
+  const int sz_k = m1->GetNumCols();
+  tArray<int> acc(sz_y);
   sASTypeInfo op_type(TYPE(INT));
   for (int i = 0; i < sz_x; i++) {
+    acc.SetAll(0);
+    const tArray<int>& row1 = op1[i];
+    for (int k = 0; k < sz_k; k++) {
+      const int a = row1[k];
+      const tArray<int>& row2 = op2[k];
+      for (int j = 0; j < sz_y; j++) acc[j] += a * row2[j];
+    }
+    
     cLocalArray* row = mat->GetRow(i);
     for (int j = 0; j < sz_y; j++) {
       uAnyType sum;
-      sum.as_int = 0;
-      for (int k = 0; k < m1->GetNumCols(); k++) sum.as_int += op1[i][k] * op2[k][j];
+      sum.as_int = acc[j];
       row->Set(j, op_type, sum);
     }
   }
@@ -2257,13 +2314,24 @@ void cDirectInterpretASTVisitor::matrixMultiply_FullFloat(cLocalMatrix* m1, cLoc
   cLocalMatrix* mat = new cLocalMatrix();
   mat->Resize(sz_x, sz_y);
   
+  // Accumulate each result row across the rows of op2, so that the inner loop walks contiguous memory and can be
+  // vectorized; each element is still summed over k in ascending order
+  const int sz_k = m1->GetNumCols();
+  tArray<double> acc(sz_y);
   sASTypeInfo op_type(TYPE(FLOAT));
   for (int i = 0; i < sz_x; i++) {
+    acc.SetAll(0.0);
+    const tArray<double>& row1 = op1[i];
+    for (int k = 0; k < sz_k; k++) {
+      const double a = row1[k];
+      const tArray<double>& row2 = op2[k];
+      for (int j = 0; j < sz_y; j++) acc[j] += a * row2[j];
+    }
+    
     cLocalArray* row = mat->GetRow(i);
     for (int j = 0; j < sz_y; j++) {
       uAnyType sum;
-      sum.as_float = 0.0;
-      for (int k = 0; k < m1->GetNumCols(); k++) sum.as_float += op1[i][k] * op2[k][j];
+      sum.as_float = acc[j];
       row->Set(j, op_type, sum);
     }
   }
@@ -2273,6 +2341,98 @@ void cDirectInterpretASTVisitor::matrixMultiply_FullFloat(cLocalMatrix* m1, cLoc
 }
 
 
+void cDirectInterpretASTVisitor::runBytecode(const cASBytecode& code)
+{
+  if (m_value_stack.GetSize() < code.GetMaxStackDepth()) m_value_stack.Resize(code.GetMaxStackDepth());
+  
+  // Compiled loops cannot call functions, so neither frame can move while the loop runs
+  sAggregateValue* globals = (m_call_stack.GetSize()) ? &m_call_stack[0] : NULL;
+  sAggregateValue* locals = (m_sp < m_call_stack.GetSize()) ? &m_call_stack[m_sp] : NULL;
+  uAnyType* stack = &m_value_stack[0] - 1;  // points at the top of stack, which starts out empty
+  
+  int pc = 0;
+  while (true) {
+    const cASBytecode::sInstruction& inst = code[pc++];
+    switch (inst.op) {
+      case OP(PUSH_BOOL):     (++stack)->as_bool = inst.arg; break;
+      case OP(PUSH_INT):      (++stack)->as_int = inst.arg; break;
+      case OP(PUSH_FLOAT):    (++stack)->as_float = inst.fval; break;
+      case OP(LOAD_BOOL):     (++stack)->as_bool = (inst.global ? globals : locals)[inst.arg].value.as_bool; break;
+      case OP(LOAD_INT):      (++stack)->as_int = (inst.global ? globals : locals)[inst.arg].value.as_int; break;
+      case OP(LOAD_FLOAT):    (++stack)->as_float = (inst.global ? globals : locals)[inst.arg].value.as_float; break;
+      case OP(STORE_BOOL):    (inst.global ? globals : locals)[inst.arg].value.as_bool = (stack--)->as_bool; break;
+      case OP(STORE_INT):     (inst.global ? globals : locals)[inst.arg].value.as_int = (stack--)->as_int; break;
+      case OP(STORE_FLOAT):   (inst.global ? globals : locals)[inst.arg].value.as_float = (stack--)->as_float; break;
+      case OP(POP):           stack--; break;
+        
+      case OP(BOOL_TO_INT):   stack->as_int = stack->as_bool ? 1 : 0; break;
+      case OP(BOOL_TO_FLOAT): stack->as_float = stack->as_bool ? 1.0 : 0.0; break;
+      case OP(INT_TO_BOOL):   stack->as_bool = (stack->as_int != 0); break;
+      case OP(INT_TO_FLOAT):  stack->as_float = stack->as_int; break;
+      case OP(FLOAT_TO_BOOL): stack->as_bool = (stack->as_float != 0); break;
+      case OP(FLOAT_TO_INT):  stack->as_int = (int)stack->as_float; break;
+        
+      case OP(INT_ADD):       stack--; stack->as_int = stack->as_int + stack[1].as_int; break;
+      case OP(INT_SUB):       stack--; stack->as_int = stack->as_int - stack[1].as_int; break;
+      case OP(INT_MUL):       stack--; stack->as_int = stack->as_int * stack[1].as_int; break;
+      case OP(INT_DIV):
+        stack--;
+        if (stack[1].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, inst.node->GetFilePosition(), __LINE__);
+        stack->as_int = stack->as_int / stack[1].as_int;
+        break;
+      case OP(INT_MOD):
+        stack--;
+        if (stack[1].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, inst.node->GetFilePosition(), __LINE__);
+        stack->as_int = stack->as_int % stack[1].as_int;
+        break;
+      case OP(INT_BIT_AND):   stack--; stack->as_int = stack->as_int & stack[1].as_int; break;
+      case OP(INT_BIT_OR):    stack--; stack->as_int = stack->as_int | stack[1].as_int; break;
+      case OP(INT_BIT_NOT):   stack->as_int = ~stack->as_int; break;
+      case OP(INT_NEG):       stack->as_int = -stack->as_int; break;
+        
+      case OP(FLOAT_ADD):     stack--; stack->as_float = stack->as_float + stack[1].as_float; break;
+      case OP(FLOAT_SUB):     stack--; stack->as_float = stack->as_float - stack[1].as_float; break;
+      case OP(FLOAT_MUL):     stack--; stack->as_float = stack->as_float * stack[1].as_float; break;
+      case OP(FLOAT_DIV):
+        stack--;
+        if (stack[1].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, inst.node->GetFilePosition(), __LINE__);
+        stack->as_float = stack->as_float / stack[1].as_float;
+        break;
+      case OP(FLOAT_MOD):
+        stack--;
+        if (stack[1].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, inst.node->GetFilePosition(), __LINE__);
+        stack->as_float = fmod(stack->as_float, stack[1].as_float);
+        break;
+      case OP(FLOAT_NEG):     stack->as_float = -stack->as_float; break;
+        
+      case OP(LOGIC_AND):     stack--; stack->as_bool = (stack->as_bool && stack[1].as_bool); break;
+      case OP(LOGIC_OR):      stack--; stack->as_bool = (stack->as_bool || stack[1].as_bool); break;
+      case OP(LOGIC_NOT):     stack->as_bool = !stack->as_bool; break;
+      case OP(BOOL_EQ):       stack--; stack->as_bool = (stack->as_bool == stack[1].as_bool); break;
+      case OP(BOOL_NEQ):      stack--; stack->as_bool = (stack->as_bool != stack[1].as_bool); break;
+      case OP(INT_EQ):        stack--; stack->as_bool = (stack->as_int == stack[1].as_int); break;
+      case OP(INT_NEQ):       stack--; stack->as_bool = (stack->as_int != stack[1].as_int); break;
+      case OP(INT_LT):        stack--; stack->as_bool = (stack->as_int < stack[1].as_int); break;
+      case OP(INT_LE):        stack--; stack->as_bool = (stack->as_int <= stack[1].as_int); break;
+      case OP(INT_GT):        stack--; stack->as_bool = (stack->as_int > stack[1].as_int); break;
+      case OP(INT_GE):        stack--; stack->as_bool = (stack->as_int >= stack[1].as_int); break;
+      case OP(FLOAT_EQ):      stack--; stack->as_bool = (stack->as_float == stack[1].as_float); break;
+      case OP(FLOAT_NEQ):     stack--; stack->as_bool = (stack->as_float != stack[1].as_float); break;
+      case OP(FLOAT_LT):      stack--; stack->as_bool = (stack->as_float < stack[1].as_float); break;
+      case OP(FLOAT_LE):      stack--; stack->as_bool = (stack->as_float <= stack[1].as_float); break;
+      case OP(FLOAT_GT):      stack--; stack->as_bool = (stack->as_float > stack[1].as_float); break;
+      case OP(FLOAT_GE):      stack--; stack->as_bool = (stack->as_float >= stack[1].as_float); break;
+        
+      case OP(JUMP):          pc = inst.arg; break;
+      case OP(JUMP_FALSE):    if (!(stack--)->as_bool) pc = inst.arg; break;
+        
+      case OP(END):
+        return;
+    }
+  }
+}
+
+
 
 
 void cDirectInterpretASTVisitor::sAggregateValue::Cleanup()
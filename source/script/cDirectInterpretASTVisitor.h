@@ -29,6 +29,7 @@
 #include "tManagedPointerArray.h"
 #include "tSmartArray.h"
 
+class cASBytecode;
 class cSymbolTable;
 
 
@@ -78,6 +79,7 @@ private:
   
   tSmartArray<sAggregateValue> m_call_stack;
   int m_sp;
+  tSmartArray<uAnyType> m_value_stack; // Operand stack for compiled loops
   bool m_has_returned;
   bool m_obj_assign;
   
@@ -145,6 +147,8 @@ private:
   void matrixMultiply_FullInt(cLocalMatrix* m1, cLocalMatrix* m2, cASTNode& node);
   void matrixMultiply_FullFloat(cLocalMatrix* m1, cLocalMatrix* m2, cASTNode& node);
   
+  void runBytecode(const cASBytecode& code);
+  
   void reportError(ASDirectInterpretError_t err, const cASFilePosition& fp, const int line, ...);
   
 
@@ -0,0 +1,97 @@
+/*
+ *  main.cc
+ *  Avida
+ *
+ *  Copyright 1999-2011 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AvidaTools.h"
+
+#include "apto/core/FileSystem.h"
+#include "avida/Avida.h"
+#include "avida/util/CmdLine.h"
+
+#include "cAvidaConfig.h"
+#include "cDefaultRunDriver.h"
+#include "cMultiThreadWorld.h"
+#include "cUserFeedback.h"
+
+#include <sstream>
+
+
+int main(int argc, char * argv[])
+{
+  Avida::Initialize();
+  
+  cout << Avida::Version::Banner() << endl;
+
+  // Each world gets its own configuration, so that seeds and data directories can differ
+  cAvidaConfig* cfg = new cAvidaConfig();
+  Avida::Util::ProcessCmdLineArgs(argc, argv, cfg);
+  
+  const int num_worlds = cfg->MT_NUM_WORLDS.Get();
+  if (num_worlds < 1) {
+    cerr << "error: MT_NUM_WORLDS must be at least 1" << endl;
+    return -1;
+  }
+  if (cfg->ANALYZE_MODE.Get() > 0) {
+    cerr << "error: analyze mode is not supported by multi-threaded Avida" << endl;
+    return -1;
+  }
+
+  cMultiThreadUniverse universe(num_worlds);
+  int base_seed = cfg->RANDOM_SEED.Get();
+  
+  for (int i = 0; i < num_worlds; i++) {
+    if (i > 0) {
+      cfg = new cAvidaConfig();
+      Avida::Util::ProcessCmdLineArgs(argc, argv, cfg);
+    }
+    
+    // As in Avida-MP, offset the random seed and data directory by the world index.  A time based
+    // seed is drawn once by the first world, so that worlds started within the same second differ.
+    if (i > 0 || base_seed > 0) cfg->RANDOM_SEED.Set(base_seed + i);
+    std::ostringstream dirname;
+    dirname << cfg->DATA_DIR.Get() << "_" << i;
+    cfg->DATA_DIR.Set(dirname.str().c_str());
+
+    cUserFeedback feedback;
+    cMultiThreadWorld* world = cMultiThreadWorld::Initialize(cfg, cString(Apto::FileSystem::GetCWD()), &universe, i, &feedback);
+    
+    for (int j = 0; j < feedback.GetNumMessages(); j++) {
+      switch (feedback.GetMessageType(j)) {
+        case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
+        case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
+        default: break;
+      };
+      cerr << feedback.GetMessage(j) << endl;
+    }
+    
+    if (!world) return -1;
+    if (i == 0) base_seed = world->GetRandom().GetSeed();
+
+    cout << "World " << i << ": Random Seed: " << world->GetRandom().GetSeed()
+         << ", Data Directory: " << world->GetDataFileManager().GetTargetDir() << endl;
+    
+    universe.SetWorld(i, world, new cDefaultRunDriver(world));
+  }
+  
+  cout << endl;
+  
+  universe.Run();
+  
+  return 0;
+}
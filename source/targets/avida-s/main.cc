@@ -27,6 +27,7 @@
 #include "ASAnalyzeLib.h"
 
 #include "cASLibrary.h"
+#include "cCompileASTVisitor.h"
 #include "cDirectInterpretASTVisitor.h"
 #include "cDumpASTVisitor.h"
 #include "cFile.h"
@@ -34,14 +35,35 @@
 #include "cSemanticASTVisitor.h"
 #include "cSymbolTable.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 
 
+// Runs the checked tree the requested number of times and returns the processor time taken, in seconds
+static double timeInterpret(cSymbolTable* global_symtbl, cASTNode* tree, int repeats)
+{
+  clock_t start = clock();
+  for (int i = 0; i < repeats; i++) {
+    cDirectInterpretASTVisitor interpeter(global_symtbl);
+    interpeter.Interpret(tree);
+  }
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
 int main (int argc, char * const argv[])
 {
   Avida::Initialize();
 
   Avida::PrintVersionBanner();
+  
+  // -b <repeats> times the script with and without compiled loops instead of running it once
+  int bench_repeats = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) bench_repeats = atoi(argv[++i]);
+  }
 
   cASLibrary* lib = new cASLibrary;  
   RegisterASCoreLib(lib);
@@ -69,6 +91,20 @@ int main (int argc, char * const argv[])
         exit(AS_EXIT_FAIL_SEMANTIC);
       }
       
+      double ast_time = 0.0;
+      if (bench_repeats > 0) ast_time = timeInterpret(&global_symtbl, tree, bench_repeats);
+      
+      cCompileASTVisitor compiler(&global_symtbl);
+      compiler.Compile(tree);
+      
+      if (bench_repeats > 0) {
+        double compiled_time = timeInterpret(&global_symtbl, tree, bench_repeats);
+        std::cout << "loops compiled:   " << compiler.GetNumCompiled() << std::endl;
+        std::cout << "AST interpreter:  " << ast_time << " s (" << bench_repeats << " runs)" << std::endl;
+        std::cout << "with bytecode:    " << compiled_time << " s (" << bench_repeats << " runs)" << std::endl;
+        exit(AS_EXIT_OK);
+      }
+      
       cDirectInterpretASTVisitor interpeter(&global_symtbl);
       int exit_code = interpeter.Interpret(tree);
       
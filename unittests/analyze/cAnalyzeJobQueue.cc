@@ -0,0 +1,184 @@
+/*
+ *  unittests/analyze/cAnalyzeJobQueue.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cAnalyzeJobQueue.h"
+
+#include "apto/core/Atomic.h"
+
+#include "cAnalyzeJob.h"
+#include "tArray.h"
+#include "tSmartArray.h"
+
+#include "cAnalyzeTestWorld.h"
+
+#include "gtest/gtest.h"
+
+
+namespace {
+
+  const int s_worker_counts[] = { 1, 2, 8 };
+  const int s_num_worker_counts = 3;
+
+  // Counts its runs in its own slot, and records the ID the queue gave it
+  class cCountingJob : public cAnalyzeJob
+  {
+  private:
+    volatile int* m_runs;
+    int* m_ids;
+
+  public:
+    cCountingJob(volatile int* runs, int* ids) : m_runs(runs), m_ids(ids) { ; }
+
+    void Run(cAvidaContext&)
+    {
+      Apto::Atomic::Inc(m_runs);
+      if (m_ids) *m_ids = GetID();
+    }
+  };
+
+  // Submits further counting jobs from inside a worker, as the landscape and knockout jobs do
+  class cSpawningJob : public cAnalyzeJob
+  {
+  private:
+    cAnalyzeJobQueue& m_queue;
+    volatile int* m_child_runs;
+    int m_num_children;
+
+  public:
+    cSpawningJob(cAnalyzeJobQueue& queue, volatile int* child_runs, int num_children)
+      : m_queue(queue), m_child_runs(child_runs), m_num_children(num_children) { ; }
+
+    void Run(cAvidaContext&)
+    {
+      for (int i = 0; i < m_num_children; i++) m_queue.AddJobImmediate(new cCountingJob(m_child_runs, NULL));
+    }
+  };
+
+  void ExpectAllRunOnce(const tArray<int>& runs)
+  {
+    for (int i = 0; i < runs.GetSize(); i++) EXPECT_EQ(1, runs[i]) << "job " << i;
+  }
+
+};
+
+
+TEST(AnalyzeJobQueue, BlockOfJobsRunsOnce) {
+  const int num_jobs = 1000;
+
+  for (int c = 0; c < s_num_worker_counts; c++) {
+    cAnalyzeTestWorld world;
+    cAnalyzeJobQueue queue(&world, s_worker_counts[c], 1);
+
+    tArray<int> runs(num_jobs, 0);
+    tSmartArray<cAnalyzeJob*> jobs(num_jobs);
+    for (int i = 0; i < num_jobs; i++) jobs[i] = new cCountingJob(&runs[i], NULL);
+    queue.AddJobs(jobs);
+    queue.Execute();
+
+    ExpectAllRunOnce(runs);
+  }
+}
+
+
+TEST(AnalyzeJobQueue, SingleJobsRunOnce) {
+  const int num_jobs = 1000;
+
+  for (int c = 0; c < s_num_worker_counts; c++) {
+    cAnalyzeTestWorld world;
+    cAnalyzeJobQueue queue(&world, s_worker_counts[c], 1);
+
+    tArray<int> runs(num_jobs, 0);
+    for (int i = 0; i < num_jobs; i++) queue.AddJob(new cCountingJob(&runs[i], NULL));
+    queue.Execute();
+
+    ExpectAllRunOnce(runs);
+  }
+}
+
+
+TEST(AnalyzeJobQueue, JobsAddedByWorkersComplete) {
+  const int num_parents = 50;
+  const int num_children = 20;
+
+  for (int c = 0; c < s_num_worker_counts; c++) {
+    cAnalyzeTestWorld world;
+    cAnalyzeJobQueue queue(&world, s_worker_counts[c], 1);
+
+    int child_runs = 0;
+    tSmartArray<cAnalyzeJob*> jobs(num_parents);
+    for (int i = 0; i < num_parents; i++) jobs[i] = new cSpawningJob(queue, &child_runs, num_children);
+    queue.AddJobs(jobs);
+    queue.Execute();
+
+    EXPECT_EQ(num_parents * num_children, child_runs);
+  }
+}
+
+
+TEST(AnalyzeJobQueue, ReusableAfterExecute) {
+  const int num_jobs = 200;
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue queue(&world, 4, 1);
+
+  for (int round = 0; round < 3; round++) {
+    tArray<int> runs(num_jobs, 0);
+    tSmartArray<cAnalyzeJob*> jobs(num_jobs);
+    for (int i = 0; i < num_jobs; i++) jobs[i] = new cCountingJob(&runs[i], NULL);
+    queue.AddJobs(jobs);
+    queue.Execute();
+
+    ExpectAllRunOnce(runs);
+  }
+}
+
+
+TEST(AnalyzeJobQueue, JobIDsFollowSubmissionOrder) {
+  const int num_jobs = 300;
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue queue(&world, 4, 1);
+
+  // IDs select the RNG from the pool, so they must not depend on which worker runs the job
+  tArray<int> runs(2 * num_jobs, 0);
+  tArray<int> ids(2 * num_jobs, -1);
+  tSmartArray<cAnalyzeJob*> jobs(num_jobs);
+  for (int i = 0; i < num_jobs; i++) jobs[i] = new cCountingJob(&runs[i], &ids[i]);
+  queue.AddJobs(jobs);
+  for (int i = num_jobs; i < 2 * num_jobs; i++) queue.AddJob(new cCountingJob(&runs[i], &ids[i]));
+  queue.Execute();
+
+  for (int i = 0; i < 2 * num_jobs; i++) EXPECT_EQ(i, ids[i]);
+}
+
+
+TEST(AnalyzeJobQueue, RandomPoolFollowsSeed) {
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue queue_a(&world, 1, 7);
+  cAnalyzeJobQueue queue_b(&world, 4, 7);
+  cAnalyzeJobQueue queue_c(&world, 1, 8);
+
+  bool differs = false;
+  for (int id = 0; id < MT_RANDOM_POOL_SIZE; id++) {
+    const int a = queue_a.GetRandom(id)->GetInt(0x7FFFFFFF);
+    EXPECT_EQ(a, queue_b.GetRandom(id)->GetInt(0x7FFFFFFF));
+    if (a != queue_c.GetRandom(id)->GetInt(0x7FFFFFFF)) differs = true;
+  }
+  EXPECT_TRUE(differs);
+}
@@ -0,0 +1,36 @@
+/*
+ *  unittests/analyze/cAnalyzeTestWorld.h
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cAnalyzeTestWorld_h
+#define cAnalyzeTestWorld_h
+
+#include "cWorld.h"
+
+
+// A world with only a default configuration, enough to drive an analyze job queue built with an explicit worker count
+// and seed.  None of the world's managers are set up.
+class cAnalyzeTestWorld : public cWorld
+{
+public:
+  cAnalyzeTestWorld() : cWorld(new cAvidaConfig, "") { m_own_driver = false; }
+};
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ *  unittests/analyze/cGenotypeLoader.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGenotypeLoader.h"
+
+#include "avida/core/Definitions.h"
+#include "avida/core/Genome.h"
+#include "avida/core/Sequence.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cAvidaConfig.h"
+#include "cEnvironment.h"
+#include "cHardwareCPU.h"
+#include "cHardwareManager.h"
+#include "cInitFile.h"
+#include "cInstSet.h"
+#include "cStringList.h"
+#include "cUserFeedback.h"
+#include "cWorld.h"
+#include "tList.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+
+namespace {
+
+  const char* s_data_file = "cGenotypeLoader_test.dat";
+
+  // A world holding the default instruction set the loader builds its genomes from
+  class cGenotypeLoaderTestWorld : public cWorld
+  {
+  public:
+    cGenotypeLoaderTestWorld() : cWorld(new cAvidaConfig, "")
+    {
+      m_own_driver = false;
+      m_env = new cEnvironment(this);
+      m_hw_mgr = new cHardwareManager(this);
+
+      cInstSet* inst_set = new cInstSet(this, "test", HARDWARE_TYPE_CPU_ORIGINAL, cHardwareCPU::GetInstLib());
+      cStringList inst_list;
+      inst_list.PushRear("INST nop-A");
+      inst_list.PushRear("INST nop-B");
+      inst_list.PushRear("INST nop-C");
+      inst_list.PushRear("INST inc");
+      inst_set->LoadWithStringList(inst_list);
+      m_hw_mgr->RegisterInstSet("test", inst_set);
+    }
+  };
+
+  void WriteDataFile(const char* contents)
+  {
+    std::ofstream fp(s_data_file);
+    fp << contents;
+  }
+
+  void ClearList(tList<cAnalyzeGenotype>& list)
+  {
+    while (list.GetSize()) delete list.Pop();
+  }
+
+  // Runs the loader as LOAD does for a file that can be streamed
+  bool StreamFile(cGenotypeLoader& loader, const cStringList& columns, tList<cAnalyzeGenotype>& list)
+  {
+    if (!loader.ReadHeader(s_data_file, ".")) return false;
+    cUserFeedback feedback;
+    if (!loader.SetupColumns(loader.GetFormat(), columns, feedback)) return false;
+    return loader.LoadStream(list);
+  }
+
+};
+
+
+TEST(GenotypeLoader, StreamsDataLines) {
+  cGenotypeLoaderTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 4, 1);
+
+  WriteDataFile("#filetype genotype_data\n"
+                "#format id fitness length sequence\n"
+                "# A comment, then a blank line\n"
+                "\n"
+                "7 0.5 3 abc  # trailing comment\n"
+                "9   1.5 \\\n"
+                "    4 abcd\n"
+                "12 2.25 5 abcda\n");
+
+  cGenotypeLoader loader(&world, jobqueue);
+  ASSERT_TRUE(loader.ReadHeader(s_data_file, "."));
+  EXPECT_EQ(cString("genotype_data"), loader.GetFiletype());
+  ASSERT_EQ(4, loader.GetFormat().GetSize());
+
+  cUserFeedback feedback;
+  ASSERT_TRUE(loader.SetupColumns(loader.GetFormat(), cStringList(), feedback));
+  tList<cAnalyzeGenotype> list;
+  ASSERT_TRUE(loader.LoadStream(list));
+  ASSERT_EQ(3, list.GetSize());
+
+  cAnalyzeGenotype* genotype = list.GetFirst();
+  EXPECT_EQ(7, genotype->GetID());
+  EXPECT_EQ(cString("org-7"), genotype->GetName());
+  EXPECT_DOUBLE_EQ(0.5, genotype->GetFitness());
+  EXPECT_EQ(3, genotype->GetLength());
+  EXPECT_EQ(cString("abc"), genotype->GetSequence());
+
+  // The continued line is joined before it is parsed
+  genotype = list.GetPos(1);
+  EXPECT_EQ(cString("org-9"), genotype->GetName());
+  EXPECT_DOUBLE_EQ(1.5, genotype->GetFitness());
+  EXPECT_EQ(4, genotype->GetLength());
+  EXPECT_EQ(cString("abcd"), genotype->GetSequence());
+
+  genotype = list.GetLast();
+  EXPECT_EQ(12, genotype->GetID());
+  EXPECT_DOUBLE_EQ(2.25, genotype->GetFitness());
+
+  ClearList(list);
+  std::remove(s_data_file);
+}
+
+
+TEST(GenotypeLoader, LoadsOnlyNamedColumns) {
+  cGenotypeLoaderTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 2, 1);
+
+  WriteDataFile("#filetype genotype_data\n"
+                "#format id fitness length sequence\n"
+                "7 0.5 3 abc\n"
+                "9 1.5 4 abcd\n");
+
+  tList<cAnalyzeGenotype> list;
+  cGenotypeLoader loader(&world, jobqueue);
+  ASSERT_TRUE(StreamFile(loader, cStringList("fitness length"), list));
+  ASSERT_EQ(2, list.GetSize());
+
+  // Without the ID column the genotypes are named by their position in the file
+  EXPECT_EQ(cString("org-0"), list.GetFirst()->GetName());
+  EXPECT_EQ(cString("org-1"), list.GetLast()->GetName());
+  EXPECT_DOUBLE_EQ(1.5, list.GetLast()->GetFitness());
+  EXPECT_EQ(4, list.GetLast()->GetLength());
+  EXPECT_NE(cString("abcd"), list.GetLast()->GetSequence());
+
+  ClearList(list);
+  std::remove(s_data_file);
+}
+
+
+TEST(GenotypeLoader, UnknownColumnIsAnError) {
+  cGenotypeLoaderTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 1, 1);
+  cGenotypeLoader loader(&world, jobqueue);
+
+  cUserFeedback feedback;
+  EXPECT_FALSE(loader.SetupColumns(cStringList("id fitnes"), cStringList(), feedback));
+  EXPECT_EQ(1, feedback.GetNumErrors());
+}
+
+
+TEST(GenotypeLoader, FallsBackForInitFileDirectives) {
+  cGenotypeLoaderTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 2, 1);
+
+  // An include ahead of the data is found while reading the header
+  WriteDataFile("#filetype genotype_data\n"
+                "#include other.dat\n"
+                "#format id fitness\n"
+                "1 0.5\n");
+  {
+    cGenotypeLoader loader(&world, jobqueue);
+    EXPECT_FALSE(loader.ReadHeader(s_data_file, "."));
+  }
+
+  // A format change part way through is only found while streaming, and leaves the target list alone
+  WriteDataFile("#filetype genotype_data\n"
+                "#format id fitness\n"
+                "1 0.5\n"
+                "#format fitness id\n"
+                "0.5 2\n");
+  {
+    cGenotypeLoader loader(&world, jobqueue);
+    tList<cAnalyzeGenotype> list;
+    list.PushRear(new cAnalyzeGenotype(&world, Genome(HARDWARE_TYPE_CPU_ORIGINAL, "test", Sequence("abc"))));
+    EXPECT_FALSE(StreamFile(loader, cStringList(), list));
+    EXPECT_EQ(1, list.GetSize());
+    ClearList(list);
+  }
+
+  std::remove(s_data_file);
+}
+
+
+TEST(GenotypeLoader, ChunksKeepFileOrder) {
+  cGenotypeLoaderTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 4, 1);
+
+  // Enough lines for several chunks, each split into many parse jobs
+  const int num_lines = 40000;
+  {
+    std::ofstream fp(s_data_file);
+    fp << "#filetype genotype_data\n#format id fitness\n";
+    for (int i = 0; i < num_lines; i++) fp << i << " " << (0.25 * i) << "\n";
+  }
+
+  tList<cAnalyzeGenotype> streamed;
+  cGenotypeLoader stream_loader(&world, jobqueue);
+  ASSERT_TRUE(StreamFile(stream_loader, cStringList(), streamed));
+  ASSERT_EQ(num_lines, streamed.GetSize());
+
+  // Loading the same file through cInitFile gives the same genotypes
+  cInitFile file(s_data_file, ".");
+  ASSERT_TRUE(file.WasOpened());
+  tList<cAnalyzeGenotype> lines;
+  cGenotypeLoader lines_loader(&world, jobqueue);
+  cUserFeedback feedback;
+  ASSERT_TRUE(lines_loader.SetupColumns(cStringList("id fitness"), cStringList(), feedback));
+  lines_loader.LoadLines(file, lines);
+  ASSERT_EQ(num_lines, lines.GetSize());
+
+  tListIterator<cAnalyzeGenotype> streamed_it(streamed);
+  tListIterator<cAnalyzeGenotype> lines_it(lines);
+  for (int i = 0; i < num_lines; i++) {
+    cAnalyzeGenotype* streamed_genotype = streamed_it.Next();
+    cAnalyzeGenotype* lines_genotype = lines_it.Next();
+    ASSERT_EQ(i, streamed_genotype->GetID());
+    EXPECT_DOUBLE_EQ(0.25 * i, streamed_genotype->GetFitness());
+    EXPECT_EQ(streamed_genotype->GetID(), lines_genotype->GetID());
+    EXPECT_EQ(streamed_genotype->GetName(), lines_genotype->GetName());
+    EXPECT_DOUBLE_EQ(streamed_genotype->GetFitness(), lines_genotype->GetFitness());
+  }
+
+  ClearList(streamed);
+  ClearList(lines);
+  std::remove(s_data_file);
+}
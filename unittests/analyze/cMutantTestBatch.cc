@@ -0,0 +1,171 @@
+/*
+ *  unittests/analyze/cMutantTestBatch.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cMutantTestBatch.h"
+
+#include "avida/core/Definitions.h"
+#include "avida/core/Genome.h"
+#include "avida/core/Sequence.h"
+
+#include "cAnalyzeGenotype.h"
+#include "cAnalyzeJobQueue.h"
+#include "cAvidaConfig.h"
+#include "cAvidaContext.h"
+#include "cCPUTestInfo.h"
+#include "cEnvironment.h"
+#include "cHardwareCPU.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cStringList.h"
+#include "cWorld.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+
+namespace {
+
+  const int s_worker_counts[] = { 1, 4 };
+  const int s_num_worker_counts = 2;
+
+  const char* s_base_seq = "abcdabcdcbadcbaa";
+
+  // A world holding the instruction set the mutants are built from, in which the symbols a-d are instructions 0-3
+  class cMutantTestBatchTestWorld : public cWorld
+  {
+  public:
+    cMutantTestBatchTestWorld() : cWorld(new cAvidaConfig, "")
+    {
+      m_own_driver = false;
+      m_env = new cEnvironment(this);
+      m_hw_mgr = new cHardwareManager(this);
+
+      cInstSet* inst_set = new cInstSet(this, "test", HARDWARE_TYPE_CPU_ORIGINAL, cHardwareCPU::GetInstLib());
+      cStringList inst_list;
+      inst_list.PushRear("INST nop-A");
+      inst_list.PushRear("INST nop-B");
+      inst_list.PushRear("INST nop-C");
+      inst_list.PushRear("INST inc");
+      inst_set->LoadWithStringList(inst_list);
+      m_hw_mgr->RegisterInstSet("test", inst_set);
+    }
+  };
+
+  Genome TestGenome(const std::string& seq) { return Genome(HARDWARE_TYPE_CPU_ORIGINAL, "test", Sequence(seq.c_str())); }
+
+  std::string MutantSequence(int site1, int inst1, int site2 = -1, int inst2 = 0)
+  {
+    std::string seq(s_base_seq);
+    if (site1 >= 0) seq[site1] = static_cast<char>('a' + inst1);
+    if (site2 >= 0) seq[site2] = static_cast<char>('a' + inst2);
+    return seq;
+  }
+
+  // Fitness of the sequence tested on its own, as the serial loops did before mutants were batched
+  double SerialFitness(cWorld& world, cAvidaContext& ctx, const std::string& seq)
+  {
+    cAnalyzeGenotype genotype(&world, TestGenome(seq));
+    cCPUTestInfo test_info;
+    genotype.Recalculate(ctx, &test_info);
+    return genotype.GetFitness();
+  }
+
+};
+
+
+TEST(MutantTestBatch, ResultsFollowAddOrder) {
+  const int num_sites = static_cast<int>(std::string(s_base_seq).size());
+
+  for (int c = 0; c < s_num_worker_counts; c++) {
+    cMutantTestBatchTestWorld world;
+    cAvidaContext ctx(&world, world.GetRandom());
+    cAnalyzeJobQueue jobqueue(&world, s_worker_counts[c], 1);
+
+    cMutantTestBatch batch(&world, jobqueue, TestGenome(s_base_seq));
+    batch.KeepGenotypes();
+
+    // Every single site mutant, then pairs of neighbouring sites, so that ranges mix both kinds
+    tArray<std::string> expected;
+    for (int site = 0; site < num_sites; site++) {
+      for (int inst = 0; inst < 4; inst++) {
+        EXPECT_EQ(expected.GetSize(), batch.AddMutant(site, inst));
+        expected.Push(MutantSequence(site, inst));
+      }
+    }
+    for (int site = 0; site + 1 < num_sites; site++) {
+      const int inst1 = (site + 1) % 4;
+      const int inst2 = (site + 2) % 4;
+      EXPECT_EQ(expected.GetSize(), batch.AddMutant(site, inst1, site + 1, inst2));
+      expected.Push(MutantSequence(site, inst1, site + 1, inst2));
+    }
+    ASSERT_EQ(expected.GetSize(), batch.GetNumMutants());
+
+    batch.Run();
+
+    // Each mutant is built from the base genome, whatever was tested before it in the same range
+    for (int i = 0; i < expected.GetSize(); i++) {
+      EXPECT_EQ(cString(expected[i].c_str()), batch.GetGenotype(i).GetSequence()) << "mutant " << i;
+      EXPECT_DOUBLE_EQ(batch.GetGenotype(i).GetFitness(), batch.GetFitness(i));
+      EXPECT_DOUBLE_EQ(SerialFitness(world, ctx, expected[i]), batch.GetFitness(i)) << "mutant " << i;
+    }
+  }
+}
+
+
+TEST(MutantTestBatch, ReplicatesTestBaseGenome) {
+  cMutantTestBatchTestWorld world;
+  cAvidaContext ctx(&world, world.GetRandom());
+  cAnalyzeJobQueue jobqueue(&world, 4, 1);
+
+  cMutantTestBatch batch(&world, jobqueue, TestGenome(s_base_seq));
+  batch.KeepGenotypes();
+  for (int i = 0; i < 20; i++) batch.AddReplicate();
+  batch.Run();
+
+  const double base_fitness = SerialFitness(world, ctx, s_base_seq);
+  for (int i = 0; i < batch.GetNumMutants(); i++) {
+    EXPECT_EQ(cString(s_base_seq), batch.GetGenotype(i).GetSequence());
+    EXPECT_DOUBLE_EQ(base_fitness, batch.GetFitness(i));
+  }
+}
+
+
+TEST(MutantTestBatch, ClearKeepsBaseGenome) {
+  cMutantTestBatchTestWorld world;
+  cAvidaContext ctx(&world, world.GetRandom());
+  cAnalyzeJobQueue jobqueue(&world, 2, 1);
+
+  cMutantTestBatch batch(&world, jobqueue, TestGenome(s_base_seq));
+  for (int site = 0; site < 10; site++) batch.AddMutant(site, 3);
+  batch.Run();
+  EXPECT_DOUBLE_EQ(SerialFitness(world, ctx, MutantSequence(9, 3)), batch.GetFitness(9));
+
+  batch.Clear();
+  EXPECT_EQ(0, batch.GetNumMutants());
+
+  // Results can be run again after a clear, and kept genotypes are only built when asked for
+  batch.KeepGenotypes();
+  EXPECT_EQ(0, batch.AddMutant(2, 0, 5, 1));
+  batch.Run();
+  EXPECT_EQ(cString(MutantSequence(2, 0, 5, 1).c_str()), batch.GetGenotype(0).GetSequence());
+  EXPECT_DOUBLE_EQ(SerialFitness(world, ctx, MutantSequence(2, 0, 5, 1)), batch.GetFitness(0));
+}
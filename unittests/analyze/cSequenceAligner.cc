@@ -0,0 +1,125 @@
+/*
+ *  unittests/analyze/cSequenceAligner.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cSequenceAligner.h"
+
+#include "avida/core/Sequence.h"
+
+#include "cAnalyzeJobQueue.h"
+#include "cStringUtil.h"
+
+#include "cAnalyzeTestWorld.h"
+
+#include "gtest/gtest.h"
+
+
+namespace {
+  
+  const char* s_lineage[] = { "abcdefgh", "abcxdefgh", "abdefgh", "zabdefghh", "zabdqfghh", "zbdqfgghh" };
+  const int s_lineage_size = 6;
+  
+  const char* s_unrelated[] = { "abcdefgh", "qrstuv", "abcxefgh", "qrsuvw", "abdefgha", "zzabcdefgh", "qrstuvwxyz" };
+  const int s_unrelated_size = 7;
+  
+  // ALIGN as it was before cSequenceAligner: each edit reported by cStringUtil::EditDistance is applied with
+  // cString::Insert, opening gaps in every earlier sequence for each insertion
+  void AlignWithEditDistance(cString* sequences, int num_sequences)
+  {
+    cString diff_info;
+    for (int i = 1; i < num_sequences; i++) {
+      int num_ins = 0;
+      int num_del = 0;
+      cStringUtil::EditDistance(sequences[i], sequences[i - 1], diff_info, '_');
+      while (diff_info.GetSize() != 0) {
+        cString cur_mut = diff_info.Pop(',');
+        const char mut_type = cur_mut[0];
+        cur_mut.ClipFront(1); cur_mut.ClipEnd(1);
+        int position = cur_mut.AsInt();
+        if (mut_type == 'I') {
+          for (int j = 0; j < i; j++) sequences[j].Insert('_', position + num_del);
+          num_ins++;
+        } else if (mut_type == 'D') {
+          sequences[i].Insert("_", position + num_ins);
+          num_del++;
+        }
+      }
+    }
+  }
+  
+  cString StripGaps(const cString& aligned)
+  {
+    cString stripped;
+    for (int i = 0; i < aligned.GetSize(); i++) if (aligned[i] != '_') stripped += aligned[i];
+    return stripped;
+  }
+  
+};
+
+
+TEST(SequenceAligner, LineageMatchesEditDistance) {
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 1, 1);
+  cSequenceAligner aligner(jobqueue);
+  
+  cString expected[s_lineage_size];
+  for (int i = 0; i < s_lineage_size; i++) {
+    aligner.AddSequence(Sequence(s_lineage[i]));
+    expected[i] = s_lineage[i];
+  }
+  AlignWithEditDistance(expected, s_lineage_size);
+  
+  aligner.AlignLineage();
+  for (int i = 0; i < s_lineage_size; i++) EXPECT_EQ(expected[i], aligner.GetAlignedSequence(i));
+}
+
+
+TEST(SequenceAligner, ProgressiveRowsRecoverSequences) {
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 4, 1);
+  cSequenceAligner aligner(jobqueue);
+  
+  for (int i = 0; i < s_unrelated_size; i++) aligner.AddSequence(Sequence(s_unrelated[i]));
+  aligner.AlignProgressive();
+  
+  const int num_cols = aligner.GetAlignedSequence(0).GetSize();
+  for (int i = 0; i < s_unrelated_size; i++) {
+    const cString aligned = aligner.GetAlignedSequence(i);
+    EXPECT_EQ(num_cols, aligned.GetSize());
+    EXPECT_EQ(cString(s_unrelated[i]), StripGaps(aligned));
+  }
+}
+
+
+TEST(SequenceAligner, EmptySequenceIsAllGaps) {
+  cAnalyzeTestWorld world;
+  cAnalyzeJobQueue jobqueue(&world, 1, 1);
+  cSequenceAligner aligner(jobqueue);
+  
+  aligner.AddSequence(Sequence("abcd"));
+  aligner.AddSequence(Sequence(""));
+  aligner.AddSequence(Sequence("abd"));
+  aligner.AlignLineage();
+  
+  EXPECT_EQ(cString("abcd"), aligner.GetAlignedSequence(0));
+  EXPECT_EQ(cString("____"), aligner.GetAlignedSequence(1));
+  EXPECT_EQ(cString("abd"), StripGaps(aligner.GetAlignedSequence(2)));
+  EXPECT_EQ(4, aligner.GetAlignedSequence(2).GetSize());
+}
@@ -24,5 +24,291 @@
 
 #include "avida/core/Sequence.h"
 
+#include "cRandom.h"
+
 #include "gtest/gtest.h"
 
+#include <string>
+
+using namespace Avida;
+
+
+namespace {
+  
+  // Reference model for the bulk site moves: the sequence as a plain string, one symbol per site
+  std::string AsModel(const Sequence& seq) { return std::string(static_cast<const char*>(seq.AsString())); }
+  
+  char RandomSymbol(cRandom& rng) { return static_cast<char>('a' + rng.GetUInt(26)); }
+  
+  std::string RandomSymbols(cRandom& rng, int length)
+  {
+    std::string symbols;
+    for (int i = 0; i < length; i++) symbols += RandomSymbol(rng);
+    return symbols;
+  }
+  
+};
+
+
+TEST(Sequence, InsertAndRemoveSites) {
+  Sequence seq("abcdef");
+  
+  seq.Insert(3, Sequence("xyz"));
+  EXPECT_EQ("abcxyzdef", AsModel(seq));
+  seq.Insert(0, Sequence("pq"));
+  EXPECT_EQ("pqabcxyzdef", AsModel(seq));
+  seq.Append(Sequence("r"));
+  EXPECT_EQ("pqabcxyzdefr", AsModel(seq));
+  
+  cInstruction inst;
+  inst.SetSymbol('m');
+  seq.Insert(5, inst);
+  EXPECT_EQ("pqabcmxyzdefr", AsModel(seq));
+  
+  seq.Remove(0, 2);
+  EXPECT_EQ("abcmxyzdefr", AsModel(seq));
+  seq.Remove(3, 4);
+  EXPECT_EQ("abcdefr", AsModel(seq));
+  seq.Remove(6);
+  EXPECT_EQ("abcdef", AsModel(seq));
+}
+
+
+TEST(Sequence, ReplaceSites) {
+  Sequence seq("abcdef");
+  
+  seq.Replace(1, 2, Sequence("wxyz"));
+  EXPECT_EQ("awxyzdef", AsModel(seq));
+  seq.Replace(1, 4, Sequence("q"));
+  EXPECT_EQ("aqdef", AsModel(seq));
+  seq.Replace(2, 2, Sequence("mn"));
+  EXPECT_EQ("aqmnf", AsModel(seq));
+  
+  // Circular replacement of [3, 1) writes the tail first, then the front
+  seq.Replace(Sequence("uvw"), 3, 1);
+  EXPECT_EQ("wqmuv", AsModel(seq));
+}
+
+
+TEST(Sequence, ResizeClearsNewSites) {
+  Sequence seq("abcdef");
+  
+  seq.Resize(3);
+  EXPECT_EQ("abc", AsModel(seq));
+  
+  // Sites exposed again by growing must not show the old contents
+  seq.Resize(6);
+  EXPECT_EQ("abcaaa", AsModel(seq));
+  for (int i = 3; i < 6; i++) EXPECT_EQ(0, seq[i].GetOp());
+}
+
+
+TEST(Sequence, CropCutJoin) {
+  const Sequence seq("abcdefgh");
+  
+  EXPECT_EQ("cde", AsModel(seq.Crop(2, 5)));
+  EXPECT_EQ("abfgh", AsModel(seq.Cut(2, 5)));
+  EXPECT_EQ("defgh", AsModel(seq.Cut(0, 3)));
+  EXPECT_EQ("abcde", AsModel(seq.Cut(5, 8)));
+  EXPECT_EQ("abcdefghxy", AsModel(Sequence::Join(seq, Sequence("xy"))));
+  EXPECT_EQ("xyabcdefgh", AsModel(Sequence("xy") + seq));
+}
+
+
+TEST(Sequence, RotateMovesTailToFront) {
+  Sequence seq("abcdef");
+  
+  seq.Rotate(2);
+  EXPECT_EQ("efabcd", AsModel(seq));
+  seq.Rotate(5);
+  EXPECT_EQ("fabcde", AsModel(seq));
+  seq.Rotate(0);
+  EXPECT_EQ("fabcde", AsModel(seq));
+}
+
+
+TEST(Sequence, CopyAndAssign) {
+  const Sequence long_seq("abcdefghijklmnop");
+  const Sequence short_seq("xyz");
+  
+  Sequence seq(long_seq);
+  EXPECT_EQ(AsModel(long_seq), AsModel(seq));
+  
+  // Assignment reuses the existing storage, which must not leak the longer contents
+  seq = short_seq;
+  EXPECT_EQ("xyz", AsModel(seq));
+  seq.Resize(5);
+  EXPECT_EQ("xyzaa", AsModel(seq));
+  
+  seq = long_seq;
+  EXPECT_TRUE(seq == long_seq);
+  
+  seq = Sequence();
+  EXPECT_EQ(0, seq.GetSize());
+  seq = short_seq;
+  EXPECT_EQ("xyz", AsModel(seq));
+}
+
+
+TEST(Sequence, RandomEditsMatchModel) {
+  cRandom rng(1);
+  Sequence seq("abcdefghij");
+  std::string model("abcdefghij");
+  
+  for (int step = 0; step < 5000; step++) {
+    const int size = static_cast<int>(model.size());
+    switch (rng.GetUInt(6)) {
+      case 0: {
+        const int pos = rng.GetUInt(size + 1);
+        cInstruction inst;
+        inst.SetSymbol(RandomSymbol(rng));
+        seq.Insert(pos, inst);
+        model.insert(pos, 1, inst.GetSymbol());
+        break;
+      }
+      case 1: {
+        const int pos = rng.GetUInt(size + 1);
+        const std::string symbols = RandomSymbols(rng, 1 + rng.GetUInt(40));
+        seq.Insert(pos, Sequence(symbols.c_str()));
+        model.insert(pos, symbols);
+        break;
+      }
+      case 2: {
+        if (size < 2) break;
+        const int pos = rng.GetUInt(size);
+        const int num_sites = 1 + rng.GetUInt((size - pos < size - 1) ? size - pos : size - 1);
+        seq.Remove(pos, num_sites);
+        model.erase(pos, num_sites);
+        break;
+      }
+      case 3: {
+        const int pos = rng.GetUInt(size);
+        const int num_sites = rng.GetUInt(size - pos + 1);
+        const std::string symbols = RandomSymbols(rng, rng.GetUInt(40));
+        if (num_sites == size && symbols.empty()) break;
+        seq.Replace(pos, num_sites, Sequence(symbols.c_str()));
+        model.replace(pos, num_sites, symbols);
+        break;
+      }
+      case 4: {
+        if (size < 2) break;
+        const int n = rng.GetUInt(size);
+        seq.Rotate(n);
+        model = model.substr(size - n) + model.substr(0, size - n);
+        break;
+      }
+      case 5: {
+        const int new_size = 1 + rng.GetUInt(2 * size);
+        seq.Resize(new_size);
+        if (new_size < size) model.erase(new_size);
+        else model.append(new_size - size, 'a');
+        break;
+      }
+    }
+    
+    ASSERT_EQ(model, AsModel(seq)) << "after step " << step;
+    
+    // Keep the sequence to a size where edits still shift sites both ways
+    if (model.size() > 300) {
+      seq.Resize(100);
+      model.erase(100);
+    }
+  }
+}
+
+
+namespace {
+  
+  // Site by site versions of the comparisons, as Sequence computed them before comparing bytes in bulk
+  int CountInstLoop(const Sequence& seq, const cInstruction& inst)
+  {
+    int count = 0;
+    for (int i = 0; i < seq.GetSize(); i++) if (seq[i] == inst) count++;
+    return count;
+  }
+  
+  int HammingDistanceLoop(const Sequence& seq1, const Sequence& seq2, int offset)
+  {
+    const int start1 = (offset < 0) ? 0 : offset;
+    const int start2 = (offset > 0) ? 0 : -offset;
+    const int overlap = Sequence::FindOverlap(seq1, seq2, offset);
+    int distance = seq1.GetSize() + seq2.GetSize() - 2 * overlap;
+    for (int i = 0; i < overlap; i++) if (seq1[start1 + i] != seq2[start2 + i]) distance++;
+    return distance;
+  }
+  
+};
+
+
+TEST(Sequence, EqualityComparesEverySite) {
+  const std::string base(70, 'c');
+  const Sequence seq(base.c_str());
+  
+  EXPECT_TRUE(seq == Sequence(base.c_str()));
+  EXPECT_TRUE(Sequence() == Sequence());
+  EXPECT_FALSE(seq == Sequence(base.substr(1).c_str()));
+  
+  // A difference at any position, including the tail past the last full block of sixteen, is seen
+  for (int i = 0; i < static_cast<int>(base.size()); i++) {
+    std::string changed(base);
+    changed[i] = 'd';
+    EXPECT_TRUE(seq != Sequence(changed.c_str())) << "position " << i;
+  }
+}
+
+
+TEST(Sequence, FindInstFromStart) {
+  const Sequence seq("abcabcxabc");
+  cInstruction inst;
+  
+  inst.SetSymbol('c');
+  EXPECT_EQ(2, seq.FindInst(inst));
+  EXPECT_EQ(2, seq.FindInst(inst, 2));
+  EXPECT_EQ(5, seq.FindInst(inst, 3));
+  EXPECT_EQ(9, seq.FindInst(inst, 6));
+  
+  inst.SetSymbol('x');
+  EXPECT_EQ(6, seq.FindInst(inst));
+  EXPECT_EQ(-1, seq.FindInst(inst, 7));
+  EXPECT_TRUE(seq.HasInst(inst));
+  
+  inst.SetSymbol('z');
+  EXPECT_EQ(-1, seq.FindInst(inst));
+  EXPECT_FALSE(seq.HasInst(inst));
+}
+
+
+TEST(Sequence, BulkCountsMatchSiteLoops) {
+  cRandom rng(7);
+  
+  // Lengths around multiples of sixteen exercise both the block and tail paths
+  for (int length = 1; length <= 100; length++) {
+    std::string symbols;
+    for (int i = 0; i < length; i++) symbols += static_cast<char>('a' + rng.GetUInt(4));
+    const Sequence seq1(symbols.c_str());
+    for (int i = 0; i < length; i++) if (rng.GetUInt(3) == 0) symbols[i] = static_cast<char>('a' + rng.GetUInt(4));
+    symbols += "bcd";
+    const Sequence seq2(symbols.c_str());
+    
+    for (char symbol = 'a'; symbol <= 'e'; symbol++) {
+      cInstruction inst;
+      inst.SetSymbol(symbol);
+      EXPECT_EQ(CountInstLoop(seq1, inst), seq1.CountInst(inst)) << "length " << length;
+    }
+    
+    for (int offset = 1 - seq2.GetSize(); offset < seq1.GetSize(); offset++) {
+      EXPECT_EQ(HammingDistanceLoop(seq1, seq2, offset), Sequence::FindHammingDistance(seq1, seq2, offset))
+        << "length " << length << " offset " << offset;
+    }
+  }
+}
+
+
+TEST(Sequence, SlidingDistanceFindsShift) {
+  const Sequence seq1("qqabcdefghijklmnopqrstuvwxyz");
+  const Sequence seq2("abcdefghijklmnopqrstuvwxyz");
+  
+  EXPECT_EQ(2, Sequence::FindBestOffset(seq1, seq2));
+  EXPECT_EQ(2, Sequence::FindSlidingDistance(seq1, seq2));
+  EXPECT_EQ(-2, Sequence::FindBestOffset(seq2, seq1));
+}
@@ -0,0 +1,306 @@
+/*
+ *  unittests/cpu/cLabelIndex.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cLabelIndex.h"
+
+#include "avida/core/Definitions.h"
+#include "avida/core/Sequence.h"
+
+#include "cAvidaConfig.h"
+#include "cCPUMemory.h"
+#include "cCodeLabel.h"
+#include "cEnvironment.h"
+#include "cHardwareCPU.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cInstruction.h"
+#include "cRandom.h"
+#include "cStringList.h"
+#include "cWorld.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace Avida;
+
+
+namespace {
+
+  // A world holding one small instruction set, in which the symbols a, b and c are nop-A, nop-B and nop-C
+  class cLabelIndexTestWorld : public cWorld
+  {
+  public:
+    cLabelIndexTestWorld() : cWorld(new cAvidaConfig, "")
+    {
+      m_own_driver = false;
+      m_env = new cEnvironment(this);
+      m_hw_mgr = new cHardwareManager(this);
+
+      cInstSet* inst_set = new cInstSet(this, "test", HARDWARE_TYPE_CPU_ORIGINAL, cHardwareCPU::GetInstLib());
+      cStringList inst_list;
+      inst_list.PushRear("INST nop-A");
+      inst_list.PushRear("INST nop-B");
+      inst_list.PushRear("INST nop-C");
+      inst_list.PushRear("INST inc");
+      inst_list.PushRear("INST dec");
+      inst_set->LoadWithStringList(inst_list);
+      m_hw_mgr->RegisterInstSet("test", inst_set);
+    }
+
+    const cInstSet& GetInstSet() { return m_hw_mgr->GetInstSet("test"); }
+  };
+
+
+  // The scans the index stands in for, as written in cHardwareCPU::FindLabel_Forward, FindLabel_Backward and
+  // cHardwareBase::FindLabelFull
+  int ScanForward(const cInstSet& inst_set, const cCodeLabel& label, const Sequence& memory, int pos)
+  {
+    const int search_start = pos;
+    const int label_size = label.GetSize();
+
+    for (pos += label_size; pos < memory.GetSize(); pos += label_size) {
+      if (!inst_set.IsNop(memory[pos])) continue;
+
+      int start_pos = pos;
+      int end_pos = pos + 1;
+      while (start_pos > search_start && inst_set.IsNop(memory[start_pos - 1])) start_pos--;
+      while (end_pos < memory.GetSize() && inst_set.IsNop(memory[end_pos])) end_pos++;
+
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches = 0;
+        while (matches < label_size && label[matches] == inst_set.GetNopMod(memory[offset + matches])) matches++;
+        if (matches == label_size) return offset + label_size;
+      }
+      pos = end_pos;
+    }
+    return -1;
+  }
+
+  int ScanBackward(const cInstSet& inst_set, const cCodeLabel& label, const Sequence& memory, int pos)
+  {
+    const int search_start = pos;
+    const int label_size = label.GetSize();
+
+    for (pos -= label_size; pos >= 0; pos -= label_size) {
+      if (!inst_set.IsNop(memory[pos])) continue;
+
+      int start_pos = pos;
+      int end_pos = pos + 1;
+      while (start_pos > 0 && inst_set.IsNop(memory[start_pos - 1])) start_pos--;
+      while (end_pos < search_start && inst_set.IsNop(memory[end_pos])) end_pos++;
+
+      for (int offset = start_pos; offset <= end_pos - label_size; offset++) {
+        int matches = 0;
+        while (matches < label_size && label[matches] == inst_set.GetNopMod(memory[offset + matches])) matches++;
+        if (matches == label_size) return end_pos;
+      }
+      pos = start_pos - 1;
+    }
+    return -1;
+  }
+
+  int ScanFull(const cInstSet& inst_set, const cCodeLabel& label, const Sequence& memory)
+  {
+    int pos = 0;
+    while (pos < memory.GetSize()) {
+      if (!inst_set.IsNop(memory[pos])) {
+        pos += label.GetSize();
+        continue;
+      }
+      while (pos > 0 && inst_set.IsNop(memory[pos - 1])) pos--;
+
+      int size = 0;
+      bool label_match = true;
+      do {
+        if (size < label.GetSize() && label[size] != inst_set.GetNopMod(memory[pos])) label_match = false;
+        pos++;
+        size++;
+      } while (pos < memory.GetSize() && inst_set.IsNop(memory[pos]));
+
+      if (size == label.GetSize() && label_match) return pos;
+    }
+    return -1;
+  }
+
+
+  // Mostly nops, so that labels run together and partial matches are common
+  cInstruction RandomInst(cRandom& rng)
+  {
+    cInstruction inst;
+    inst.SetOp(rng.GetUInt(4) ? rng.GetUInt(3) : 3 + rng.GetUInt(2));
+    return inst;
+  }
+
+  cCodeLabel RandomLabel(cRandom& rng)
+  {
+    cCodeLabel label;
+    const int size = 1 + rng.GetUInt(3);
+    for (int i = 0; i < size; i++) label.AddNop(rng.GetUInt(3));
+    return label;
+  }
+
+  cCodeLabel MakeLabel(const char* nops)
+  {
+    cCodeLabel label;
+    for (int i = 0; nops[i]; i++) label.AddNop(nops[i] - 'a');
+    return label;
+  }
+
+  // Checks every query the index can answer against the scans, from every starting position
+  void ExpectMatchesScans(cLabelIndex& index, const cInstSet& inst_set, const cCPUMemory& memory, const cCodeLabel& label)
+  {
+    int pos = -2;
+    ASSERT_TRUE(index.FindFull(inst_set, label, pos));
+    EXPECT_EQ(ScanFull(inst_set, label, memory), pos) << "label size " << label.GetSize();
+
+    for (int start = 0; start < memory.GetSize(); start++) {
+      ASSERT_TRUE(index.FindForward(inst_set, label, start, pos));
+      EXPECT_EQ(ScanForward(inst_set, label, memory, start), pos) << "forward from " << start;
+      ASSERT_TRUE(index.FindBackward(inst_set, label, start, pos));
+      EXPECT_EQ(ScanBackward(inst_set, label, memory, start), pos) << "backward from " << start;
+    }
+  }
+
+};
+
+
+TEST(LabelIndex, DefersFirstQueryAfterStructuralChange) {
+  cLabelIndexTestWorld world;
+  const cInstSet& inst_set = world.GetInstSet();
+  cCPUMemory memory(Sequence("dabcdcbad"));
+  cLabelIndex index(memory);
+  const cCodeLabel label = MakeLabel("bc");
+
+  int pos = -2;
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  EXPECT_EQ(-2, pos);
+  EXPECT_TRUE(index.FindForward(inst_set, label, 0, pos));
+  EXPECT_EQ(4, pos);
+
+  memory.Insert(0, Sequence("d"));
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  EXPECT_TRUE(index.FindForward(inst_set, label, 0, pos));
+  EXPECT_EQ(5, pos);
+}
+
+
+TEST(LabelIndex, FullLabelMustMatchExactly) {
+  cLabelIndexTestWorld world;
+  const cInstSet& inst_set = world.GetInstSet();
+  cCPUMemory memory(Sequence("dabcdabdab"));
+  cLabelIndex index(memory);
+
+  int pos = -2;
+  EXPECT_FALSE(index.FindFull(inst_set, MakeLabel("ab"), pos));
+
+  // "ab" inside "abc" is skipped in favour of the label that is exactly "ab"
+  EXPECT_TRUE(index.FindFull(inst_set, MakeLabel("ab"), pos));
+  EXPECT_EQ(7, pos);
+  EXPECT_TRUE(index.FindFull(inst_set, MakeLabel("abc"), pos));
+  EXPECT_EQ(4, pos);
+  EXPECT_TRUE(index.FindFull(inst_set, MakeLabel("c"), pos));
+  EXPECT_EQ(-1, pos);
+}
+
+
+TEST(LabelIndex, MatchesScansOnRandomMemories) {
+  cLabelIndexTestWorld world;
+  const cInstSet& inst_set = world.GetInstSet();
+  cRandom rng(11);
+
+  for (int trial = 0; trial < 100; trial++) {
+    cCPUMemory memory(1 + rng.GetUInt(60));
+    for (int i = 0; i < memory.GetSize(); i++) memory.SetInst(i, RandomInst(rng));
+    cLabelIndex index(memory);
+
+    int pos;
+    const cCodeLabel first = RandomLabel(rng);
+    EXPECT_FALSE(index.FindForward(inst_set, first, 0, pos));
+    ExpectMatchesScans(index, inst_set, memory, first);
+
+    // More labels than the index holds, so that entries are evicted and rebuilt
+    for (int i = 0; i < 12; i++) ExpectMatchesScans(index, inst_set, memory, RandomLabel(rng));
+  }
+}
+
+
+TEST(LabelIndex, PatchesSingleSiteWrites) {
+  cLabelIndexTestWorld world;
+  const cInstSet& inst_set = world.GetInstSet();
+  cRandom rng(23);
+
+  cCPUMemory memory(80);
+  for (int i = 0; i < memory.GetSize(); i++) memory.SetInst(i, RandomInst(rng));
+  cLabelIndex index(memory);
+
+  tArray<cCodeLabel> labels(6);
+  for (int i = 0; i < labels.GetSize(); i++) labels[i] = RandomLabel(rng);
+
+  int pos;
+  EXPECT_FALSE(index.FindFull(inst_set, labels[0], pos));
+  for (int i = 0; i < labels.GetSize(); i++) ExpectMatchesScans(index, inst_set, memory, labels[i]);
+
+  for (int round = 0; round < 200; round++) {
+    // A few writes are patched into the cached labels; too many for the write log drop them
+    const int num_writes = (round % 10 == 9) ? 40 : 1 + rng.GetUInt(5);
+    for (int i = 0; i < num_writes; i++) {
+      memory.SetInst(rng.GetUInt(memory.GetSize()), RandomInst(rng));
+      if (rng.GetUInt(4) == 0) memory.Copy(rng.GetUInt(memory.GetSize()), rng.GetUInt(memory.GetSize()));
+    }
+
+    const cCodeLabel& label = labels[rng.GetUInt(labels.GetSize())];
+    if (num_writes > 32) EXPECT_FALSE(index.FindFull(inst_set, label, pos));
+    ExpectMatchesScans(index, inst_set, memory, label);
+  }
+}
+
+
+TEST(LabelIndex, StructuralChangesDropLabels) {
+  cLabelIndexTestWorld world;
+  const cInstSet& inst_set = world.GetInstSet();
+  cRandom rng(5);
+
+  cCPUMemory memory(50);
+  for (int i = 0; i < memory.GetSize(); i++) memory.SetInst(i, RandomInst(rng));
+  cLabelIndex index(memory);
+  const cCodeLabel label = MakeLabel("ab");
+
+  int pos;
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  ExpectMatchesScans(index, inst_set, memory, label);
+
+  memory.Insert(10, Sequence("ab"));
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  ExpectMatchesScans(index, inst_set, memory, label);
+
+  memory.Remove(3, 4);
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  ExpectMatchesScans(index, inst_set, memory, label);
+
+  memory.Rotate(7);
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  ExpectMatchesScans(index, inst_set, memory, label);
+
+  memory = Sequence("dabdabcabd");
+  EXPECT_FALSE(index.FindForward(inst_set, label, 0, pos));
+  ExpectMatchesScans(index, inst_set, memory, label);
+}
@@ -0,0 +1,213 @@
+/*
+ *  unittests/cpu/cTestCPUCache.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cTestCPUCache.h"
+
+#include "avida/core/Definitions.h"
+#include "avida/core/Genome.h"
+#include "avida/core/Sequence.h"
+
+#include "cAvidaConfig.h"
+#include "cCPUTestInfo.h"
+#include "cEnvironment.h"
+#include "cHardwareCPU.h"
+#include "cHardwareManager.h"
+#include "cInstSet.h"
+#include "cStringList.h"
+#include "cWorld.h"
+
+#include "gtest/gtest.h"
+
+
+namespace {
+
+  // A world holding only an environment and a hardware manager with one small instruction set, which is all the cache
+  // consults.  The caches under test are built directly, so their capacity does not depend on the configuration.
+  class cTestCPUCacheTestWorld : public cWorld
+  {
+  public:
+    cTestCPUCacheTestWorld() : cWorld(new cAvidaConfig, "")
+    {
+      m_own_driver = false;
+      m_env = new cEnvironment(this);
+      m_hw_mgr = new cHardwareManager(this);
+
+      cInstSet* inst_set = new cInstSet(this, "test", HARDWARE_TYPE_CPU_ORIGINAL, cHardwareCPU::GetInstLib());
+      cStringList inst_list;
+      inst_list.PushRear("INST nop-A");
+      inst_list.PushRear("INST nop-B");
+      inst_list.PushRear("INST nop-C");
+      inst_list.PushRear("INST inc");
+      inst_set->LoadWithStringList(inst_list);
+      m_hw_mgr->RegisterInstSet("test", inst_set);
+    }
+  };
+
+  Genome TestGenome(const char* seq) { return Genome(HARDWARE_TYPE_CPU_ORIGINAL, "test", Sequence(seq)); }
+
+  // Looks the genome up with a fresh test info carrying the given settings, as cTestCPU does for each test
+  bool CacheHas(cTestCPUCache& cache, const Genome& genome, const cCPUTestInfo& settings)
+  {
+    cCPUTestInfo test_info;
+    test_info.CopySettings(settings);
+    return cache.Lookup(genome, test_info);
+  }
+
+  void InsertWith(cTestCPUCache& cache, const Genome& genome, const cCPUTestInfo& settings)
+  {
+    cCPUTestInfo test_info;
+    test_info.CopySettings(settings);
+    cache.Insert(genome, test_info);
+  }
+
+};
+
+
+TEST(TestCPUCache, MissThenHit) {
+  cTestCPUCacheTestWorld world;
+  cTestCPUCache cache(&world, 4);
+  const Genome genome = TestGenome("abcdabcd");
+
+  cCPUTestInfo test_info;
+  ASSERT_TRUE(cache.IsCacheable(genome, test_info));
+  EXPECT_FALSE(cache.Lookup(genome, test_info));
+  EXPECT_FALSE(test_info.WasCached());
+
+  cache.Insert(genome, test_info);
+  EXPECT_TRUE(test_info.WasCached());
+  EXPECT_EQ(1, cache.GetSize());
+
+  cCPUTestInfo hit_info;
+  EXPECT_TRUE(cache.Lookup(genome, hit_info));
+  EXPECT_TRUE(hit_info.WasCached());
+  EXPECT_EQ(test_info.IsViable(), hit_info.IsViable());
+  EXPECT_EQ(test_info.GetMaxDepth(), hit_info.GetMaxDepth());
+
+  EXPECT_EQ(1, cache.GetNumHits());
+  EXPECT_EQ(1, cache.GetNumMisses());
+  EXPECT_FALSE(CacheHas(cache, TestGenome("abcdabcc"), cCPUTestInfo()));
+}
+
+
+TEST(TestCPUCache, EvictsLeastRecentlyUsed) {
+  cTestCPUCacheTestWorld world;
+  cTestCPUCache cache(&world, 2);
+  const cCPUTestInfo settings;
+  const Genome genome_a = TestGenome("aaaa");
+  const Genome genome_b = TestGenome("bbbb");
+  const Genome genome_c = TestGenome("cccc");
+
+  InsertWith(cache, genome_a, settings);
+  InsertWith(cache, genome_b, settings);
+  EXPECT_TRUE(CacheHas(cache, genome_a, settings));  // a is now the most recently used
+
+  InsertWith(cache, genome_c, settings);
+  EXPECT_EQ(2, cache.GetSize());
+  EXPECT_EQ(1, cache.GetNumEvictions());
+  EXPECT_FALSE(CacheHas(cache, genome_b, settings));
+  EXPECT_TRUE(CacheHas(cache, genome_a, settings));
+  EXPECT_TRUE(CacheHas(cache, genome_c, settings));
+}
+
+
+TEST(TestCPUCache, SettingsSelectEntries) {
+  cTestCPUCacheTestWorld world;
+  cTestCPUCache cache(&world, 8);
+  const Genome genome = TestGenome("abcdabcd");
+
+  const cCPUTestInfo plain;
+  InsertWith(cache, genome, plain);
+
+  cCPUTestInfo resources;
+  resources.SetResourceOptions(RES_CONSTANT, NULL, 10);
+  EXPECT_FALSE(CacheHas(cache, genome, resources));
+
+  cCPUTestInfo state_grid;
+  state_grid.SetCurrentStateGridID(1);
+  EXPECT_FALSE(CacheHas(cache, genome, state_grid));
+
+  tArray<int> inputs(3);
+  inputs[0] = 1; inputs[1] = 2; inputs[2] = 3;
+  cCPUTestInfo manual;
+  manual.UseManualInputs(inputs);
+  EXPECT_FALSE(CacheHas(cache, genome, manual));
+  InsertWith(cache, genome, manual);
+  EXPECT_TRUE(CacheHas(cache, genome, manual));
+
+  inputs[2] = 4;
+  cCPUTestInfo other_manual;
+  other_manual.UseManualInputs(inputs);
+  EXPECT_FALSE(CacheHas(cache, genome, other_manual));
+
+  EXPECT_TRUE(CacheHas(cache, genome, plain));
+  EXPECT_EQ(2, cache.GetSize());
+}
+
+
+TEST(TestCPUCache, BypassesNondeterministicTests) {
+  cTestCPUCacheTestWorld world;
+  cTestCPUCache cache(&world, 4);
+  const Genome genome = TestGenome("abcdabcd");
+
+  cCPUTestInfo random_inputs;
+  random_inputs.UseRandomInputs();
+  EXPECT_FALSE(cache.IsCacheable(genome, random_inputs));
+  random_inputs.CacheRandomInputs();
+  EXPECT_TRUE(cache.IsCacheable(genome, random_inputs));
+
+  cCPUTestInfo mutations;
+  mutations.MutationRates().SetCopyMutProb(0.01);
+  EXPECT_FALSE(cache.IsCacheable(genome, mutations));
+
+  cTestCPUCache disabled(&world, 0);
+  EXPECT_FALSE(disabled.IsEnabled());
+  EXPECT_FALSE(disabled.IsCacheable(genome, cCPUTestInfo()));
+}
+
+
+TEST(TestCPUCache, ResultsOutliveTheCache) {
+  cTestCPUCacheTestWorld world;
+  const Genome genome = TestGenome("abcdabcd");
+
+  cCPUTestInfo inserted;
+  cCPUTestInfo copied;
+  {
+    cTestCPUCache cache(&world, 1);
+    cache.Insert(genome, inserted);
+
+    // Evicting the entry leaves it alive for the test infos still holding its results
+    InsertWith(cache, TestGenome("dcbadcba"), cCPUTestInfo());
+    EXPECT_EQ(1, cache.GetNumEvictions());
+    EXPECT_FALSE(CacheHas(cache, genome, cCPUTestInfo()));
+
+    copied = inserted;
+    cache.Clear();
+    EXPECT_EQ(0, cache.GetSize());
+  }
+
+  EXPECT_TRUE(inserted.WasCached());
+  EXPECT_TRUE(copied.WasCached());
+
+  // Clearing a test info drops only its own reference
+  inserted.Clear();
+  EXPECT_FALSE(inserted.WasCached());
+  EXPECT_TRUE(copied.WasCached());
+}